@@ -0,0 +1,556 @@
+// Google Benchmark microbenchmark suite for the parsing paths.
+//
+// Every benchmark is parameterised by file size (records) and, where the
+// path parallelises, thread count. "Cold" variants evict the file from the
+// page cache (load) or flush the CPU caches (in-memory paths) before each
+// iteration. Use --benchmark_out=run.json --benchmark_out_format=json and
+// compare builds with Google Benchmark's tools/compare.py.
+
+#include <benchmark/benchmark.h>
+#include <databento/aggregate.hpp>
+#include <databento/asof.hpp>
+#include <databento/async_stream.hpp>
+#include <databento/buffer_pool.hpp>
+#include <databento/export.hpp>
+#include <databento/flat_hash_map.hpp>
+#include <databento/generator.hpp>
+#include <databento/parallel.hpp>
+#include <databento/parser.hpp>
+#include <databento/projection.hpp>
+#include <databento/query.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+
+using databento::MboMsg;
+
+constexpr uint32_t FILTER_INSTRUMENT = 1003;
+constexpr int64_t FILTER_MIN_PRICE = 259'000'000'000LL;  // Near instrument 1003's mid
+
+// ============================================================================
+// Fixture Data
+// ============================================================================
+
+// Synthetic DBN file removed at exit; generated once per size with a
+// fixed seed so every build measures identical data
+class BenchFile {
+public:
+  explicit BenchFile(size_t records) {
+    const char* dir = std::getenv("DATABENTO_BENCH_DIR");
+    path_ = std::string(dir ? dir : "/tmp") + "/databento_bench_" + std::to_string(records) +
+            "_" + std::to_string(::getpid()) + ".dbn";
+
+    databento::GeneratorOptions options;
+    options.num_records = records;
+    options.first_instrument_id = 1000;
+    databento::write_synthetic_dbn(path_, options);
+  }
+
+  ~BenchFile() { std::remove(path_.c_str()); }
+
+  const std::string& path() const { return path_; }
+
+private:
+  std::string path_;
+};
+
+const std::string& bench_file(size_t records) {
+  static std::map<size_t, std::unique_ptr<BenchFile>> files;
+  auto& file = files[records];
+  if (!file) {
+    file = std::make_unique<BenchFile>(records);
+  }
+  return file->path();
+}
+
+// Loaded parser shared by the in-memory benchmarks of one size
+databento::DbnParser& loaded_parser(size_t records) {
+  static std::map<size_t, std::unique_ptr<databento::DbnParser>> parsers;
+  auto& parser = parsers[records];
+  if (!parser) {
+    parser = std::make_unique<databento::DbnParser>(bench_file(records));
+    parser->load_into_memory();
+  }
+  return *parser;
+}
+
+void evict_page_cache(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+}
+
+// Stream through a buffer twice the size of the largest reported cache
+void flush_cpu_caches() {
+  static std::vector<uint8_t> scratch = [] {
+    size_t largest = size_t{32} << 20;
+    for (const auto& cache : benchmark::CPUInfo::Get().caches) {
+      largest = std::max(largest, static_cast<size_t>(cache.size) * cache.num_sharing);
+    }
+    return std::vector<uint8_t>(2 * largest);
+  }();
+  for (size_t i = 0; i < scratch.size(); i += 64) {
+    scratch[i]++;
+  }
+  benchmark::ClobberMemory();
+}
+
+enum Cache : int64_t { Warm = 0, Cold = 1 };
+
+// Start-of-iteration hook for the cold variants
+void prepare_iteration(benchmark::State& state, Cache cache) {
+  if (cache == Cold) {
+    state.PauseTiming();
+    flush_cpu_caches();
+    state.ResumeTiming();
+  }
+}
+
+void set_throughput(benchmark::State& state, size_t records) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * records * sizeof(MboMsg)));
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+// Args: records, cache
+void BM_Load(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto cache = static_cast<Cache>(state.range(1));
+  const std::string& path = bench_file(records);
+
+  for (auto _ : state) {
+    if (cache == Cold) {
+      state.PauseTiming();
+      evict_page_cache(path);
+      state.ResumeTiming();
+    }
+    databento::DbnParser parser(path);
+    parser.load_into_memory();
+    benchmark::DoNotOptimize(parser.data());
+  }
+  set_throughput(state, records);
+}
+
+// Args: records, cache
+void BM_ParseCallback(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    uint64_t checksum = 0;
+    parser.parse_mbo([&](const MboMsg& msg) { checksum ^= msg.ts_event ^ msg.instrument_id; });
+    benchmark::DoNotOptimize(checksum);
+  }
+  set_throughput(state, records);
+}
+
+// Same checksum over parser.records<MboMsg>() (no callback, no copy).
+// Args: records, cache
+void BM_RecordView(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    uint64_t checksum = 0;
+    for (const MboMsg& msg : parser.records<MboMsg>().span()) {
+      checksum ^= msg.ts_event ^ msg.instrument_id;
+    }
+    benchmark::DoNotOptimize(checksum);
+  }
+  set_throughput(state, records);
+}
+
+// Same checksum loading only the two projected fields. Args: records, cache
+void BM_ProjectedScan(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    uint64_t checksum = 0;
+    databento::scan<&MboMsg::ts_event, &MboMsg::instrument_id>(
+        parser, [&](uint64_t ts, uint32_t instrument) { checksum ^= ts ^ instrument; });
+    benchmark::DoNotOptimize(checksum);
+  }
+  set_throughput(state, records);
+}
+
+// Same checksum pulled from a coroutine in 4096-record batches.
+// Args: records, cache
+void BM_AsyncBatches(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    uint64_t checksum = 0;
+    auto consume = [&]() -> databento::Task {
+      auto batches = databento::mbo_batches(parser);
+      while (auto* batch = co_await batches.next()) {
+        for (const MboMsg& msg : batch->span()) {
+          checksum ^= msg.ts_event ^ msg.instrument_id;
+        }
+      }
+    };
+    databento::StreamScheduler scheduler;
+    scheduler.spawn(consume());
+    scheduler.run();
+    benchmark::DoNotOptimize(checksum);
+  }
+  set_throughput(state, records);
+}
+
+// Text encoding only (no file I/O); bytes are output text.
+// Args: records, format (0 = CSV, 1 = JSON lines)
+void BM_EncodeText(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+  databento::ExportOptions options;
+  options.format = static_cast<databento::TextFormat>(state.range(1));
+  auto out = std::make_unique_for_overwrite<char[]>(records * databento::MAX_TEXT_RECORD_BYTES);
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    bytes = databento::encode_mbo_text(parser, options, out.get());
+    benchmark::DoNotOptimize(out.get());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * records));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// Args: records, cache
+void BM_Batch(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+  databento::BatchProcessor processor;
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    uint64_t checksum = 0;
+    processor.process_batches<MboMsg>(parser, [&](const std::vector<MboMsg>& batch) {
+      for (const auto& msg : batch) {
+        checksum ^= msg.ts_event ^ msg.instrument_id;
+      }
+    });
+    benchmark::DoNotOptimize(checksum);
+  }
+  set_throughput(state, records);
+}
+
+// Per-thread partial results kept on separate cache lines
+struct alignas(64) Partial {
+  uint64_t value = 0;
+  uint64_t count = 0;
+};
+
+template<typename Fn>
+void for_each_chunk(databento::DbnParser& parser, unsigned threads, std::vector<Partial>& out,
+                    Fn&& fn) {
+  const uint8_t* base = parser.get_record(0);
+  const size_t rec_size = parser.record_size();
+  const size_t total = parser.num_records();
+  databento::parallel_for(threads, [&](unsigned t) {
+    const auto [begin, end] = databento::chunk_range(total, threads, t);
+    Partial partial;
+    for (size_t i = begin; i < end; ++i) {
+      fn(base + i * rec_size, partial);
+    }
+    out[t] = partial;
+  });
+}
+
+// Args: records, threads, cache
+void BM_DirectAccess(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+  std::vector<Partial> partials(threads);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    for_each_chunk(parser, threads, partials, [](const uint8_t* rec, Partial& p) {
+      p.value ^= databento::read_u64_le(rec) ^ databento::read_u32_le(rec + 8);
+    });
+    benchmark::DoNotOptimize(partials.data());
+  }
+  set_throughput(state, records);
+}
+
+// Args: records, threads, cache
+void BM_Filter(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+  std::vector<Partial> partials(threads);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    for_each_chunk(parser, threads, partials, [](const uint8_t* rec, Partial& p) {
+      const bool match = databento::read_u32_le(rec + 8) == FILTER_INSTRUMENT &&
+                         static_cast<int64_t>(databento::read_u64_le(rec + 16)) >= FILTER_MIN_PRICE;
+      p.count += match;
+    });
+    benchmark::DoNotOptimize(partials.data());
+  }
+  set_throughput(state, records);
+}
+
+// Volume-weighted notional per instrument. Args: records, threads, cache
+void BM_Aggregate(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+  const uint8_t* base = parser.get_record(0);
+  const size_t rec_size = parser.record_size();
+
+  struct Totals {
+    int64_t notional = 0;
+    uint64_t volume = 0;
+  };
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    std::vector<databento::FlatHashMap<uint32_t, Totals>> maps(threads);
+    databento::parallel_for(threads, [&](unsigned t) {
+      const auto [begin, end] = databento::chunk_range(records, threads, t);
+      auto& map = maps[t];
+      for (size_t i = begin; i < end; ++i) {
+        const uint8_t* rec = base + i * rec_size;
+        Totals& totals = map[databento::read_u32_le(rec + 8)];
+        const uint32_t size = databento::read_u32_le(rec + 24);
+        totals.notional += static_cast<int64_t>(databento::read_u64_le(rec + 16) / 1'000'000) * size;
+        totals.volume += size;
+      }
+    });
+    // Merge into the first map
+    for (unsigned t = 1; t < threads; ++t) {
+      maps[t].for_each([&](uint32_t id, const Totals& totals) {
+        Totals& merged = maps[0][id];
+        merged.notional += totals.notional;
+        merged.volume += totals.volume;
+      });
+    }
+    benchmark::DoNotOptimize(maps[0].size());
+  }
+  set_throughput(state, records);
+}
+
+// BM_Filter expressed through the query layer; should match it. Args as above
+void BM_QueryFilter(benchmark::State& state) {
+  using namespace databento::query;
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+  const auto plan = where(instrument_id == FILTER_INSTRUMENT && price >= FILTER_MIN_PRICE).count();
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    benchmark::DoNotOptimize(plan.run(parser, threads));
+  }
+  set_throughput(state, records);
+}
+
+// BM_Aggregate expressed through the query layer: both sums in one pass
+void BM_QueryAggregate(benchmark::State& state) {
+  using namespace databento::query;
+  const auto records = static_cast<size_t>(state.range(0));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+  const auto plan = all().group_by(instrument_id).aggregate(sum(price * size), sum(size));
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    benchmark::DoNotOptimize(plan.run(parser, threads).size());
+  }
+  set_throughput(state, records);
+}
+
+// Exact per-instrument statistics (volume, 128-bit notional, counts, range)
+void BM_InstrumentStats(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  databento::AggregateOptions options;
+  options.threads = static_cast<unsigned>(state.range(1));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(2)));
+    benchmark::DoNotOptimize(databento::aggregate_by_instrument(parser, options).size());
+  }
+  set_throughput(state, records);
+}
+
+// As-of join of the file against itself: two merged scans, compare with
+// twice BM_ParseCallback
+void BM_AsOfJoin(benchmark::State& state) {
+  const auto records = static_cast<size_t>(state.range(0));
+  auto& parser = loaded_parser(records);
+
+  for (auto _ : state) {
+    prepare_iteration(state, static_cast<Cache>(state.range(1)));
+    int64_t spread = 0;
+    databento::asof_join(parser, parser, [&](const MboMsg& msg, const MboMsg* prior) {
+      spread += prior ? msg.price - prior->price : 0;
+    });
+    benchmark::DoNotOptimize(spread);
+  }
+  set_throughput(state, records);
+}
+
+uint64_t minor_page_faults() {
+  struct rusage usage {};
+  ::getrusage(RUSAGE_SELF, &usage);
+  return static_cast<uint64_t>(usage.ru_minflt);
+}
+
+// Load the same file FILES_PER_ITERATION times, as a job over many day
+// files would: fresh parsers each time, or one parser re-targeted with
+// reset() over pooled buffers. Reports minor page faults per file.
+void BM_LoadManyFiles(benchmark::State& state) {
+  constexpr int FILES_PER_ITERATION = 8;
+  const auto records = static_cast<size_t>(state.range(0));
+  const bool pooled = state.range(1) != 0;
+  const std::string& path = bench_file(records);
+
+  databento::BufferPool pool;
+  databento::DbnParser reused(path);
+  reused.set_buffer_pool(&pool);
+  uint64_t faults = 0;
+  for (auto _ : state) {
+    const uint64_t before = minor_page_faults();
+    for (int f = 0; f < FILES_PER_ITERATION; ++f) {
+      if (pooled) {
+        reused.reset(path);
+        reused.load_into_memory();
+        benchmark::DoNotOptimize(reused.data());
+      } else {
+        databento::DbnParser parser(path);
+        parser.load_into_memory();
+        benchmark::DoNotOptimize(parser.data());
+      }
+    }
+    faults += minor_page_faults() - before;
+  }
+  state.counters["faults_per_file"] = benchmark::Counter(
+      static_cast<double>(faults) / static_cast<double>(state.iterations() * FILES_PER_ITERATION));
+  set_throughput(state, records * FILES_PER_ITERATION);
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+const std::vector<int64_t> SIZES = {1 << 16, 1 << 20, 1 << 22};
+const std::vector<int64_t> THREADS = {1, 2, 4, 8};
+const std::vector<int64_t> CACHES = {Warm, Cold};
+
+BENCHMARK(BM_Load)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ParseCallback)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_RecordView)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ProjectedScan)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_AsyncBatches)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_EncodeText)
+    ->ArgsProduct({SIZES, {0, 1}})
+    ->ArgNames({"records", "json"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_Batch)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_DirectAccess)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_Filter)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_Aggregate)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_QueryFilter)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_QueryAggregate)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_InstrumentStats)
+    ->ArgsProduct({SIZES, THREADS, CACHES})
+    ->ArgNames({"records", "threads", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_AsOfJoin)
+    ->ArgsProduct({SIZES, CACHES})
+    ->ArgNames({"records", "cold"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_LoadManyFiles)
+    ->ArgsProduct({SIZES, {0, 1}})
+    ->ArgNames({"records", "pooled"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,195 @@
+// Compression ratio and speed of the MBO codec versus zstd
+
+#include <databento/codec.hpp>
+#include <databento/parser.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef DATABENTO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using databento::MboMsg;
+
+namespace {
+
+constexpr int REPEATS = 5;
+
+struct CodecResult {
+  std::string codec;
+  double ratio;
+  double compress_gbps;
+  double decompress_gbps;
+};
+
+// Best-of-N wall time of fn in seconds
+template<typename Fn>
+double best_time(Fn&& fn) {
+  double best = 1e30;
+  for (int r = 0; r < REPEATS; ++r) {
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end - start).count());
+  }
+  return best;
+}
+
+double gbps(size_t bytes, double seconds) {
+  return bytes / (seconds * 1024 * 1024 * 1024);
+}
+
+// Perfectly regular stream: constant strides, ten instruments
+std::vector<MboMsg> synthetic_records(size_t n) {
+  std::vector<MboMsg> records(n);
+  for (size_t i = 0; i < n; ++i) {
+    MboMsg& m = records[i];
+    m = MboMsg{};
+    m.ts_event = 1'700'000'000'000'000'000ULL + i * 1000;
+    m.instrument_id = 1234 + i % 10;
+    m.action = 'A';
+    m.side = (i % 2) ? 'A' : 'B';
+    m.price = 5000'000'000'000LL + static_cast<int64_t>(i % 10) * 1'000'000'000LL;
+    m.size = 100 + (i % 10) * 10;
+    m.channel_id = 1;
+    m.order_id = 10000 + i;
+    m.sequence = static_cast<uint32_t>(i);
+  }
+  return records;
+}
+
+// Feed-like stream: bursty exponential inter-arrivals, random-walk prices
+// near the touch per instrument, adds/cancels/modifies/trades on live
+// orders, and a skewed instrument mix
+std::vector<MboMsg> real_shaped_records(size_t n) {
+  std::mt19937_64 rng(7);
+  std::exponential_distribution<double> gap(1.0 / 2000.0);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  constexpr int INSTRUMENTS = 40;
+  std::vector<int64_t> mid(INSTRUMENTS);
+  for (int k = 0; k < INSTRUMENTS; ++k) {
+    mid[k] = (1000 + k * 137) * 1'000'000'000LL;
+  }
+  std::vector<uint64_t> live;
+  uint64_t ts = 1'700'000'000'000'000'000ULL;
+  uint64_t next_order = 6'000'000'000'000ULL;
+
+  std::vector<MboMsg> records(n);
+  for (size_t i = 0; i < n; ++i) {
+    MboMsg& m = records[i];
+    m = MboMsg{};
+    ts += unit(rng) < 0.7 ? 0 : static_cast<uint64_t>(gap(rng));
+    const int inst = static_cast<int>(std::pow(unit(rng), 3.0) * INSTRUMENTS);
+    if (unit(rng) < 0.05) {
+      mid[inst] += (unit(rng) < 0.5 ? -1 : 1) * 250'000'000LL;
+    }
+    const double u = unit(rng);
+    m.action = u < 0.45 ? 'A' : u < 0.85 ? 'C' : u < 0.95 ? 'M' : 'T';
+    if (m.action == 'A' || live.empty()) {
+      m.action = 'A';
+      m.order_id = next_order++;
+      live.push_back(m.order_id);
+      if (live.size() > 4096) {
+        live.erase(live.begin(), live.begin() + 1024);
+      }
+    } else {
+      m.order_id = live[rng() % live.size()];
+    }
+    m.ts_event = ts;
+    m.instrument_id = 5000 + inst;
+    m.side = (rng() & 1) ? 'A' : 'B';
+    m.price = mid[inst] + static_cast<int64_t>(rng() % 8) * 250'000'000LL *
+                              (m.side == 'A' ? 1 : -1);
+    m.size = 1 + static_cast<uint32_t>(std::pow(unit(rng), 4.0) * 200);
+    m.flags = (rng() % 4 == 0) ? databento::F_LAST : 0;
+    m.channel_id = 3;
+    m.sequence = static_cast<uint32_t>(i * 2 + 100);
+    m.ts_in_delta = static_cast<uint8_t>(10 + rng() % 20);
+  }
+  return records;
+}
+
+CodecResult bench_mbo_codec(const std::vector<MboMsg>& records) {
+  const size_t raw = records.size() * sizeof(MboMsg);
+  std::vector<uint8_t> packed;
+  const double c = best_time([&] { databento::compress_mbo(records.data(), records.size(), packed); });
+  std::vector<MboMsg> out(records.size());
+  const double d = best_time([&] { databento::decompress_mbo(packed.data(), packed.size(), out.data()); });
+  if (std::memcmp(out.data(), records.data(), raw) != 0) {
+    throw std::runtime_error("MBO codec round trip mismatch");
+  }
+  return {"mbo-codec", static_cast<double>(raw) / packed.size(), gbps(raw, c), gbps(raw, d)};
+}
+
+#ifdef DATABENTO_HAVE_ZSTD
+CodecResult bench_zstd(const std::vector<MboMsg>& records, int level) {
+  const size_t raw = records.size() * sizeof(MboMsg);
+  std::vector<uint8_t> packed(ZSTD_compressBound(raw));
+  size_t packed_size = 0;
+  const double c = best_time([&] {
+    packed_size = ZSTD_compress(packed.data(), packed.size(), records.data(), raw, level);
+  });
+  if (ZSTD_isError(packed_size)) {
+    throw std::runtime_error(ZSTD_getErrorName(packed_size));
+  }
+  std::vector<MboMsg> out(records.size());
+  const double d = best_time([&] { ZSTD_decompress(out.data(), raw, packed.data(), packed_size); });
+  return {"zstd -" + std::to_string(level), static_cast<double>(raw) / packed_size,
+          gbps(raw, c), gbps(raw, d)};
+}
+#endif
+
+void run_dataset(const std::string& name, const std::vector<MboMsg>& records) {
+  std::vector<CodecResult> results;
+  results.push_back(bench_mbo_codec(records));
+#ifdef DATABENTO_HAVE_ZSTD
+  results.push_back(bench_zstd(records, 1));
+  results.push_back(bench_zstd(records, 3));
+  results.push_back(bench_zstd(records, 9));
+#endif
+
+  std::cout << "\n" << name << " (" << records.size() << " records, "
+            << records.size() * sizeof(MboMsg) / (1024 * 1024) << " MB)\n";
+  std::cout << std::string(70, '-') << "\n";
+  std::cout << std::left << std::setw(16) << "Codec" << std::right << std::setw(10) << "Ratio"
+            << std::setw(22) << "Compress GB/s" << std::setw(22) << "Decompress GB/s" << "\n";
+  for (const auto& r : results) {
+    std::cout << std::left << std::setw(16) << r.codec << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << r.ratio << std::setw(22)
+              << r.compress_gbps << std::setw(22) << r.decompress_gbps << "\n";
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::cout << "🗜️  MBO Codec Benchmark\n";
+#ifndef DATABENTO_HAVE_ZSTD
+  std::cout << "(zstd headers not found at build time; comparing codec only)\n";
+#endif
+
+  try {
+    const size_t n = argc > 2 ? std::stoull(argv[2]) : 4'000'000;
+    run_dataset("Synthetic", synthetic_records(n));
+    run_dataset("Real-shaped", real_shaped_records(n));
+
+    if (argc > 1 && argv[1][0] != '\0') {
+      databento::DbnParser parser(argv[1]);
+      parser.load_into_memory();
+      std::vector<MboMsg> records(parser.num_records());
+      std::memcpy(records.data(), parser.get_record(0), records.size() * sizeof(MboMsg));
+      run_dataset(argv[1], records);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -1,6 +1,7 @@
 // Batch processing example
 // Process records in large batches for better cache locality
 
+#include <databento/aggregate.hpp>
 #include <databento/parser.hpp>
 #include <iostream>
 #include <numeric>
@@ -32,8 +33,9 @@ int main(int argc, char** argv) {
     auto start = std::chrono::high_resolution_clock::now();
 
     auto batch_callback = [&](const std::vector<databento::MboMsg>& batch) {
-      // Calculate batch statistics
-      double total_price_weighted = 0.0;
+      // Calculate batch statistics. Notional stays in 1e-9 fixed point
+      // (128-bit) so the VWAP is exact.
+      databento::int128_t notional = 0;
       uint64_t total_volume = 0;
       uint64_t add_count = 0;
       uint64_t cancel_count = 0;
@@ -42,7 +44,7 @@ int main(int argc, char** argv) {
       for (const auto& msg : batch) {
         if (msg.action == 'A') {
           ++add_count;
-          total_price_weighted += databento::price_to_double(msg.price) * msg.size;
+          notional += static_cast<databento::int128_t>(msg.price) * msg.size;
           total_volume += msg.size;
         } else if (msg.action == 'C') {
           ++cancel_count;
@@ -58,8 +60,8 @@ int main(int argc, char** argv) {
         std::cout << "  Cancels: " << cancel_count << "\n";
         std::cout << "  Modifies:" << modify_count << "\n";
         if (total_volume > 0) {
-          double vwap = total_price_weighted / total_volume;
-          std::cout << "  VWAP:    $" << vwap << "\n";
+          const int64_t vwap = databento::vwap_fixed(notional, total_volume);
+          std::cout << "  VWAP:    $" << databento::price_to_double(vwap) << "\n";
           std::cout << "  Volume:  " << total_volume << "\n";
         }
         std::cout << "\n";
@@ -84,6 +86,18 @@ int main(int argc, char** argv) {
     std::cout << "Rate:          " << static_cast<uint64_t>(total_count / elapsed) << " records/sec\n";
     std::cout << std::string(70, '=') << "\n";
 
+    // Whole-file per-instrument statistics on all cores
+    databento::AggregateOptions options;
+    options.volume_actions = "A";  // Same convention as the batch VWAP above
+    const auto instruments = databento::aggregate_by_instrument(parser, options);
+    std::cout << "\nPer-instrument (add volume, exact VWAP):\n";
+    for (size_t i = 0; i < instruments.size() && i < 10; ++i) {
+      const auto& s = instruments[i];
+      std::cout << "  " << s.instrument_id << ": records=" << s.records
+                << " adds=" << s.count(databento::Action::Add)
+                << " volume=" << s.volume << " VWAP=$" << s.vwap() << "\n";
+    }
+
     std::cout << "\n✅ Successfully processed " << total_count << " records in " 
               << batch_num << " batches\n";
 
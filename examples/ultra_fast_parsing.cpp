@@ -2,6 +2,7 @@
 // Direct memory access without callbacks for maximum performance
 
 #include <databento/parser.hpp>
+#include <databento/projection.hpp>
 #include <iostream>
 #include <chrono>
 #include <iomanip>
@@ -29,25 +30,18 @@ int main(int argc, char** argv) {
     auto start = std::chrono::high_resolution_clock::now();
 
     // Direct memory access - no callback overhead
-    const uint8_t* data = parser.data();
     const size_t total = parser.num_records();
-    const size_t offset = parser.metadata_offset();
-    const size_t rec_size = parser.record_size();
-    
     uint64_t checksum = 0;
-    
-    // Ultra-fast loop with minimal operations
-    for (size_t i = 0; i < total; ++i) {
-      const uint8_t* record = data + offset + (i * rec_size);
-      
-      // Read only essential fields (same as Rust benchmark)
-      uint64_t ts_event = databento::read_u64_le(record);
-      uint32_t instrument_id = databento::read_u32_le(record + 8);
-      
-      // Accumulate to prevent compiler optimization removal
-      checksum ^= ts_event;
-      checksum ^= instrument_id;
-    }
+
+    // Read only essential fields (same as Rust benchmark); the projected
+    // scan loads just these two offsets from each record, inlined
+    using databento::MboMsg;
+    databento::scan<&MboMsg::ts_event, &MboMsg::instrument_id>(
+        parser, [&](uint64_t ts_event, uint32_t instrument_id) {
+          // Accumulate to prevent compiler optimization removal
+          checksum ^= ts_event;
+          checksum ^= instrument_id;
+        });
 
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double>(end - start).count();
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "dbn.hpp"
+#include "query.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Exact Per-Instrument Aggregation
+// ============================================================================
+
+// Notional in price units (1e-9) times size. A day of ES trades overflows
+// int64 within minutes, so it is summed in 128 bits.
+__extension__ typedef __int128 int128_t;
+
+std::string int128_to_string(int128_t value);
+
+// notional / volume rounded to nearest, in 1e-9 units; 0 when volume == 0
+int64_t vwap_fixed(int128_t notional, uint64_t volume);
+
+// Action slots for InstrumentStats::action_counts
+enum class ActionSlot : uint8_t { Add, Cancel, Modify, Clear, Trade, Fill, Other };
+constexpr size_t NUM_ACTION_SLOTS = 7;
+
+inline ActionSlot action_slot(char action) {
+  switch (action) {
+    case 'A': return ActionSlot::Add;
+    case 'C': return ActionSlot::Cancel;
+    case 'M': return ActionSlot::Modify;
+    case 'R': return ActionSlot::Clear;
+    case 'T': return ActionSlot::Trade;
+    case 'F': return ActionSlot::Fill;
+    default: return ActionSlot::Other;
+  }
+}
+
+struct InstrumentStats {
+  uint32_t instrument_id = 0;
+  uint64_t records = 0;
+  std::array<uint64_t, NUM_ACTION_SLOTS> action_counts{};
+
+  // Over records whose action is one of AggregateOptions::volume_actions
+  uint64_t volume = 0;
+  int128_t notional = 0;                         // sum(price * size), 1e-9 units
+  int64_t min_price = INT64_MAX;                 // INT64_MAX / INT64_MIN when volume == 0
+  int64_t max_price = INT64_MIN;
+
+  uint64_t count(Action action) const {
+    return action_counts[static_cast<size_t>(action_slot(static_cast<char>(action)))];
+  }
+
+  int64_t vwap_fixed() const { return databento::vwap_fixed(notional, volume); }
+  double vwap() const { return price_to_double(vwap_fixed()); }
+
+  bool operator==(const InstrumentStats& other) const = default;
+};
+
+struct AggregateOptions {
+  // Actions whose size/price feed volume, notional, VWAP and min/max.
+  // MBO trades appear as the aggressor 'T' plus resting 'F' fills, so
+  // counting both would double the volume.
+  std::string volume_actions = "T";
+  unsigned threads = 0;                           // 0 = hardware concurrency
+};
+
+// Per-instrument statistics sorted by instrument_id. Threads aggregate
+// contiguous chunks into their own flat hash tables, merged at the end;
+// all arithmetic is integer, so results are identical for any thread count.
+std::vector<InstrumentStats> aggregate_by_instrument(const query::RecordRange& records,
+                                                     const AggregateOptions& options = {});
+
+} // namespace databento
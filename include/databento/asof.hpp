@@ -0,0 +1,136 @@
+#pragma once
+
+#include "dbn.hpp"
+#include "fields.hpp"
+#include "flat_hash_map.hpp"
+#include "query.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// As-Of Join
+// ============================================================================
+
+struct AsOfOptions {
+  // Right records older than this (ts_event difference, ns) do not match
+  uint64_t tolerance_ns = UINT64_MAX;
+  // Whether a right record with the same ts_event as the left one prevails
+  bool allow_exact_matches = true;
+};
+
+struct AsOfStats {
+  uint64_t left_records = 0;
+  uint64_t right_records = 0;          // Consumed from all right streams
+  std::vector<uint64_t> matched;       // Left records with a match, per right stream
+};
+
+// Joins every left record to the latest record of each right stream with
+// the same instrument_id and ts_event <= its own, in one merge pass over
+// the buffers. Per instrument only a pointer to the prevailing right record
+// is kept, so nothing is copied except the records handed to fn:
+//
+//   fn(const MboMsg& left, std::span<const MboMsg* const> matches)
+//
+// with one entry per right stream, nullptr where nothing prevails. All
+// streams must be sorted by ts_event; std::invalid_argument otherwise.
+// Right records after the last left record are not read.
+template<typename Fn>
+AsOfStats asof_join(const query::RecordRange& left, const std::vector<query::RecordRange>& rights,
+                    Fn&& fn, const AsOfOptions& options = {}) {
+  if (rights.empty()) {
+    throw std::invalid_argument("As-of join needs at least one right stream");
+  }
+  using Ts = FieldTraits<&MboMsg::ts_event>;
+  using Id = FieldTraits<&MboMsg::instrument_id>;
+
+  const size_t n = rights.size();
+  AsOfStats stats;
+  stats.matched.assign(n, 0);
+
+  // Instrument -> row of `prevailing`, n right-record pointers per row
+  FlatHashMap<uint32_t, uint32_t> rows;
+  std::vector<const uint8_t*> prevailing;
+  // Consecutive records often share an instrument; skip the probe then
+  uint32_t cached_id = 0;
+  size_t cached_row = SIZE_MAX;
+  auto row_for = [&](uint32_t id) {
+    if (id != cached_id || cached_row == SIZE_MAX) {
+      auto [row, inserted] = rows.try_emplace(id, static_cast<uint32_t>(prevailing.size() / n));
+      if (inserted) {
+        prevailing.resize(prevailing.size() + n, nullptr);
+      }
+      cached_id = id;
+      cached_row = static_cast<size_t>(*row) * n;
+    }
+    return cached_row;
+  };
+
+  std::vector<size_t> cursor(n, 0);
+  std::vector<uint64_t> last_right_ts(n, 0);
+  std::vector<MboMsg> scratch(n);
+  std::vector<const MboMsg*> matches(n, nullptr);
+  uint64_t last_left_ts = 0;
+
+  const uint8_t* rec = left.data;
+  for (size_t i = 0; i < left.count; ++i, rec += left.stride) {
+    const uint64_t ts = Ts::load(rec);
+    if (ts < last_left_ts) {
+      throw std::invalid_argument("As-of join left stream is not sorted by ts_event");
+    }
+    last_left_ts = ts;
+
+    // Bring every right stream up to this timestamp
+    for (size_t r = 0; r < n; ++r) {
+      const query::RecordRange& right = rights[r];
+      while (cursor[r] < right.count) {
+        const uint8_t* rrec = right.data + cursor[r] * right.stride;
+        const uint64_t rts = Ts::load(rrec);
+        if (rts > ts || (rts == ts && !options.allow_exact_matches)) {
+          break;
+        }
+        if (rts < last_right_ts[r]) {
+          throw std::invalid_argument("As-of join right stream is not sorted by ts_event");
+        }
+        last_right_ts[r] = rts;
+        prevailing[row_for(Id::load(rrec)) + r] = rrec;
+        ++cursor[r];
+      }
+    }
+
+    const size_t row = row_for(Id::load(rec));
+    for (size_t r = 0; r < n; ++r) {
+      const uint8_t* match = prevailing[row + r];
+      if (match && ts - Ts::load(match) <= options.tolerance_ns) {
+        scratch[r] = parse_mbo(match);
+        matches[r] = &scratch[r];
+        ++stats.matched[r];
+      } else {
+        matches[r] = nullptr;
+      }
+    }
+    fn(parse_mbo(rec), std::span<const MboMsg* const>(matches));
+  }
+
+  stats.left_records = left.count;
+  for (size_t r = 0; r < n; ++r) {
+    stats.right_records += cursor[r];
+  }
+  return stats;
+}
+
+// Two-stream form: fn(const MboMsg& left, const MboMsg* match)
+template<typename Fn>
+AsOfStats asof_join(const query::RecordRange& left, const query::RecordRange& right, Fn&& fn,
+                    const AsOfOptions& options = {}) {
+  return asof_join(
+      left, std::vector<query::RecordRange>{right},
+      [&](const MboMsg& msg, std::span<const MboMsg* const> matches) { fn(msg, matches[0]); },
+      options);
+}
+
+} // namespace databento
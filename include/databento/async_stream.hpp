@@ -0,0 +1,249 @@
+#pragma once
+
+#include "parser.hpp"
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Coroutine Record Streams
+// ============================================================================
+//
+//   databento::StreamScheduler scheduler;
+//   auto consume = [&](databento::DbnParser& parser) -> databento::Task {
+//     auto batches = databento::follow_mbo_batches(parser, scheduler, {.idle_timeout = 1s});
+//     while (auto* batch = co_await batches.next()) {
+//       for (const MboMsg& msg : *batch) { ... }
+//     }
+//   };
+//   scheduler.spawn(consume(parser_a));
+//   scheduler.spawn(consume(parser_b));
+//   scheduler.run();   // Both streams on this thread
+//
+// Suspension is per batch, never per record. A generator waiting for data
+// parks on the scheduler, and its consumer with it, so other tasks run.
+
+class StreamScheduler;
+
+// ----------------------------------------------------------------------------
+// Task
+// ----------------------------------------------------------------------------
+
+// Top-level coroutine run by a StreamScheduler. Starts suspended; an
+// exception escaping it is rethrown from StreamScheduler::run().
+class Task {
+public:
+  struct promise_type {
+    std::exception_ptr exception;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+  };
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  ~Task() { destroy(); }
+
+  bool done() const { return !handle_ || handle_.done(); }
+
+private:
+  friend class StreamScheduler;
+
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+  void destroy() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Async Generator
+// ----------------------------------------------------------------------------
+
+// Pull-based coroutine producing T values. `co_await next()` resumes the
+// generator until it yields (pointer to the value, valid until the next
+// call) or finishes (nullptr); the generator's exceptions are rethrown
+// there. Control passes directly between generator and consumer, so a
+// batch costs two coroutine switches and no allocation.
+template<typename T>
+class AsyncGenerator {
+public:
+  struct promise_type;
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  // Hands control back to whoever is awaiting next()
+  struct ResumeConsumer {
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+      return h.promise().consumer;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  struct promise_type {
+    std::optional<T> value;
+    std::coroutine_handle<> consumer = std::noop_coroutine();
+    std::exception_ptr exception;
+
+    AsyncGenerator get_return_object() { return AsyncGenerator(handle_type::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    ResumeConsumer final_suspend() noexcept { return {}; }
+    ResumeConsumer yield_value(T v) {
+      value = std::move(v);
+      return {};
+    }
+    void return_void() noexcept { value.reset(); }
+    void unhandled_exception() noexcept {
+      value.reset();
+      exception = std::current_exception();
+    }
+  };
+
+  struct NextAwaiter {
+    handle_type handle;
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+      handle.promise().consumer = consumer;
+      return handle;
+    }
+    T* await_resume() {
+      if (!handle) {
+        return nullptr;
+      }
+      auto& promise = handle.promise();
+      if (promise.exception) {
+        std::rethrow_exception(std::exchange(promise.exception, nullptr));
+      }
+      return handle.done() || !promise.value ? nullptr : &*promise.value;
+    }
+  };
+
+  AsyncGenerator(AsyncGenerator&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  AsyncGenerator& operator=(AsyncGenerator&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  AsyncGenerator(const AsyncGenerator&) = delete;
+  AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+  ~AsyncGenerator() { destroy(); }
+
+  // Only awaitable from inside a coroutine
+  NextAwaiter next() { return NextAwaiter{handle_}; }
+
+private:
+  handle_type handle_;
+
+  explicit AsyncGenerator(handle_type handle) : handle_(handle) {}
+  void destroy() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Scheduler
+// ----------------------------------------------------------------------------
+
+// Single-threaded event loop: runs spawned Tasks and resumes coroutines
+// parked on file descriptors or timers (ppoll). Not thread-safe; all
+// tasks and the generators they own run on the thread calling run().
+class StreamScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  StreamScheduler() = default;
+
+  StreamScheduler(const StreamScheduler&) = delete;
+  StreamScheduler& operator=(const StreamScheduler&) = delete;
+
+  // Queue a task; it first runs inside run()
+  void spawn(Task task);
+
+  // Run until every spawned task has finished. The first exception to
+  // escape a task is rethrown (other tasks stay suspended).
+  void run();
+
+  struct WaitAwaiter {
+    StreamScheduler* scheduler;
+    int fd;                   // -1: timer only
+    Clock::time_point deadline;
+    bool readable = false;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { scheduler->park(this, handle); }
+    bool await_resume() const noexcept { return readable; }
+  };
+
+  // Resume when fd is readable (true) or after timeout (false)
+  WaitAwaiter readable(int fd, std::chrono::nanoseconds timeout) {
+    return WaitAwaiter{this, fd, Clock::now() + timeout};
+  }
+  WaitAwaiter sleep(std::chrono::nanoseconds duration) { return readable(-1, duration); }
+
+  // Let every other ready coroutine run first
+  WaitAwaiter yield() { return readable(-1, std::chrono::nanoseconds{0}); }
+
+private:
+  struct Parked {
+    WaitAwaiter* awaiter;
+    std::coroutine_handle<> handle;
+  };
+
+  std::vector<Task> tasks_;
+  std::deque<std::coroutine_handle<>> ready_;
+  std::vector<Parked> parked_;
+
+  void park(WaitAwaiter* awaiter, std::coroutine_handle<> handle);
+  void wait_for_events();
+};
+
+// ----------------------------------------------------------------------------
+// Record Sources
+// ----------------------------------------------------------------------------
+
+inline constexpr size_t DEFAULT_STREAM_BATCH = 4096;  // Records per yield
+
+// The parser's records (loaded if needed) in batches of up to batch_records.
+// Never waits on I/O, so in-memory files and growing ones share consumers.
+AsyncGenerator<RecordView<MboMsg>> mbo_batches(DbnParser& parser,
+                                               size_t batch_records = DEFAULT_STREAM_BATCH);
+
+// follow_mbo() as a generator: yields new records as the file grows, parking
+// on the scheduler (inotify or poll_interval) while there are none, and
+// finishes after options.idle_timeout without growth. Stopping is simply
+// no longer awaiting next().
+AsyncGenerator<RecordView<MboMsg>> follow_mbo_batches(DbnParser& parser, StreamScheduler& scheduler,
+                                                      FollowOptions options = {},
+                                                      size_t batch_records = DEFAULT_STREAM_BATCH);
+
+} // namespace databento
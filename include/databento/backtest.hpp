@@ -0,0 +1,143 @@
+#pragma once
+
+#include "order_book.hpp"
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Simulated Orders
+// ============================================================================
+
+enum class SimOrderStatus : uint8_t {
+  Pending,    // Submitted, waiting out entry latency
+  Active,     // Resting in the simulated queue
+  Filled,
+  Cancelled,
+};
+
+struct SimOrder {
+  uint64_t id;
+  uint32_t instrument_id;
+  char side;              // 'B' or 'A'
+  int64_t price;          // Fixed point 1e-9
+  uint32_t size;          // Original size
+  uint32_t remaining;
+  uint64_t queue_ahead;   // Historical volume ahead of us at our level
+  uint64_t priority;      // Book priority at activation
+  uint64_t submit_ts;
+  uint64_t active_ts;
+  SimOrderStatus status;
+};
+
+struct SimFill {
+  uint64_t order_id;      // Simulated order ID
+  uint64_t ts_event;      // Market event that caused the fill
+  int64_t price;
+  uint32_t size;
+  uint32_t remaining;     // Remaining after this fill
+};
+
+using SimFillCallback = std::function<void(const SimFill&)>;
+
+struct MatchingOptions {
+  uint64_t entry_latency_ns = 0;   // Submit -> resting in the book
+  uint64_t cancel_latency_ns = 0;  // Cancel request -> removed
+};
+
+// ============================================================================
+// Matching Simulator
+// ============================================================================
+
+// Simulates passive limit orders against a historical MBO stream.
+//
+// On activation an order joins the back of its price level: queue_ahead is
+// the historical size resting there at that instant. Cancels, size-reducing
+// modifies and re-queues of historical orders that were ahead of us reduce
+// queue_ahead. Trades ('T') at our level drain queue_ahead first, and any
+// remaining trade volume fills simulated orders in submission order. A trade
+// strictly through our price fills the order completely at its limit. Fills
+// ('F') only update historical order sizes, since the preceding trade has
+// already drained the queue. Simulated orders never remove historical
+// liquidity, and orders that would cross on entry rest until traded.
+//
+// Feed every record with on_mbo() in file order, e.g. from
+// DbnParser::parse_mbo; state is kept in flat hash maps and vectors so a
+// full session with thousands of resting orders stays cheap per event.
+class MatchingSimulator {
+public:
+  explicit MatchingSimulator(const MatchingOptions& options = {});
+
+  // Strategy actions, stamped with the strategy's notion of "now"
+  uint64_t submit(uint32_t instrument_id, Side side, int64_t price,
+                  uint32_t size, uint64_t now_ns);
+  void cancel(uint64_t order_id, uint64_t now_ns);
+
+  // Market data, in file order
+  void on_mbo(const MboMsg& msg);
+
+  // Process pending submits/cancels due at or before ts without market data
+  void advance_to(uint64_t ts);
+
+  void set_fill_callback(SimFillCallback callback) { on_fill_ = std::move(callback); }
+
+  const SimOrder& order(uint64_t order_id) const { return orders_.at(order_id); }
+  const std::vector<SimOrder>& orders() const { return orders_; }
+  const std::vector<SimFill>& fills() const { return fills_; }
+  const OrderBook& book() const { return book_; }
+  size_t active_orders() const { return active_count_; }
+
+private:
+  enum class PendingType : uint8_t { Submit, Cancel };
+
+  struct PendingAction {
+    uint64_t ts;
+    uint64_t seq;
+    uint64_t order_id;
+    PendingType type;
+  };
+
+  // Simulated orders resting at one (instrument, side, price), oldest first
+  struct SimLevel {
+    std::vector<uint32_t> orders;
+  };
+
+  MatchingOptions options_;
+  OrderBook book_;
+  std::vector<SimOrder> orders_;
+  std::vector<SimFill> fills_;
+  std::vector<PendingAction> pending_;  // Min-heap on (ts, seq)
+  uint64_t pending_seq_ = 0;
+  size_t active_count_ = 0;
+  SimFillCallback on_fill_;
+
+  FlatHashMap<LevelKey, uint32_t> level_index_;  // -> levels_ slot
+  std::vector<SimLevel> levels_;
+  std::vector<uint32_t> free_levels_;
+  // Sorted distinct prices with active orders, per (instrument, side)
+  FlatHashMap<uint64_t, std::vector<int64_t>> active_prices_;
+
+  // on_trade() scratch, kept to avoid allocating per historical trade
+  std::vector<std::pair<uint32_t, uint32_t>> scratch_partial_;
+  std::vector<int64_t> scratch_prices_;
+  std::vector<uint32_t> scratch_orders_;
+
+  void schedule(uint64_t ts, uint64_t order_id, PendingType type);
+  void activate(SimOrder& order, uint64_t ts);
+  void deactivate(SimOrder& order);
+  SimLevel* find_level(uint32_t instrument_id, char side, int64_t price);
+
+  void on_queue_reduction(const RestingOrder& historical, uint64_t removed);
+  void on_trade(const MboMsg& msg, char passive_side);
+  void on_clear(uint32_t instrument_id);
+  void fill(SimOrder& order, uint64_t ts, uint32_t size);
+
+  static uint64_t side_key(uint32_t instrument_id, char side) {
+    return (static_cast<uint64_t>(instrument_id) << 8) | static_cast<uint8_t>(side);
+  }
+};
+
+} // namespace databento
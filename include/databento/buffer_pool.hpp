@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Page-Backed Buffers
+// ============================================================================
+
+enum class HugePages : uint8_t {
+  None,
+  Transparent,      // madvise(MADV_HUGEPAGE); the kernel promotes when it can
+  Explicit2MB,      // MAP_HUGETLB from the reserved pool, else Transparent
+  Explicit1GB,
+};
+
+class BufferPool;
+
+// Uninitialised, anonymous-mmap byte buffer. Growth keeps the contents and
+// is geometric (mremap where possible), and nothing is ever zeroed by us,
+// so a freshly loaded file costs one page fault per page and no memset.
+// Buffers from a BufferPool go back to it on destruction; the pool must
+// outlive them.
+class PooledBuffer {
+public:
+  PooledBuffer() = default;
+  explicit PooledBuffer(HugePages huge_pages) : huge_pages_(huge_pages) {}
+  ~PooledBuffer() { release(); }
+
+  PooledBuffer(PooledBuffer&& other) noexcept { *this = std::move(other); }
+  PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+  PooledBuffer(const PooledBuffer&) = delete;
+  PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool huge() const { return huge_; }   // Backed by explicit hugetlb pages
+
+  // New bytes are uninitialised (zero pages on first touch if never used)
+  void resize(size_t size);
+
+private:
+  friend class BufferPool;
+
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  HugePages huge_pages_ = HugePages::None;
+  bool huge_ = false;
+  BufferPool* pool_ = nullptr;
+
+  void reserve(size_t capacity);
+  void release();
+  void unmap();
+};
+
+// ============================================================================
+// Buffer Pool
+// ============================================================================
+
+struct BufferPoolOptions {
+  HugePages huge_pages = HugePages::None;
+  // Returned buffers beyond this many cached bytes are unmapped
+  size_t max_cached_bytes = size_t{16} << 30;
+};
+
+struct BufferPoolStats {
+  uint64_t acquires = 0;
+  uint64_t reuses = 0;           // Served from a cached buffer
+  uint64_t new_mappings = 0;
+  size_t cached_bytes = 0;       // Capacity currently idle in the pool
+};
+
+// Thread-safe cache of PooledBuffers. acquire() prefers the smallest cached
+// buffer that fits, then the largest one (grown in place, so its touched
+// pages stay resident), and only maps fresh memory when the pool is empty.
+class BufferPool {
+public:
+  explicit BufferPool(const BufferPoolOptions& options = {}) : options_(options) {}
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  // Buffer with size() == bytes, contents unspecified
+  PooledBuffer acquire(size_t bytes);
+
+  // Unmap every cached buffer
+  void trim();
+
+  BufferPoolStats stats() const;
+  const BufferPoolOptions& options() const { return options_; }
+
+private:
+  friend class PooledBuffer;
+
+  BufferPoolOptions options_;
+  mutable std::mutex mutex_;
+  std::vector<PooledBuffer> cached_;
+  BufferPoolStats stats_;
+
+  void give_back(PooledBuffer&& buffer);
+};
+
+} // namespace databento
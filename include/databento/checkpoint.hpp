@@ -0,0 +1,112 @@
+#pragma once
+
+#include "order_book.hpp"
+#include "parser.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// User State Registry
+// ============================================================================
+
+// Named blobs of user state captured at every checkpoint next to the book.
+// save() is called when a checkpoint is written; load() receives the bytes
+// previously returned by save() when resuming.
+class CheckpointRegistry {
+public:
+  using SaveFn = std::function<std::string()>;
+  using LoadFn = std::function<void(std::string_view)>;
+
+  void register_state(const std::string& name, SaveFn save, LoadFn load);
+
+  struct Entry {
+    std::string name;
+    SaveFn save;
+    LoadFn load;
+  };
+  const std::vector<Entry>& entries() const { return entries_; }
+
+private:
+  std::vector<Entry> entries_;
+};
+
+// ============================================================================
+// Checkpoint File
+// ============================================================================
+
+struct CheckpointOptions {
+  // Records between checkpoints; a final checkpoint is always written
+  size_t interval_records = 10'000'000;
+};
+
+// One checkpoint: state after applying records [0, record_index)
+struct CheckpointInfo {
+  uint64_t record_index;
+  uint64_t ts_event;      // ts_event of the last applied record (0 if none)
+  uint64_t file_offset;   // Offset of the snapshot in the checkpoint file
+  uint64_t order_count;
+};
+
+// Checkpoints are stored next to the data as "<data file>.ckpt"
+std::string default_checkpoint_path(const std::string& data_path);
+
+// Scan the whole file, applying every record to `book` and then invoking
+// `callback` (which may update registered user state), and write a
+// checkpoint of book + registry every options.interval_records records.
+// Returns the number of checkpoints written.
+size_t build_checkpoints(DbnParser& parser, const std::string& checkpoint_path,
+                         OrderBook& book, const CheckpointRegistry& registry,
+                         MboCallback callback, const CheckpointOptions& options = {});
+
+// Read-side view of a checkpoint file. Only the trailing index is read on
+// open; snapshots are read on demand by restore().
+class CheckpointFile {
+public:
+  explicit CheckpointFile(const std::string& path);
+
+  const std::vector<CheckpointInfo>& checkpoints() const { return index_; }
+
+  // Latest checkpoint whose last applied record has ts_event <= ts,
+  // or nullptr if the target precedes every checkpoint
+  const CheckpointInfo* find_before_ts(uint64_t ts) const;
+  // Latest checkpoint with record_index <= record_index
+  const CheckpointInfo* find_before_record(uint64_t record_index) const;
+
+  // Throws std::runtime_error if the checkpoint was built from another file.
+  // An unloaded parser stays unloaded; only the file's metadata is read.
+  void validate(const DbnParser& parser) const;
+
+  // Replace book contents and reload registered user state
+  void restore(const CheckpointInfo& checkpoint, OrderBook& book,
+               const CheckpointRegistry& registry) const;
+
+private:
+  std::string path_;
+  uint64_t source_size_ = 0;
+  uint64_t header_hash_ = 0;
+  uint32_t record_size_ = 0;
+  std::vector<CheckpointInfo> index_;
+};
+
+// Restore the nearest checkpoint at or before target_ts into book and
+// registry. If none applies the book is reset (orders and next priority)
+// and 0 is returned; registered load() functions are not called then, so
+// the caller must reset its own state. Returns the record index to
+// continue scanning from, e.g. with DbnParser::parse_mbo_from(), which on
+// an unloaded parser reads only the records from there on.
+size_t restore_checkpoint(DbnParser& parser, const std::string& checkpoint_path,
+                          uint64_t target_ts, OrderBook& book,
+                          const CheckpointRegistry& registry);
+
+// restore_checkpoint() followed by a scan of the remaining records, each
+// applied to `book` before `callback` runs. Returns the resume index.
+size_t resume_mbo(DbnParser& parser, const std::string& checkpoint_path,
+                  uint64_t target_ts, OrderBook& book,
+                  const CheckpointRegistry& registry, MboCallback callback);
+
+} // namespace databento
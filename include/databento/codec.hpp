@@ -0,0 +1,42 @@
+#pragma once
+
+#include "dbn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// MBO Record Codec
+// ============================================================================
+
+// Lossless field-wise codec for MboMsg records. Records are split into
+// blocks of MBO_CODEC_BLOCK; within a block every field (including the
+// reserved bytes) is stored as one bit-packed stream using whichever is
+// narrower:
+//   delta    v[i] - v[i-1] - min_delta, for monotone-ish ts_event,
+//            order_id and sequence (a constant stride packs to 0 bits)
+//   offset   v[i] - min(v), for small-range fields such as instrument_id
+// Either stream is divided by its common factor first, so prices on a tick
+// grid pack as tick counts. Offsetting deltas by their minimum replaces
+// zigzag coding: negative deltas need no sign bit.
+//
+// Decoding unpacks eight values per step with compile-time shifts and uses
+// an AVX2 prefix sum for delta streams when available.
+
+constexpr size_t MBO_CODEC_BLOCK = 256;
+
+// Encode `count` records into `out` (replacing its contents)
+void compress_mbo(const MboMsg* records, size_t count, std::vector<uint8_t>& out);
+std::vector<uint8_t> compress_mbo(const MboMsg* records, size_t count);
+
+// Number of records in a compressed buffer; throws on a malformed header
+size_t compressed_mbo_count(const uint8_t* data, size_t size);
+
+// Decode into `out`, which must hold compressed_mbo_count() records.
+// Throws std::runtime_error if the buffer is truncated or corrupt.
+void decompress_mbo(const uint8_t* data, size_t size, MboMsg* out);
+std::vector<MboMsg> decompress_mbo(const uint8_t* data, size_t size);
+
+} // namespace databento
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "dbn.hpp"
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Columns
+// ============================================================================
+
+enum class Column : uint32_t {
+  TsEvent = 0,
+  InstrumentId,
+  Action,
+  Side,
+  Flags,
+  Depth,
+  Price,
+  Size,
+  ChannelId,
+  OrderId,
+  Sequence,
+  TsInDelta,
+};
+
+constexpr size_t NUM_COLUMNS = 12;
+
+using ColumnMask = uint32_t;
+
+constexpr ColumnMask column_bit(Column c) {
+  return ColumnMask{1} << static_cast<uint32_t>(c);
+}
+
+constexpr ColumnMask ALL_COLUMNS = (ColumnMask{1} << NUM_COLUMNS) - 1;
+
+// ============================================================================
+// Scan Interface
+// ============================================================================
+
+// Conjunction of simple predicates; defaults match everything
+struct ScanPredicate {
+  uint64_t ts_min = 0;
+  uint64_t ts_max = std::numeric_limits<uint64_t>::max();  // Inclusive
+  std::vector<uint32_t> instrument_ids;                    // Empty = any
+  int64_t price_min = std::numeric_limits<int64_t>::min();
+  int64_t price_max = std::numeric_limits<int64_t>::max();
+  char action = 0;                                         // 0 = any
+  char side = 0;                                           // 0 = any
+};
+
+// Matching rows of one block. Only projected columns are non-null; each
+// points at `rows` decoded values owned by the cache until the next batch.
+// Row i sits at file row first_row + row_index[i] when a filter dropped
+// rows from the block, and at first_row + i when row_index is null.
+struct ColumnBatch {
+  size_t rows = 0;
+  uint64_t first_row = 0;  // Row index of the block's first row in the file
+  const uint32_t* row_index = nullptr;  // Block-relative selection vector
+  const uint64_t* ts_event = nullptr;
+  const uint32_t* instrument_id = nullptr;
+  const char* action = nullptr;
+  const char* side = nullptr;
+  const uint8_t* flags = nullptr;
+  const uint8_t* depth = nullptr;
+  const int64_t* price = nullptr;
+  const uint32_t* size = nullptr;
+  const uint32_t* channel_id = nullptr;
+  const uint64_t* order_id = nullptr;
+  const uint32_t* sequence = nullptr;
+  const uint8_t* ts_in_delta = nullptr;
+};
+
+struct ScanStats {
+  uint64_t blocks_total = 0;
+  uint64_t blocks_skipped = 0;   // Rejected by zone maps or dictionaries
+  uint64_t rows_scanned = 0;
+  uint64_t rows_matched = 0;
+};
+
+// Per-block min/max, inclusive
+struct ZoneMap {
+  uint64_t ts_min, ts_max;
+  uint32_t instrument_min, instrument_max;
+  int64_t price_min, price_max;
+};
+
+struct ColumnarOptions {
+  uint32_t block_rows = 65536;
+};
+
+// ============================================================================
+// Columnar Cache
+// ============================================================================
+
+// Memory-mapped columnar copy of a DBN file for repeated analytical scans.
+// Each block of rows stores every column separately:
+//   ts_event, price, order_id, sequence  delta + zigzag, narrowest byte width
+//   instrument_id, action, side, flags,  block dictionary + bit-packed codes
+//   depth, channel_id
+//   size, ts_in_delta                    narrowest byte width
+// Blocks carry zone maps so scans skip blocks that cannot match, and only
+// projected and predicate columns are decoded.
+//
+// The cache header records the source file's size, mtime and a hash of its
+// metadata block; open_or_build() rebuilds the cache when they change.
+class ColumnarCache {
+public:
+  explicit ColumnarCache(const std::string& cache_path);
+  ~ColumnarCache();
+
+  ColumnarCache(ColumnarCache&& other) noexcept;
+  ColumnarCache& operator=(ColumnarCache&&) = delete;
+  ColumnarCache(const ColumnarCache&) = delete;
+  ColumnarCache& operator=(const ColumnarCache&) = delete;
+
+  // Convert a DBN file into a cache file
+  static void build(const std::string& dbn_path, const std::string& cache_path,
+                    const ColumnarOptions& options = {});
+
+  // Open the cache for dbn_path, (re)building it first if missing or stale.
+  // An empty cache_path means "<dbn_path>.col".
+  static ColumnarCache open_or_build(const std::string& dbn_path,
+                                     const std::string& cache_path = "",
+                                     const ColumnarOptions& options = {});
+
+  // True if this cache was built from the current contents of dbn_path
+  bool is_current_for(const std::string& dbn_path) const;
+
+  uint64_t num_rows() const;
+  size_t num_blocks() const;
+  size_t file_size() const { return size_; }
+  ZoneMap zone_map(size_t block) const;
+
+  ScanStats scan(const ScanPredicate& predicate, ColumnMask projection,
+                 const std::function<void(const ColumnBatch&)>& callback) const;
+
+private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  std::string path_;
+
+  const uint8_t* block_meta(size_t block) const;
+};
+
+} // namespace databento
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "query.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace databento {
+
+// ============================================================================
+// CSV / JSON Export
+// ============================================================================
+
+enum class TextFormat : uint8_t {
+  Csv,          // Header line, then one comma-separated line per record
+  JsonLines,    // One JSON object per line
+};
+
+struct ExportOptions {
+  TextFormat format = TextFormat::Csv;
+  bool header = true;            // CSV column names (ignored for JSON)
+  // ts_event as ISO-8601 UTC with nanoseconds ("2024-01-01T00:00:00.000000000Z"),
+  // else integer nanoseconds
+  bool iso_timestamps = true;
+  // price as a decimal with 9 fractional digits, else the raw 1e-9 integer.
+  // JSON keeps decimal prices in strings so readers do not round them.
+  bool decimal_prices = true;
+  unsigned threads = 0;          // 0 = hardware concurrency
+  size_t chunk_records = 16384;  // Records encoded per thread between writes
+};
+
+// Worst-case encoded size of one record in either format
+inline constexpr size_t MAX_TEXT_RECORD_BYTES = 512;
+
+struct ExportStats {
+  uint64_t records = 0;
+  uint64_t bytes_written = 0;
+  unsigned threads = 0;
+  double elapsed_seconds = 0.0;
+
+  double megabytes_per_second() const {
+    return elapsed_seconds > 0 ? bytes_written / elapsed_seconds / 1e6 : 0.0;
+  }
+  void print() const;
+};
+
+// CSV header line including the newline (empty for JSON or header = false)
+std::string text_header(const ExportOptions& options);
+
+// Encode records (no header) into `out`, which must hold at least
+// records.count * MAX_TEXT_RECORD_BYTES bytes. Returns the bytes written.
+size_t encode_mbo_text(const query::RecordRange& records, const ExportOptions& options, char* out);
+
+// Write records as text to output_path. Threads encode consecutive chunks
+// into their own buffers and write them at their final offsets, so the
+// file is in record order. Throws std::runtime_error on I/O failure.
+ExportStats export_mbo_text(const query::RecordRange& records, const std::string& output_path,
+                            const ExportOptions& options = {});
+
+} // namespace databento
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace databento {
+
+// ============================================================================
+// Time-Window Extraction
+// ============================================================================
+
+// How the record bytes reached the output file
+enum class CopyMethod : uint8_t {
+  None,             // Nothing to copy
+  CopyFileRange,    // In-kernel; shares extents where the filesystem can reflink
+  Sendfile,         // In-kernel, page cache to page cache
+  ReadWrite,        // Through a user-space buffer
+};
+
+const char* copy_method_name(CopyMethod method);
+
+struct ExtractOptions {
+  // Try copy_file_range, then sendfile, before the user-space copy
+  bool kernel_copy = true;
+};
+
+struct ExtractResult {
+  uint64_t first_record = 0;       // Index in the input of the first record copied
+  uint64_t num_records = 0;
+  uint64_t bytes_copied = 0;       // Record bytes, excluding metadata
+  CopyMethod method = CopyMethod::None;
+};
+
+// Record indices [first, last) of a time-ordered DBN file whose ts_event
+// lies in [start_ts, end_ts). Binary search with one pread per probe; the
+// file is never loaded.
+struct RecordSpan {
+  uint64_t first = 0;
+  uint64_t last = 0;
+};
+RecordSpan find_time_range(const std::string& path, uint64_t start_ts, uint64_t end_ts);
+
+// Write a new DBN file holding the input's metadata block followed by the
+// records with ts_event in [start_ts, end_ts). Records are fixed-size and
+// contiguous, so the slice is one byte range, copied in-kernel when the
+// platform allows. Throws std::invalid_argument if start_ts > end_ts and
+// std::runtime_error on I/O failure.
+ExtractResult extract_time_range(const std::string& input_path, const std::string& output_path,
+                                 uint64_t start_ts, uint64_t end_ts,
+                                 const ExtractOptions& options = {});
+
+} // namespace databento
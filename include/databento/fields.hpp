@@ -0,0 +1,63 @@
+#pragma once
+
+#include "dbn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace databento {
+
+// ============================================================================
+// Compile-Time Field Descriptors
+// ============================================================================
+
+// FieldTraits<&MboMsg::price> describes one field of the packed 48-byte
+// MBO layout (TradeMsg shares it): its type, byte offset and name, and a
+// load() straight from a raw record. Records in a DBN buffer are unaligned,
+// so loads go through memcpy, which compiles to a single mov.
+template<auto Member>
+struct FieldTraits;
+
+namespace detail {
+
+template<typename T, size_t Offset>
+struct FieldTraitsBase {
+  using value_type = T;
+  static constexpr size_t offset = Offset;
+  static constexpr size_t size = sizeof(T);
+
+  static T load(const uint8_t* record) {
+    T value;
+    std::memcpy(&value, record + Offset, sizeof(T));
+    return value;
+  }
+};
+
+} // namespace detail
+
+#define DATABENTO_MBO_FIELD(member)                                                   \
+  template<>                                                                          \
+  struct FieldTraits<&MboMsg::member>                                                 \
+      : detail::FieldTraitsBase<decltype(MboMsg::member), offsetof(MboMsg, member)> { \
+    static constexpr const char* name = #member;                                      \
+  };
+
+DATABENTO_MBO_FIELD(ts_event)
+DATABENTO_MBO_FIELD(instrument_id)
+DATABENTO_MBO_FIELD(action)
+DATABENTO_MBO_FIELD(side)
+DATABENTO_MBO_FIELD(flags)
+DATABENTO_MBO_FIELD(depth)
+DATABENTO_MBO_FIELD(price)
+DATABENTO_MBO_FIELD(size)
+DATABENTO_MBO_FIELD(channel_id)
+DATABENTO_MBO_FIELD(order_id)
+DATABENTO_MBO_FIELD(sequence)
+DATABENTO_MBO_FIELD(ts_in_delta)
+
+#undef DATABENTO_MBO_FIELD
+
+static_assert(FieldTraits<&MboMsg::price>::offset == 16, "unexpected MBO layout");
+static_assert(FieldTraits<&MboMsg::ts_in_delta>::offset == 44, "unexpected MBO layout");
+
+} // namespace databento
@@ -0,0 +1,59 @@
+#pragma once
+
+// Internal helper shared by DbnParser::follow_mbo() and the coroutine
+// streams; not part of the public API.
+
+#include <string>
+
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace databento {
+namespace detail {
+
+// ============================================================================
+// File Growth Watch
+// ============================================================================
+
+// inotify watch for writes to one file, closed on destruction. fd stays -1
+// (callers fall back to polling) when inotify is off or unavailable.
+struct FileWatch {
+  int fd = -1;
+
+  FileWatch(const std::string& path, bool use_inotify) {
+#ifdef __linux__
+    if (use_inotify) {
+      fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      if (fd >= 0 && ::inotify_add_watch(fd, path.c_str(), IN_MODIFY) < 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+#else
+    (void)path;
+    (void)use_inotify;
+#endif
+  }
+  ~FileWatch() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+  FileWatch(const FileWatch&) = delete;
+  FileWatch& operator=(const FileWatch&) = delete;
+
+  // Queued events carry nothing we need; the file size is the truth
+  void drain() const {
+#ifdef __linux__
+    alignas(inotify_event) char events[4096];
+    while (::read(fd, events, sizeof(events)) > 0) {
+    }
+#endif
+  }
+};
+
+} // namespace detail
+} // namespace databento
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+// 64-bit finalizer from MurmurHash3: cheap and good enough to spread
+// sequential order/instrument IDs across a power-of-two table.
+inline uint64_t mix_hash(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+template<typename Key, typename = void>
+struct FlatHash;
+
+template<typename Key>
+struct FlatHash<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+  uint64_t operator()(Key key) const { return mix_hash(static_cast<uint64_t>(key)); }
+};
+
+// ============================================================================
+// Flat Open-Addressing Hash Map
+// ============================================================================
+
+// Linear-probing hash map storing keys and values inline in one array, for
+// hot paths keyed by order_id / instrument_id where std::unordered_map's
+// per-node allocation dominates. Erase uses backward-shift deletion, so
+// there are no tombstones and probe lengths stay short under churn.
+// Pointers returned by find()/try_emplace() are invalidated by insertion.
+template<typename Key, typename Value, typename Hash = FlatHash<Key>>
+class FlatHashMap {
+public:
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  explicit FlatHashMap(size_t initial_capacity = 16) {
+    rehash(round_up(initial_capacity));
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t capacity() const { return slots_.size(); }
+
+  void clear() {
+    std::fill(used_.begin(), used_.end(), uint8_t{0});
+    size_ = 0;
+  }
+
+  void reserve(size_t count) {
+    const size_t needed = round_up(count + count / 3 + 1);
+    if (needed > slots_.size()) {
+      rehash(needed);
+    }
+  }
+
+  Value* find(const Key& key) {
+    size_t i = index_for(key);
+    while (used_[i]) {
+      if (slots_[i].key == key) {
+        return &slots_[i].value;
+      }
+      i = (i + 1) & mask_;
+    }
+    return nullptr;
+  }
+
+  const Value* find(const Key& key) const {
+    return const_cast<FlatHashMap*>(this)->find(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != nullptr; }
+
+  // Returns the value for key, inserting `value` if absent
+  std::pair<Value*, bool> try_emplace(const Key& key, const Value& value = Value{}) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      rehash(slots_.size() * 2);
+    }
+    size_t i = index_for(key);
+    while (used_[i]) {
+      if (slots_[i].key == key) {
+        return {&slots_[i].value, false};
+      }
+      i = (i + 1) & mask_;
+    }
+    used_[i] = 1;
+    slots_[i].key = key;
+    slots_[i].value = value;
+    ++size_;
+    return {&slots_[i].value, true};
+  }
+
+  Value& operator[](const Key& key) { return *try_emplace(key).first; }
+
+  bool erase(const Key& key) {
+    size_t i = index_for(key);
+    while (used_[i]) {
+      if (slots_[i].key == key) {
+        break;
+      }
+      i = (i + 1) & mask_;
+    }
+    if (!used_[i]) {
+      return false;
+    }
+
+    // Backward-shift: pull later entries of the probe run into the hole
+    size_t hole = i;
+    size_t j = (i + 1) & mask_;
+    while (used_[j]) {
+      const size_t home = index_for(slots_[j].key);
+      if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+        slots_[hole] = std::move(slots_[j]);
+        hole = j;
+      }
+      j = (j + 1) & mask_;
+    }
+    used_[hole] = 0;
+    --size_;
+    return true;
+  }
+
+  // Visit every entry as fn(const Key&, Value&); order is unspecified
+  template<typename Fn>
+  void for_each(Fn&& fn) {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (used_[i]) {
+        fn(static_cast<const Key&>(slots_[i].key), slots_[i].value);
+      }
+    }
+  }
+
+  template<typename Fn>
+  void for_each(Fn&& fn) const {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (used_[i]) {
+        fn(slots_[i].key, slots_[i].value);
+      }
+    }
+  }
+
+private:
+  std::vector<Slot> slots_;
+  std::vector<uint8_t> used_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+  Hash hash_;
+
+  static size_t round_up(size_t n) {
+    size_t cap = 16;
+    while (cap < n) {
+      cap <<= 1;
+    }
+    return cap;
+  }
+
+  size_t index_for(const Key& key) const {
+    return static_cast<size_t>(hash_(key)) & mask_;
+  }
+
+  void rehash(size_t new_capacity) {
+    std::vector<Slot> old_slots(new_capacity);
+    std::vector<uint8_t> old_used(new_capacity, 0);
+    old_slots.swap(slots_);
+    old_used.swap(used_);
+    mask_ = new_capacity - 1;
+    size_ = 0;
+
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (old_used[i]) {
+        size_t j = index_for(old_slots[i].key);
+        while (used_[j]) {
+          j = (j + 1) & mask_;
+        }
+        used_[j] = 1;
+        slots_[j] = std::move(old_slots[i]);
+        ++size_;
+      }
+    }
+  }
+};
+
+} // namespace databento
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "dbn.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Synthetic MBO Data
+// ============================================================================
+
+// Relative weights of the events drawn for each record. A trade emits two
+// records: the aggressor 'T' followed by the resting order's 'F'.
+struct ActionMix {
+  double add = 0.42;
+  double cancel = 0.36;
+  double modify = 0.14;
+  double trade = 0.08;
+};
+
+struct GeneratorOptions {
+  uint64_t seed = 42;
+  uint64_t num_records = 10'000'000;
+
+  uint32_t num_instruments = 64;
+  uint32_t first_instrument_id = 1000;
+  double instrument_skew = 1.0;        // Zipf exponent over instruments; 0 = uniform
+  ActionMix action_mix;
+
+  uint64_t start_ts = 1'704'067'200'000'000'000ULL;  // 2024-01-01T00:00:00Z
+  uint64_t mean_gap_ns = 1000;         // Average spacing between records
+  double burst_probability = 0.002;    // Per-record chance of starting a burst
+  double burst_gap_scale = 0.02;       // Gap multiplier inside a burst
+  uint32_t mean_burst_length = 500;    // Records
+
+  int64_t tick_size = 250'000'000;     // 0.25 in 1e-9 units
+  uint32_t levels = 10;                // Orders rest up to this many ticks from the mid
+  uint32_t max_live_orders = 2000;     // Per instrument; adds become cancels above it
+  uint32_t channel_id = 0;
+
+  // Records are generated in independent chunks seeded from (seed, chunk),
+  // so output depends on seed and chunk_records but not on thread count
+  size_t chunk_records = size_t{1} << 20;
+  unsigned threads = 0;                // 0 = hardware concurrency
+};
+
+// Generate options.num_records records in memory
+std::vector<MboMsg> generate_mbo_records(const GeneratorOptions& options);
+
+// Write a DBN file (200-byte metadata block + records). Chunks are
+// generated in parallel and written with pwrite at their final offsets.
+void write_synthetic_dbn(const std::string& path, const GeneratorOptions& options);
+
+} // namespace databento
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+namespace databento {
+
+// ============================================================================
+// Positional File I/O Helpers
+// ============================================================================
+
+// pread/pwrite until every byte is transferred, retrying on EINTR. Offsets
+// are explicit, so threads can share one descriptor. path only feeds the
+// error message.
+inline void pread_all(int fd, void* data, size_t bytes, uint64_t offset, const std::string& path) {
+  auto* p = static_cast<uint8_t*>(data);
+  while (bytes > 0) {
+    const ssize_t n = ::pread(fd, p, bytes, static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw std::runtime_error("Failed to read file: " + path);
+    }
+    p += n;
+    bytes -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+inline void pwrite_all(int fd, const void* data, size_t bytes, uint64_t offset,
+                       const std::string& path) {
+  const auto* p = static_cast<const uint8_t*>(data);
+  while (bytes > 0) {
+    const ssize_t n = ::pwrite(fd, p, bytes, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to write file: " + path);
+    }
+    p += n;
+    bytes -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+} // namespace databento
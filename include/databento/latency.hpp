@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace databento {
+
+// ============================================================================
+// Latency Probes
+// ============================================================================
+
+// Callback timing in DbnParser and BatchProcessor is compiled in only when
+// DATABENTO_ENABLE_LATENCY_PROBES is defined (CMake: -DDATABENTO_LATENCY_PROBES=ON).
+// Otherwise an attached probe is ignored and the hot loops are unchanged.
+#ifdef DATABENTO_ENABLE_LATENCY_PROBES
+inline constexpr bool LATENCY_PROBES_ENABLED = true;
+#else
+inline constexpr bool LATENCY_PROBES_ENABLED = false;
+#endif
+
+// Timestamp counter: rdtsc on x86, steady_clock nanoseconds elsewhere.
+// Inline so a probe adds no call, via the compiler builtin so including
+// this header does not pull in <x86intrin.h>.
+inline uint64_t read_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Nanoseconds per read_tsc() tick, calibrated once against steady_clock
+double tsc_ns_per_tick();
+
+// ----------------------------------------------------------------------------
+// Histogram
+// ----------------------------------------------------------------------------
+
+// Log-linear (HDR-style) histogram over the full uint64_t range: values
+// below 64 are exact, larger values fall into 32 linear sub-buckets per
+// power of two (<= 3.1% relative error). All updates are relaxed atomics,
+// so several threads may record into one histogram without locking.
+class LatencyHistogram {
+public:
+  static constexpr unsigned SUB_BUCKET_BITS = 5;
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+  static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  LatencyHistogram() { reset(); }
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(uint64_t value) {
+    counts_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    uint64_t seen = min_.load(std::memory_order_relaxed);
+    while (value < seen && !min_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+    seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t min() const { return count() ? min_.load(std::memory_order_relaxed) : 0; }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+  double mean() const;
+
+  // Smallest bucket upper bound covering fraction p (0..1) of the values,
+  // clamped to max(); 0 when empty
+  uint64_t percentile(double p) const;
+
+  void merge(const LatencyHistogram& other);
+  void reset();
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < 2 * SUB_BUCKETS) {
+      return static_cast<size_t>(value);
+    }
+    const unsigned shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+  }
+
+  // Largest value mapped to bucket index
+  static uint64_t bucket_upper_bound(size_t index);
+
+private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> counts_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> min_;
+  std::atomic<uint64_t> max_;
+};
+
+// ----------------------------------------------------------------------------
+// Probe
+// ----------------------------------------------------------------------------
+
+struct LatencySummary {
+  uint64_t samples = 0;
+  double mean_ns = 0;
+  double p50_ns = 0;
+  double p90_ns = 0;
+  double p99_ns = 0;
+  double p999_ns = 0;
+  double max_ns = 0;
+};
+
+// Times one call in every sample_every (rounded up to a power of two) and
+// records the duration in read_tsc() ticks. Attach to a DbnParser or
+// BatchProcessor with set_latency_probe().
+class LatencyProbe {
+public:
+  explicit LatencyProbe(uint32_t sample_every = 1);
+
+  bool should_sample(uint64_t index) const { return (index & sample_mask_) == 0; }
+  void record_ticks(uint64_t ticks) { histogram_.record(ticks); }
+
+  uint32_t sample_every() const { return sample_mask_ + 1; }
+  const LatencyHistogram& histogram() const { return histogram_; }
+  void reset() { histogram_.reset(); }
+
+  double percentile_ns(double p) const {
+    return static_cast<double>(histogram_.percentile(p)) * tsc_ns_per_tick();
+  }
+  LatencySummary summary() const;
+  void print(const std::string& label) const;
+
+private:
+  uint32_t sample_mask_;
+  LatencyHistogram histogram_;
+};
+
+// Invoke fn(), timing it into probe when probes are compiled in, a probe is
+// attached and index falls on the sampling stride
+template <typename Fn>
+inline void probe_call(LatencyProbe* probe, uint64_t index, Fn&& fn) {
+#ifdef DATABENTO_ENABLE_LATENCY_PROBES
+  if (probe && probe->should_sample(index)) {
+    const uint64_t start = read_tsc();
+    fn();
+    probe->record_ticks(read_tsc() - start);
+    return;
+  }
+#else
+  (void)probe;
+  (void)index;
+#endif
+  fn();
+}
+
+} // namespace databento
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Multi-File Scan
+// ============================================================================
+
+struct MultiFileOptions {
+  // Files loaded on background threads ahead of the one being consumed
+  size_t prefetch_files = 1;
+  // Cap on file bytes held in memory at once (current file plus prefetched).
+  // A file that does not fit is only hinted to the kernel (WILLNEED).
+  size_t memory_budget = size_t{4} << 30;
+  // Drop each file's page cache once its bytes are in our buffer, so a long
+  // scan does not evict everything else; the buffer is released after use
+  bool drop_behind = true;
+  // Recycle parser buffers across files through a BufferPool, so each load
+  // lands on pages already faulted in by an earlier file
+  bool reuse_buffers = true;
+  HugePages huge_pages = HugePages::None;
+};
+
+struct MultiFileStats {
+  size_t files = 0;
+  uint64_t records = 0;
+  uint64_t bytes = 0;
+  size_t prefetched = 0;           // Files already loading when their turn came
+  double load_wait_seconds = 0.0;  // Time the consumer spent waiting for loads
+  double elapsed_seconds = 0.0;
+
+  void print() const;
+};
+
+// Scans a list of DBN files in order. While fn runs on file N, files N+1..
+// are read on background threads (within the memory budget), so I/O for
+// the next file overlaps compute on the current one.
+class MultiFileScan {
+public:
+  explicit MultiFileScan(std::vector<std::string> paths, const MultiFileOptions& options = {});
+
+  // Regular files in `directory` ending in `extension`, sorted by name
+  static std::vector<std::string> list_directory(const std::string& directory,
+                                                 const std::string& extension = ".dbn");
+
+  // fn(parser, file_index) once per file, parser already loaded. The
+  // parser is destroyed when fn returns. Exceptions from fn or a load
+  // propagate after in-flight loads finish.
+  MultiFileStats for_each_file(const std::function<void(DbnParser&, size_t)>& fn);
+
+  // Every MBO record of every file, in file order
+  MultiFileStats parse_mbo(const MboCallback& callback);
+
+  const std::vector<std::string>& paths() const { return paths_; }
+
+private:
+  std::vector<std::string> paths_;
+  MultiFileOptions options_;
+};
+
+} // namespace databento
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "query.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// NUMA Topology
+// ============================================================================
+
+struct NumaNode {
+  int id = 0;
+  std::vector<int> cpus;             // Only CPUs this process may run on
+};
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}; throws std::invalid_argument
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// Nodes with at least one usable CPU, read from sysfs (no libnuma needed).
+// Without sysfs, or on a single-node machine, returns one node 0 holding
+// every CPU in the process affinity mask.
+std::vector<NumaNode> numa_topology(const std::string& sysfs_root = "/sys/devices/system/node");
+
+// Restrict the calling thread to `cpus`; false if the OS refuses
+bool pin_current_thread(const std::vector<int>& cpus);
+
+// ============================================================================
+// NUMA-Aware Load and Scan
+// ============================================================================
+
+struct NumaOptions {
+  unsigned threads_per_node = 0;     // 0 = one per usable CPU on the node
+  bool pin_threads = true;
+  std::string sysfs_root = "/sys/devices/system/node";
+};
+
+struct NumaNodeStats {
+  int node = 0;
+  unsigned threads = 0;
+  uint64_t records = 0;
+  uint64_t bytes = 0;
+  double load_seconds = 0.0;         // Slowest thread on the node
+  double scan_seconds = 0.0;
+
+  double load_gbps() const { return load_seconds > 0 ? bytes / load_seconds / 1e9 : 0.0; }
+  double scan_gbps() const { return scan_seconds > 0 ? bytes / scan_seconds / 1e9 : 0.0; }
+};
+
+// A DBN file loaded so that each node's slice of the records lives in that
+// node's memory. Records are split into contiguous per-thread chunks, node
+// by node; each pinned thread reads its own chunk into an untouched
+// anonymous mapping, so first-touch places the pages locally, and later
+// scans hand every thread the same chunk it loaded.
+class NumaDbnFile {
+public:
+  explicit NumaDbnFile(const std::string& path, const NumaOptions& options = {});
+  ~NumaDbnFile();
+
+  NumaDbnFile(const NumaDbnFile&) = delete;
+  NumaDbnFile& operator=(const NumaDbnFile&) = delete;
+
+  // fn(thread, node_id, records) once per thread, on that thread, with its
+  // node-local chunk. Exceptions from fn are rethrown after all threads join.
+  void scan(const std::function<void(unsigned, int, const query::RecordRange&)>& fn);
+
+  // The whole file as one range (for consumers that are not NUMA-aware)
+  query::RecordRange records() const;
+
+  const std::vector<NumaNode>& nodes() const { return nodes_; }
+  const std::vector<NumaNodeStats>& node_stats() const { return node_stats_; }
+  unsigned num_threads() const { return static_cast<unsigned>(thread_node_.size()); }
+  size_t num_records() const { return num_records_; }
+
+  void print_stats() const;
+
+private:
+  NumaOptions options_;
+  std::vector<NumaNode> nodes_;
+  std::vector<size_t> thread_node_;  // Index into nodes_ per thread
+  std::vector<NumaNodeStats> node_stats_;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t mapped_size_ = 0;
+  size_t metadata_offset_ = 0;
+  size_t record_size_ = 0;
+  size_t num_records_ = 0;
+
+  // fn(thread) on num_threads() threads, each pinned to its node's CPUs
+  void run_pinned(const std::function<void(unsigned)>& fn);
+  std::pair<size_t, size_t> chunk(unsigned thread) const;
+};
+
+} // namespace databento
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "dbn.hpp"
+#include "flat_hash_map.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Resting Order State
+// ============================================================================
+
+struct RestingOrder {
+  uint64_t order_id;
+  uint32_t instrument_id;
+  char side;
+  int64_t price;
+  uint32_t size;
+  uint64_t priority;  // Time priority: lower is earlier in the queue
+};
+
+// Aggregate of all resting orders at one (instrument, side, price)
+struct LevelInfo {
+  uint64_t size;
+  uint32_t order_count;
+};
+
+struct LevelKey {
+  uint32_t instrument_id;
+  char side;
+  int64_t price;
+
+  bool operator==(const LevelKey& other) const {
+    return price == other.price && instrument_id == other.instrument_id &&
+           side == other.side;
+  }
+};
+
+template<>
+struct FlatHash<LevelKey> {
+  uint64_t operator()(const LevelKey& key) const {
+    return mix_hash(static_cast<uint64_t>(key.price) ^
+                    (static_cast<uint64_t>(key.instrument_id) << 8) ^
+                    static_cast<uint8_t>(key.side));
+  }
+};
+
+// ============================================================================
+// MBO Order Book
+// ============================================================================
+
+// Tracks every resting order across all instruments by replaying the
+// MboMsg add/cancel/modify/fill/clear stream, plus per-level aggregates.
+// Semantics follow the DBN MBO conventions:
+//   'A' adds an order; 'C' and 'F' reduce it by msg.size (removing it at
+//   zero); 'M' replaces price/size and loses priority when the price
+//   changes or the size increases; 'R' clears the instrument; 'T' is
+//   informational (the resting side is reported by the following 'F's).
+class OrderBook {
+public:
+  OrderBook() = default;
+
+  void apply(const MboMsg& msg);
+
+  const RestingOrder* find(uint64_t order_id) const { return orders_.find(order_id); }
+  LevelInfo level(uint32_t instrument_id, char side, int64_t price) const;
+
+  size_t order_count() const { return orders_.size(); }
+  size_t level_count() const { return levels_.size(); }
+
+  // Priority the next added (or re-queued) order will receive
+  uint64_t next_priority() const { return next_priority_; }
+
+  void clear();
+  void clear_instrument(uint32_t instrument_id);
+
+  // Insert a fully specified order (used when restoring snapshots)
+  void insert(const RestingOrder& order);
+  void set_next_priority(uint64_t priority) { next_priority_ = priority; }
+
+  template<typename Fn>
+  void for_each_order(Fn&& fn) const {
+    orders_.for_each([&](uint64_t, const RestingOrder& order) { fn(order); });
+  }
+
+private:
+  FlatHashMap<uint64_t, RestingOrder> orders_;
+  FlatHashMap<LevelKey, LevelInfo> levels_;
+  uint64_t next_priority_ = 0;
+
+  void add_to_level(const RestingOrder& order);
+  void remove_from_level(const RestingOrder& order, uint32_t size, bool last);
+  void reduce(uint64_t order_id, uint32_t size);
+};
+
+} // namespace databento
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Minimal Fork-Join Helpers
+// ============================================================================
+
+// 0 means "one thread per hardware thread"
+inline unsigned resolve_thread_count(unsigned requested) {
+  if (requested > 0) {
+    return requested;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Half-open range [first, second) of the index-th of `parts` equal chunks
+inline std::pair<size_t, size_t> chunk_range(size_t total, unsigned parts, unsigned index) {
+  const size_t begin = total * index / parts;
+  const size_t end = total * (index + 1) / parts;
+  return {begin, end};
+}
+
+// Run fn(thread_index) on `threads` threads (index 0 on the caller) and
+// join. The first exception thrown by any worker is rethrown here.
+template<typename Fn>
+void parallel_for(unsigned threads, Fn&& fn) {
+  if (threads <= 1) {
+    fn(0u);
+    return;
+  }
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto guarded = [&](unsigned t) {
+    try {
+      fn(t);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t) {
+    workers.emplace_back(guarded, t);
+  }
+  guarded(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace databento
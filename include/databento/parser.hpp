@@ -1,6 +1,13 @@
 #pragma once
 
+#include "buffer_pool.hpp"
 #include "dbn.hpp"
+#include "latency.hpp"
+#include "perf_counters.hpp"
+#include "records.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <string>
 #include <vector>
@@ -15,6 +22,21 @@ namespace databento {
 using MboCallback = std::function<void(const MboMsg&)>;
 using TradeCallback = std::function<void(const TradeMsg&)>;
 
+// ============================================================================
+// Follow Mode Options
+// ============================================================================
+
+struct FollowOptions {
+  // Wake on inotify events (Linux); otherwise poll the file size
+  bool use_inotify = true;
+  // Polling period, also the upper bound on stop_following() latency
+  std::chrono::microseconds poll_interval{200};
+  // Return from follow_mbo() after this long without growth (0 = never)
+  std::chrono::milliseconds idle_timeout{0};
+  // Skip records already in the file when following starts
+  bool start_at_end = false;
+};
+
 // ============================================================================
 // Fast DBN File Parser
 // ============================================================================
@@ -27,10 +49,51 @@ public:
   // Load file into memory (required before parsing)
   void load_into_memory();
 
+  // Point the parser at another file, keeping the loaded buffer's pages
+  // for the next load. Stops any follow mode on the current file.
+  void reset(const std::string& filepath);
+
+  // Borrow buffers from `pool` (nullptr for private mappings) when a load
+  // needs a new one; the buffer goes back to the pool when the parser is
+  // destroyed, so the pool must outlive the parser.
+  void set_buffer_pool(BufferPool* pool) { pool_ = pool; }
+
   // Parse entire file with callback
   void parse_mbo(MboCallback callback);
   void parse_trade(TradeCallback callback);
 
+  // Parse records [start_index, num_records()) with callback. If the file
+  // is not loaded, only records from start_index on are read (in chunks)
+  // and the parser stays unloaded.
+  void parse_mbo_from(size_t start_index, MboCallback callback);
+
+  // Tail-follow mode for files that are still being appended to.
+  // poll_mbo() grows the in-memory view to the current file size and
+  // delivers only records completed since the previous call; a partially
+  // written trailing record is held back until it is complete.
+  size_t poll_mbo(MboCallback callback);
+
+  // Like poll_mbo(), but returns up to max_records of the new records as a
+  // zero-copy view (valid until the next load or poll) instead of calling
+  // back; the file is only re-checked once earlier records are consumed.
+  RecordView<MboMsg> poll_mbo_batch(size_t max_records);
+
+  // Block, delivering new records as the file grows, until
+  // stop_following() is called (from any thread or from the callback)
+  // or the idle timeout expires.
+  void follow_mbo(MboCallback callback, const FollowOptions& options = {});
+  void stop_following() { stop_requested_.store(true, std::memory_order_relaxed); }
+
+  // Index of the next record follow/poll will deliver
+  size_t next_record() const { return next_record_; }
+
+  // Time sampled callbacks into probe (nullptr to detach). Only effective
+  // when built with DATABENTO_ENABLE_LATENCY_PROBES; the probe must outlive
+  // parsing.
+  void set_latency_probe(LatencyProbe* probe) { probe_ = probe; }
+
+  const std::string& filepath() const { return filepath_; }
+
   // Direct memory access (zero-copy, maximum performance)
   const uint8_t* data() const { return data_; }
   size_t size() const { return size_; }
@@ -44,6 +107,16 @@ public:
   // Get batch of records (zero-copy)
   const uint8_t* get_batch(size_t start_index, size_t count) const;
 
+  // Typed random-access view over every record (zero-copy, loads if
+  // needed). Invalidated by load_into_memory(), poll_mbo() and reset().
+  template<typename T>
+  RecordView<T> records() {
+    if (!data_) {
+      load_into_memory();
+    }
+    return RecordView<T>(data_ + metadata_offset_, num_records_, record_size_);
+  }
+
 private:
   std::string filepath_;
   const uint8_t* data_;
@@ -51,7 +124,20 @@ private:
   size_t metadata_offset_;
   size_t record_size_;
   size_t num_records_;
-  std::vector<uint8_t> buffer_;
+  PooledBuffer buffer_;
+  BufferPool* pool_;
+
+  // Follow mode state
+  int follow_fd_;
+  size_t next_record_;
+  std::atomic<bool> stop_requested_;
+
+  LatencyProbe* probe_;
+
+  void resize_buffer(size_t size);
+  void stream_mbo_from(size_t start_index, const MboCallback& callback);
+  bool grow_to_file_size();
+  size_t deliver_new_mbo(const MboCallback& callback, bool stoppable);
 };
 
 // ============================================================================
@@ -63,7 +149,7 @@ public:
   static constexpr size_t DEFAULT_BATCH_SIZE = 524288; // 512K records
 
   explicit BatchProcessor(size_t batch_size = DEFAULT_BATCH_SIZE)
-      : batch_size_(batch_size) {}
+      : batch_size_(batch_size), probe_(nullptr) {}
 
   // Process in batches
   template<typename RecordType, typename Callback>
@@ -82,24 +168,32 @@ public:
 
       const uint8_t* batch_data = parser.get_batch(i, batch_count);
       
-      for (size_t j = 0; j < batch_count; ++j) {
-        const uint8_t* record = batch_data + (j * rec_size);
-        if constexpr (std::is_same_v<RecordType, MboMsg>) {
-          batch.push_back(parse_mbo(record));
-        } else if constexpr (std::is_same_v<RecordType, TradeMsg>) {
-          batch.push_back(parse_trade(record));
+      {
+        TraceSpan span("decode_batch", "batch");
+        for (size_t j = 0; j < batch_count; ++j) {
+          const uint8_t* record = batch_data + (j * rec_size);
+          if constexpr (std::is_same_v<RecordType, MboMsg>) {
+            batch.push_back(parse_mbo(record));
+          } else if constexpr (std::is_same_v<RecordType, TradeMsg>) {
+            batch.push_back(parse_trade(record));
+          }
         }
       }
 
-      callback(batch);
+      TraceSpan span("batch_callback", "user");
+      probe_call(probe_, i / batch_size_, [&] { callback(batch); });
     }
   }
 
   void set_batch_size(size_t size) { batch_size_ = size; }
   size_t batch_size() const { return batch_size_; }
 
+  // Time sampled per-batch callbacks (see DbnParser::set_latency_probe)
+  void set_latency_probe(LatencyProbe* probe) { probe_ = probe; }
+
 private:
   size_t batch_size_;
+  LatencyProbe* probe_;
 };
 
 // ============================================================================
@@ -107,10 +201,21 @@ private:
 // ============================================================================
 
 struct ParseStats {
-  uint64_t total_records;
-  double elapsed_seconds;
-  double records_per_second;
-  double throughput_gbps;
+  uint64_t total_records = 0;
+  double elapsed_seconds = 0;
+  double records_per_second = 0;
+  double throughput_gbps = 0;
+
+  // Phase breakdown: reading the file vs. running the callbacks
+  double load_seconds = 0;
+  double parse_seconds = 0;
+
+  // perf_event counters per phase (NaN per-record metrics when the
+  // counters are unavailable or not requested)
+  bool counters_requested = false;
+  bool counters_available = false;
+  PhaseCounters load_counters;
+  PhaseCounters parse_counters;
 
   void print() const;
 };
@@ -119,7 +224,13 @@ struct ParseStats {
 // High-Level Utility Functions
 // ============================================================================
 
-ParseStats parse_file_mbo(const std::string& filepath, MboCallback callback);
-ParseStats parse_file_trade(const std::string& filepath, TradeCallback callback);
+// Parse a whole file, timing load and parse separately. With
+// hardware_counters (off by default: opening perf events costs a few
+// syscalls per call), cycles/instructions/LLC/dTLB misses and page faults
+// are also collected for each phase where the platform allows it.
+ParseStats parse_file_mbo(const std::string& filepath, MboCallback callback,
+                          bool hardware_counters = false);
+ParseStats parse_file_trade(const std::string& filepath, TradeCallback callback,
+                            bool hardware_counters = false);
 
 } // namespace databento
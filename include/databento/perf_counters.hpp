@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace databento {
+
+// ============================================================================
+// Hardware Performance Counters
+// ============================================================================
+
+enum class PerfEvent : uint32_t {
+  Cycles = 0,
+  Instructions,
+  LlcMisses,
+  DtlbMisses,
+  PageFaults,
+};
+
+constexpr size_t NUM_PERF_EVENTS = 5;
+
+// Counter totals for one measured phase. Events that could not be opened
+// (no PMU in a VM, perf_event_paranoid, non-Linux) are absent from
+// available_mask and read as zero.
+struct PerfSample {
+  std::array<uint64_t, NUM_PERF_EVENTS> values{};
+  uint32_t available_mask = 0;
+
+  bool has(PerfEvent e) const { return available_mask & (1u << static_cast<uint32_t>(e)); }
+  uint64_t get(PerfEvent e) const { return values[static_cast<size_t>(e)]; }
+
+  // Count divided by records; NaN if the event is unavailable or records is 0
+  double per_record(PerfEvent e, uint64_t records) const;
+};
+
+// perf_event_open counters for the calling thread, user space only. Each
+// event is opened separately so one unsupported event does not disable the
+// others; multiplexed counts are scaled by time enabled / time running.
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // True if at least one event is being counted
+  bool available() const { return available_mask_ != 0; }
+  uint32_t available_mask() const { return available_mask_; }
+
+  void start();        // Reset and enable
+  PerfSample stop();   // Disable and read
+
+private:
+  std::array<int, NUM_PERF_EVENTS> fds_;
+  uint32_t available_mask_ = 0;
+};
+
+// Derived per-record metrics of one phase, NaN where unavailable
+struct PhaseCounters {
+  static constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+  PerfSample sample;
+  double cycles_per_record = NaN;
+  double instructions_per_record = NaN;
+  double llc_misses_per_record = NaN;
+  double dtlb_misses_per_record = NaN;
+  double page_faults_per_record = NaN;
+
+  static PhaseCounters from(const PerfSample& sample, uint64_t records);
+};
+
+} // namespace databento
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "fields.hpp"
+#include "query.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace databento {
+
+// ============================================================================
+// Projected Scans
+// ============================================================================
+//
+//   scan<&MboMsg::ts_event, &MboMsg::instrument_id>(parser, [&](uint64_t ts, uint32_t id) {
+//     checksum ^= ts ^ id;
+//   });
+//
+//   scan_columns<&MboMsg::price, &MboMsg::size>(parser,
+//       [&](std::span<const int64_t> price, std::span<const uint32_t> size) {
+//         for (size_t i = 0; i < price.size(); ++i) notional += price[i] * size[i];
+//       });
+//
+// Only the listed fields are loaded, at the offsets FieldTraits fixes at
+// compile time, which replaces hand-written read_u64_le(record + 8) code.
+// scan() calls fn once per record. scan_columns() first copies blocks of
+// records into one array per field, so fn loops over contiguous columns
+// that the compiler can vectorize.
+
+inline constexpr size_t PROJECTION_BLOCK = 1024;  // Records per scan_columns() call
+
+namespace detail {
+
+// Stride 0 means the runtime stride. Otherwise it is a compile-time constant,
+// so the loads use fixed displacements.
+template<size_t Stride, auto... Members, typename Fn>
+void scan_rows(const uint8_t* data, size_t count, size_t stride, Fn& fn) {
+  const size_t step = Stride ? Stride : stride;
+#pragma GCC unroll 4
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t* record = data + i * step;
+    fn(FieldTraits<Members>::load(record)...);
+  }
+}
+
+template<size_t Stride, auto... Members, typename Fn, size_t... I>
+void scan_column_blocks(const uint8_t* data, size_t count, size_t stride, Fn& fn,
+                        std::index_sequence<I...>) {
+  const size_t step = Stride ? Stride : stride;
+  std::tuple<std::array<typename FieldTraits<Members>::value_type, PROJECTION_BLOCK>...> columns;
+  for (size_t begin = 0; begin < count; begin += PROJECTION_BLOCK) {
+    const size_t n = std::min(PROJECTION_BLOCK, count - begin);
+    const uint8_t* record = data + begin * step;
+    for (size_t j = 0; j < n; ++j, record += step) {
+      ((std::get<I>(columns)[j] = FieldTraits<Members>::load(record)), ...);
+    }
+    fn(std::span<const typename FieldTraits<Members>::value_type>(std::get<I>(columns).data(), n)...);
+  }
+}
+
+} // namespace detail
+
+// fn(field values...) for every record, in order
+template<auto... Members, typename Fn>
+void scan(const query::RecordRange& records, Fn&& fn) {
+  static_assert(sizeof...(Members) > 0, "scan needs at least one field");
+  if (records.stride == sizeof(MboMsg)) {
+    detail::scan_rows<sizeof(MboMsg), Members...>(records.data, records.count, 0, fn);
+  } else {
+    detail::scan_rows<0, Members...>(records.data, records.count, records.stride, fn);
+  }
+}
+
+// fn(std::span<const field type>...) for each block of up to
+// PROJECTION_BLOCK records, in order. The spans are only valid during the call.
+template<auto... Members, typename Fn>
+void scan_columns(const query::RecordRange& records, Fn&& fn) {
+  static_assert(sizeof...(Members) > 0, "scan_columns needs at least one field");
+  constexpr auto fields = std::index_sequence_for<decltype(Members)...>{};
+  if (records.stride == sizeof(MboMsg)) {
+    detail::scan_column_blocks<sizeof(MboMsg), Members...>(records.data, records.count, 0, fn, fields);
+  } else {
+    detail::scan_column_blocks<0, Members...>(records.data, records.count, records.stride, fn, fields);
+  }
+}
+
+} // namespace databento
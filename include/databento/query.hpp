@@ -0,0 +1,616 @@
+#pragma once
+
+#include "fields.hpp"
+#include "flat_hash_map.hpp"
+#include "parallel.hpp"
+#include "parser.hpp"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace databento {
+namespace query {
+
+// ============================================================================
+// Fused Filter / Project / Aggregate Queries
+// ============================================================================
+//
+//   using namespace databento::query;
+//   auto volume = where(instrument_id == 1234 && action == Action::Add)
+//                     .group_by(side)
+//                     .sum(size)
+//                     .run(parser);            // std::map<char, uint64_t>
+//
+//   auto [n, volume, high] = all().aggregate(count(), sum(size), max(price)).run(parser);
+//
+// Expressions are types, so each plan instantiates one loop that loads only
+// the referenced fields from the packed records. Predicates do not
+// short-circuit (&& is evaluated as &), keeping the loop branch-free.
+
+// ============================================================================
+// Record Source
+// ============================================================================
+
+// count MBO-layout records, stride bytes apart. Every consumer reads whole
+// MboMsg fields at each stride, so a shorter stride is rejected here.
+struct RecordRange {
+  const uint8_t* data = nullptr;
+  size_t count = 0;
+  size_t stride = sizeof(MboMsg);
+
+  RecordRange(const uint8_t* data_, size_t count_, size_t stride_ = sizeof(MboMsg))
+      : data(data_), count(count_), stride(stride_) {
+    check_stride();
+  }
+  RecordRange(const MboMsg* records, size_t count_)
+      : data(reinterpret_cast<const uint8_t*>(records)), count(count_) {}
+  RecordRange(const std::vector<MboMsg>& records)
+      : RecordRange(records.data(), records.size()) {}
+  RecordRange(DbnParser& parser) {
+    if (!parser.data()) {
+      parser.load_into_memory();
+    }
+    data = parser.data() + parser.metadata_offset();
+    count = parser.num_records();
+    stride = parser.record_size();
+    check_stride();
+  }
+
+private:
+  void check_stride() const {
+    if (stride < sizeof(MboMsg)) {
+      throw std::invalid_argument("Record stride smaller than an MBO record");
+    }
+  }
+};
+
+namespace detail {
+
+// fn(thread, begin, end) over contiguous chunks, one per thread
+template<typename Fn>
+unsigned for_each_chunk(const RecordRange& source, unsigned threads, Fn&& fn) {
+  const unsigned n = static_cast<unsigned>(
+      std::min<size_t>(resolve_thread_count(threads), std::max<size_t>(1, source.count)));
+  parallel_for(n, [&](unsigned t) {
+    const auto [begin, end] = chunk_range(source.count, n, t);
+    fn(t, begin, end);
+  });
+  return n;
+}
+
+} // namespace detail
+
+// ============================================================================
+// Expressions
+// ============================================================================
+
+// Every node has a value_type and eval(record)
+struct ExprBase {};
+
+template<typename T>
+inline constexpr bool is_expr_v = std::is_base_of_v<ExprBase, T>;
+
+template<auto Member>
+struct FieldExpr : ExprBase {
+  using traits = FieldTraits<Member>;
+  using value_type = typename traits::value_type;
+  value_type eval(const uint8_t* record) const { return traits::load(record); }
+};
+
+template<typename T>
+struct ConstExpr : ExprBase {
+  using value_type = T;
+  T value;
+  constexpr explicit ConstExpr(T v) : value(v) {}
+  T eval(const uint8_t*) const { return value; }
+};
+
+template<typename Op, typename L, typename R>
+struct BinaryExpr : ExprBase {
+  using value_type = decltype(Op::apply(std::declval<typename L::value_type>(),
+                                        std::declval<typename R::value_type>()));
+  L lhs;
+  R rhs;
+  constexpr BinaryExpr(L l, R r) : lhs(l), rhs(r) {}
+  value_type eval(const uint8_t* record) const {
+    return Op::apply(lhs.eval(record), rhs.eval(record));
+  }
+};
+
+template<typename E>
+struct NotExpr : ExprBase {
+  using value_type = bool;
+  E expr;
+  constexpr explicit NotExpr(E e) : expr(e) {}
+  bool eval(const uint8_t* record) const { return !static_cast<bool>(expr.eval(record)); }
+};
+
+// MBO fields
+inline constexpr FieldExpr<&MboMsg::ts_event> ts_event{};
+inline constexpr FieldExpr<&MboMsg::instrument_id> instrument_id{};
+inline constexpr FieldExpr<&MboMsg::action> action{};
+inline constexpr FieldExpr<&MboMsg::side> side{};
+inline constexpr FieldExpr<&MboMsg::flags> flags{};
+inline constexpr FieldExpr<&MboMsg::depth> depth{};
+inline constexpr FieldExpr<&MboMsg::price> price{};
+inline constexpr FieldExpr<&MboMsg::size> size{};
+inline constexpr FieldExpr<&MboMsg::channel_id> channel_id{};
+inline constexpr FieldExpr<&MboMsg::order_id> order_id{};
+inline constexpr FieldExpr<&MboMsg::sequence> sequence{};
+inline constexpr FieldExpr<&MboMsg::ts_in_delta> ts_in_delta{};
+
+// ----------------------------------------------------------------------------
+// Operators
+// ----------------------------------------------------------------------------
+
+namespace ops {
+
+// Small integers (char, bool, uint8_t) compare as int; mixed-sign integer
+// comparisons use std::cmp_* so `size > -1` means what it says
+template<typename T>
+constexpr auto promote(T v) {
+  if constexpr (std::is_integral_v<T> && sizeof(T) < sizeof(int)) {
+    return static_cast<int>(v);
+  } else {
+    return v;
+  }
+}
+
+#define DATABENTO_QUERY_COMPARE(Name, op, cmp)                                   \
+  struct Name {                                                                  \
+    template<typename A, typename B>                                             \
+    static bool apply(A a, B b) {                                                \
+      const auto x = promote(a);                                                 \
+      const auto y = promote(b);                                                 \
+      if constexpr (std::is_integral_v<decltype(x)> && std::is_integral_v<decltype(y)>) { \
+        return std::cmp(x, y);                                                   \
+      } else {                                                                   \
+        return x op y;                                                           \
+      }                                                                          \
+    }                                                                            \
+  };
+
+DATABENTO_QUERY_COMPARE(Eq, ==, cmp_equal)
+DATABENTO_QUERY_COMPARE(Ne, !=, cmp_not_equal)
+DATABENTO_QUERY_COMPARE(Lt, <, cmp_less)
+DATABENTO_QUERY_COMPARE(Le, <=, cmp_less_equal)
+DATABENTO_QUERY_COMPARE(Gt, >, cmp_greater)
+DATABENTO_QUERY_COMPARE(Ge, >=, cmp_greater_equal)
+
+#undef DATABENTO_QUERY_COMPARE
+
+struct And {
+  template<typename A, typename B>
+  static bool apply(A a, B b) { return static_cast<bool>(a) & static_cast<bool>(b); }
+};
+
+struct Or {
+  template<typename A, typename B>
+  static bool apply(A a, B b) { return static_cast<bool>(a) | static_cast<bool>(b); }
+};
+
+struct Add {
+  template<typename A, typename B>
+  static auto apply(A a, B b) { return a + b; }
+};
+
+struct Sub {
+  template<typename A, typename B>
+  static auto apply(A a, B b) { return a - b; }
+};
+
+struct Mul {
+  template<typename A, typename B>
+  static auto apply(A a, B b) { return a * b; }
+};
+
+} // namespace ops
+
+namespace detail {
+
+// Literals become constants; enums (Action, Side) their underlying char
+template<typename T>
+constexpr auto as_operand(const T& v) {
+  if constexpr (is_expr_v<T>) {
+    return v;
+  } else if constexpr (std::is_enum_v<T>) {
+    using U = std::underlying_type_t<T>;
+    return ConstExpr<U>(static_cast<U>(v));
+  } else {
+    static_assert(std::is_arithmetic_v<T>, "query operands must be expressions or numbers");
+    return ConstExpr<T>(v);
+  }
+}
+
+template<typename Op, typename L, typename R>
+constexpr auto make_binary(const L& l, const R& r) {
+  using LE = decltype(as_operand(l));
+  using RE = decltype(as_operand(r));
+  return BinaryExpr<Op, LE, RE>(as_operand(l), as_operand(r));
+}
+
+template<typename L, typename R>
+using enable_if_expr = std::enable_if_t<is_expr_v<L> || is_expr_v<R>, int>;
+
+} // namespace detail
+
+// Division is deliberately absent: operands are evaluated for every
+// record, including ones the predicate rejects, so x / size would trap
+#define DATABENTO_QUERY_OPERATOR(op, Op)                                       \
+  template<typename L, typename R, detail::enable_if_expr<L, R> = 0>           \
+  constexpr auto operator op(const L& l, const R& r) {                         \
+    return detail::make_binary<ops::Op>(l, r);                                 \
+  }
+
+DATABENTO_QUERY_OPERATOR(==, Eq)
+DATABENTO_QUERY_OPERATOR(!=, Ne)
+DATABENTO_QUERY_OPERATOR(<, Lt)
+DATABENTO_QUERY_OPERATOR(<=, Le)
+DATABENTO_QUERY_OPERATOR(>, Gt)
+DATABENTO_QUERY_OPERATOR(>=, Ge)
+DATABENTO_QUERY_OPERATOR(&&, And)
+DATABENTO_QUERY_OPERATOR(||, Or)
+DATABENTO_QUERY_OPERATOR(+, Add)
+DATABENTO_QUERY_OPERATOR(-, Sub)
+DATABENTO_QUERY_OPERATOR(*, Mul)
+
+#undef DATABENTO_QUERY_OPERATOR
+
+template<typename E, std::enable_if_t<is_expr_v<E>, int> = 0>
+constexpr auto operator!(const E& e) {
+  return NotExpr<E>(e);
+}
+
+// ============================================================================
+// Aggregates
+// ============================================================================
+
+// update(acc, record, match) must leave acc unchanged when match is false;
+// it is called for every record so the loop has no data-dependent branch
+
+template<typename T>
+using sum_type_t = std::conditional_t<
+    std::is_floating_point_v<T>, double,
+    std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+struct CountAgg {
+  using accumulator = uint64_t;
+  using result_type = uint64_t;
+  void update(accumulator& acc, const uint8_t*, bool match) const { acc += match; }
+  static void merge(accumulator& into, const accumulator& from) { into += from; }
+  static result_type result(const accumulator& acc) { return acc; }
+};
+
+template<typename E>
+struct SumAgg {
+  using accumulator = sum_type_t<typename E::value_type>;
+  using result_type = accumulator;
+  E expr;
+  void update(accumulator& acc, const uint8_t* record, bool match) const {
+    acc += match ? static_cast<accumulator>(expr.eval(record)) : accumulator{0};
+  }
+  static void merge(accumulator& into, const accumulator& from) { into += from; }
+  static result_type result(const accumulator& acc) { return acc; }
+};
+
+template<typename E>
+struct MeanAgg {
+  struct accumulator {
+    double sum = 0;
+    uint64_t count = 0;
+  };
+  using result_type = double;  // NaN when nothing matched
+  E expr;
+  void update(accumulator& acc, const uint8_t* record, bool match) const {
+    acc.sum += match ? static_cast<double>(expr.eval(record)) : 0.0;
+    acc.count += match;
+  }
+  static void merge(accumulator& into, const accumulator& from) {
+    into.sum += from.sum;
+    into.count += from.count;
+  }
+  static result_type result(const accumulator& acc) {
+    return acc.count ? acc.sum / static_cast<double>(acc.count)
+                     : std::numeric_limits<double>::quiet_NaN();
+  }
+};
+
+template<typename E, bool Min>
+struct ExtremumAgg {
+  using value_type = typename E::value_type;
+  struct accumulator {
+    value_type value = Min ? std::numeric_limits<value_type>::max()
+                           : std::numeric_limits<value_type>::lowest();
+    bool any = false;
+  };
+  using result_type = std::optional<value_type>;  // nullopt when nothing matched
+  E expr;
+  static bool better(value_type a, value_type b) { return Min ? a < b : a > b; }
+  void update(accumulator& acc, const uint8_t* record, bool match) const {
+    const value_type v = expr.eval(record);
+    acc.value = match && better(v, acc.value) ? v : acc.value;
+    acc.any |= match;
+  }
+  static void merge(accumulator& into, const accumulator& from) {
+    into.value = from.any && better(from.value, into.value) ? from.value : into.value;
+    into.any |= from.any;
+  }
+  static result_type result(const accumulator& acc) {
+    return acc.any ? result_type(acc.value) : std::nullopt;
+  }
+};
+
+// Several aggregates computed in the same pass; results come back as a tuple
+template<typename... Aggs>
+struct MultiAgg {
+  using accumulator = std::tuple<typename Aggs::accumulator...>;
+  using result_type = std::tuple<typename Aggs::result_type...>;
+  std::tuple<Aggs...> aggs;
+
+  void update(accumulator& acc, const uint8_t* record, bool match) const {
+    apply_each([&](const auto& agg, auto& a) { agg.update(a, record, match); }, acc);
+  }
+  static void merge(accumulator& into, const accumulator& from) {
+    merge_each(into, from, std::index_sequence_for<Aggs...>{});
+  }
+  static result_type result(const accumulator& acc) {
+    return result_each(acc, std::index_sequence_for<Aggs...>{});
+  }
+
+private:
+  template<typename Fn>
+  void apply_each(Fn&& fn, accumulator& acc) const {
+    apply_each_impl(fn, acc, std::index_sequence_for<Aggs...>{});
+  }
+  template<typename Fn, size_t... I>
+  void apply_each_impl(Fn& fn, accumulator& acc, std::index_sequence<I...>) const {
+    (fn(std::get<I>(aggs), std::get<I>(acc)), ...);
+  }
+  template<size_t... I>
+  static void merge_each(accumulator& into, const accumulator& from, std::index_sequence<I...>) {
+    (Aggs::merge(std::get<I>(into), std::get<I>(from)), ...);
+  }
+  template<size_t... I>
+  static result_type result_each(const accumulator& acc, std::index_sequence<I...>) {
+    return result_type(Aggs::result(std::get<I>(acc))...);
+  }
+};
+
+// Aggregate descriptors for aggregate(...)
+inline CountAgg count() { return CountAgg{}; }
+template<typename E>
+SumAgg<E> sum(E e) { return SumAgg<E>{e}; }
+template<typename E>
+MeanAgg<E> mean(E e) { return MeanAgg<E>{e}; }
+template<typename E>
+ExtremumAgg<E, true> min(E e) { return ExtremumAgg<E, true>{e}; }
+template<typename E>
+ExtremumAgg<E, false> max(E e) { return ExtremumAgg<E, false>{e}; }
+
+// ============================================================================
+// Plans
+// ============================================================================
+
+// One aggregate over all matching records. threads = 0 uses every core.
+template<typename Pred, typename Agg>
+class AggregatePlan {
+public:
+  AggregatePlan(Pred pred, Agg agg) : pred_(pred), agg_(agg) {}
+
+  typename Agg::result_type run(const RecordRange& source, unsigned threads = 1) const {
+    std::vector<typename Agg::accumulator> partials(resolve_thread_count(threads));
+    const unsigned used = detail::for_each_chunk(source, threads, [&](unsigned t, size_t begin,
+                                                                      size_t end) {
+      typename Agg::accumulator acc{};
+      const uint8_t* record = source.data + begin * source.stride;
+      for (size_t i = begin; i < end; ++i, record += source.stride) {
+        agg_.update(acc, record, static_cast<bool>(pred_.eval(record)));
+      }
+      partials[t] = acc;
+    });
+    for (unsigned t = 1; t < used; ++t) {
+      Agg::merge(partials[0], partials[t]);
+    }
+    return Agg::result(partials[0]);
+  }
+
+private:
+  Pred pred_;
+  Agg agg_;
+};
+
+// One aggregate per distinct key of matching records, ordered by key.
+// Single-byte keys (side, action, flags, ...) use a dense 256-entry table;
+// wider integer keys a flat hash map per thread.
+template<typename Pred, typename Key, typename Agg>
+class GroupPlan {
+public:
+  using key_type = typename Key::value_type;
+  using result_type = std::map<key_type, typename Agg::result_type>;
+
+  static_assert(std::is_integral_v<key_type>, "group_by keys must be integral");
+
+  GroupPlan(Pred pred, Key key, Agg agg) : pred_(pred), key_(key), agg_(agg) {}
+
+  result_type run(const RecordRange& source, unsigned threads = 1) const {
+    std::map<key_type, typename Agg::accumulator> merged;
+    if constexpr (sizeof(key_type) == 1) {
+      struct Dense {
+        std::array<typename Agg::accumulator, 256> acc{};
+        std::array<bool, 256> seen{};
+      };
+      std::vector<Dense> partials(resolve_thread_count(threads));
+      const unsigned used = detail::for_each_chunk(source, threads, [&](unsigned t, size_t begin,
+                                                                        size_t end) {
+        Dense& dense = partials[t];
+        const uint8_t* record = source.data + begin * source.stride;
+        for (size_t i = begin; i < end; ++i, record += source.stride) {
+          const auto k = static_cast<uint8_t>(key_.eval(record));
+          const bool match = static_cast<bool>(pred_.eval(record));
+          agg_.update(dense.acc[k], record, match);
+          dense.seen[k] |= match;
+        }
+      });
+      for (unsigned t = 0; t < used; ++t) {
+        for (size_t k = 0; k < 256; ++k) {
+          if (partials[t].seen[k]) {
+            Agg::merge(merged[static_cast<key_type>(k)], partials[t].acc[k]);
+          }
+        }
+      }
+    } else {
+      std::vector<FlatHashMap<key_type, typename Agg::accumulator>> partials(
+          resolve_thread_count(threads));
+      const unsigned used = detail::for_each_chunk(source, threads, [&](unsigned t, size_t begin,
+                                                                        size_t end) {
+        auto& map = partials[t];
+        const uint8_t* record = source.data + begin * source.stride;
+        for (size_t i = begin; i < end; ++i, record += source.stride) {
+          if (pred_.eval(record)) {
+            agg_.update(map[key_.eval(record)], record, true);
+          }
+        }
+      });
+      for (unsigned t = 0; t < used; ++t) {
+        partials[t].for_each([&](key_type k, const typename Agg::accumulator& acc) {
+          Agg::merge(merged[k], acc);
+        });
+      }
+    }
+
+    result_type result;
+    for (const auto& [k, acc] : merged) {
+      result.emplace_hint(result.end(), k, Agg::result(acc));
+    }
+    return result;
+  }
+
+private:
+  Pred pred_;
+  Key key_;
+  Agg agg_;
+};
+
+// Projected rows of matching records, in record order
+template<typename Pred, typename... E>
+class SelectPlan {
+public:
+  using row_type = std::tuple<typename E::value_type...>;
+
+  SelectPlan(Pred pred, E... exprs) : pred_(pred), exprs_(exprs...) {}
+
+  std::vector<row_type> run(const RecordRange& source, unsigned threads = 1) const {
+    std::vector<std::vector<row_type>> partials(resolve_thread_count(threads));
+    const unsigned used = detail::for_each_chunk(source, threads, [&](unsigned t, size_t begin,
+                                                                      size_t end) {
+      auto& rows = partials[t];
+      const uint8_t* record = source.data + begin * source.stride;
+      for (size_t i = begin; i < end; ++i, record += source.stride) {
+        if (pred_.eval(record)) {
+          std::apply([&](const auto&... e) { rows.emplace_back(e.eval(record)...); }, exprs_);
+        }
+      }
+    });
+    for (unsigned t = 1; t < used; ++t) {
+      partials[0].insert(partials[0].end(), partials[t].begin(), partials[t].end());
+    }
+    return std::move(partials[0]);
+  }
+
+private:
+  Pred pred_;
+  std::tuple<E...> exprs_;
+};
+
+// ============================================================================
+// Builders
+// ============================================================================
+
+template<typename Pred, typename Key>
+class GroupedQuery {
+public:
+  GroupedQuery(Pred pred, Key key) : pred_(pred), key_(key) {}
+
+  // e.g. aggregate(count(), sum(size), max(price)) -> map of tuples
+  template<typename... Aggs>
+  auto aggregate(Aggs... aggs) const {
+    using Multi = MultiAgg<Aggs...>;
+    return GroupPlan<Pred, Key, Multi>(pred_, key_, Multi{std::make_tuple(aggs...)});
+  }
+
+  auto count() const { return GroupPlan<Pred, Key, CountAgg>(pred_, key_, CountAgg{}); }
+  template<typename E>
+  auto sum(E e) const { return GroupPlan<Pred, Key, SumAgg<E>>(pred_, key_, SumAgg<E>{e}); }
+  template<typename E>
+  auto mean(E e) const { return GroupPlan<Pred, Key, MeanAgg<E>>(pred_, key_, MeanAgg<E>{e}); }
+  template<typename E>
+  auto min(E e) const {
+    return GroupPlan<Pred, Key, ExtremumAgg<E, true>>(pred_, key_, ExtremumAgg<E, true>{e});
+  }
+  template<typename E>
+  auto max(E e) const {
+    return GroupPlan<Pred, Key, ExtremumAgg<E, false>>(pred_, key_, ExtremumAgg<E, false>{e});
+  }
+
+private:
+  Pred pred_;
+  Key key_;
+};
+
+template<typename Pred>
+class Query {
+public:
+  explicit Query(Pred pred) : pred_(pred) {}
+
+  template<typename... Aggs>
+  auto aggregate(Aggs... aggs) const {
+    using Multi = MultiAgg<Aggs...>;
+    return AggregatePlan<Pred, Multi>(pred_, Multi{std::make_tuple(aggs...)});
+  }
+
+  auto count() const { return AggregatePlan<Pred, CountAgg>(pred_, CountAgg{}); }
+  template<typename E>
+  auto sum(E e) const { return AggregatePlan<Pred, SumAgg<E>>(pred_, SumAgg<E>{e}); }
+  template<typename E>
+  auto mean(E e) const { return AggregatePlan<Pred, MeanAgg<E>>(pred_, MeanAgg<E>{e}); }
+  template<typename E>
+  auto min(E e) const {
+    return AggregatePlan<Pred, ExtremumAgg<E, true>>(pred_, ExtremumAgg<E, true>{e});
+  }
+  template<typename E>
+  auto max(E e) const {
+    return AggregatePlan<Pred, ExtremumAgg<E, false>>(pred_, ExtremumAgg<E, false>{e});
+  }
+
+  template<typename... E>
+  auto select(E... exprs) const { return SelectPlan<Pred, E...>(pred_, exprs...); }
+
+  template<typename Key>
+  auto group_by(Key key) const {
+    static_assert(is_expr_v<Key>, "group_by expects a field expression");
+    return GroupedQuery<Pred, Key>(pred_, key);
+  }
+
+private:
+  Pred pred_;
+};
+
+template<typename Pred>
+Query<Pred> where(Pred pred) {
+  static_assert(is_expr_v<Pred>, "where expects a query expression");
+  return Query<Pred>(pred);
+}
+
+inline Query<ConstExpr<bool>> all() {
+  return Query<ConstExpr<bool>>(ConstExpr<bool>(true));
+}
+
+} // namespace query
+} // namespace databento
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "dbn.hpp"
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace databento {
+
+// ============================================================================
+// Typed Record View
+// ============================================================================
+//
+//   auto records = parser.records<MboMsg>();
+//   auto it = std::ranges::lower_bound(records, start_ns, {}, &MboMsg::ts_event);
+//   std::for_each(std::execution::par_unseq, records.begin(), records.end(), fn);
+//
+// Elements are references into the loaded buffer, not copies. That is only
+// sound for packed record structs (alignof 1), which every DBN struct is,
+// so any byte offset is a valid address for them.
+
+template<typename T>
+class RecordView : public std::ranges::view_interface<RecordView<T>> {
+  static_assert(std::is_trivially_copyable_v<T>, "records are read in place");
+  static_assert(alignof(T) == 1, "record structs must be #pragma pack(1)");
+
+public:
+  // Random access with a runtime stride, so record_size() may exceed sizeof(T)
+  class iterator {
+  public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    iterator() = default;
+    iterator(const uint8_t* record, size_t stride) : record_(record), stride_(stride) {}
+
+    reference operator*() const { return *reinterpret_cast<const T*>(record_); }
+    pointer operator->() const { return reinterpret_cast<const T*>(record_); }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    iterator& operator++() { record_ += stride_; return *this; }
+    iterator operator++(int) { iterator old = *this; ++*this; return old; }
+    iterator& operator--() { record_ -= stride_; return *this; }
+    iterator operator--(int) { iterator old = *this; --*this; return old; }
+
+    iterator& operator+=(difference_type n) {
+      record_ += n * static_cast<difference_type>(stride_);
+      return *this;
+    }
+    iterator& operator-=(difference_type n) { return *this += -n; }
+    friend iterator operator+(iterator it, difference_type n) { return it += n; }
+    friend iterator operator+(difference_type n, iterator it) { return it += n; }
+    friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const iterator& a, const iterator& b) {
+      return (a.record_ - b.record_) / static_cast<difference_type>(a.stride_);
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) { return a.record_ == b.record_; }
+    friend auto operator<=>(const iterator& a, const iterator& b) {
+      return std::compare_three_way{}(a.record_, b.record_);
+    }
+
+  private:
+    const uint8_t* record_ = nullptr;
+    size_t stride_ = sizeof(T);
+  };
+
+  RecordView() = default;
+  RecordView(const uint8_t* data, size_t count, size_t stride = sizeof(T))
+      : data_(data), count_(count), stride_(stride) {
+    if (stride < sizeof(T)) {
+      throw std::invalid_argument("RecordView: record stride is smaller than the record type");
+    }
+  }
+
+  iterator begin() const { return iterator(data_, stride_); }
+  iterator end() const { return iterator(data_ + count_ * stride_, stride_); }
+  size_t size() const { return count_; }
+  size_t stride() const { return stride_; }
+
+  // Unchecked, like std::span
+  const T& operator[](size_t index) const {
+    return *reinterpret_cast<const T*>(data_ + index * stride_);
+  }
+
+  // Records [offset, offset + count), unchecked like std::span::subspan
+  RecordView subview(size_t offset, size_t count) const {
+    return RecordView(data_ + offset * stride_, count, stride_);
+  }
+
+  // Records are back to back (stride == sizeof(T)); span() is then usable
+  bool contiguous() const { return stride_ == sizeof(T); }
+
+  // The same records as a contiguous range (plain pointers, which is what
+  // lets the compiler vectorize loops over them)
+  std::span<const T> span() const {
+    if (!contiguous()) {
+      throw std::logic_error("RecordView: records are not contiguous");
+    }
+    return {reinterpret_cast<const T*>(data_), count_};
+  }
+
+private:
+  const uint8_t* data_ = nullptr;
+  size_t count_ = 0;
+  size_t stride_ = sizeof(T);
+};
+
+static_assert(std::random_access_iterator<RecordView<MboMsg>::iterator>);
+static_assert(std::ranges::random_access_range<RecordView<MboMsg>>);
+static_assert(std::ranges::sized_range<RecordView<MboMsg>>);
+static_assert(std::ranges::view<RecordView<MboMsg>>);
+
+} // namespace databento
+
+template<typename T>
+inline constexpr bool std::ranges::enable_borrowed_range<databento::RecordView<T>> = true;
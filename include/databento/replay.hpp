@@ -0,0 +1,92 @@
+#pragma once
+
+#include "parser.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace databento {
+
+// ============================================================================
+// Pacing Error Histogram
+// ============================================================================
+
+// Log2-bucketed histogram of |delivery time - scheduled time| in ns.
+// Bucket 0 holds exact hits, bucket i holds errors in [2^(i-1), 2^i).
+class PacingHistogram {
+public:
+  static constexpr size_t NUM_BUCKETS = 40;
+
+  void record(int64_t error_ns);
+
+  uint64_t count() const { return count_; }
+  uint64_t early_count() const { return early_; }
+  uint64_t max_abs_ns() const { return max_abs_ns_; }
+  double mean_abs_ns() const { return count_ ? static_cast<double>(sum_abs_ns_) / count_ : 0.0; }
+
+  // Upper bound (ns) of the bucket containing the given percentile (0-100)
+  uint64_t percentile(double pct) const;
+
+  const std::array<uint64_t, NUM_BUCKETS>& buckets() const { return buckets_; }
+
+  void print() const;
+
+private:
+  std::array<uint64_t, NUM_BUCKETS> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t early_ = 0;
+  uint64_t max_abs_ns_ = 0;
+  uint64_t sum_abs_ns_ = 0;
+};
+
+// ============================================================================
+// Replay Engine
+// ============================================================================
+
+struct ReplayOptions {
+  // Playback rate relative to ts_event (1.0 = real time, 10.0 = 10x);
+  // 0 replays as fast as possible with no pacing
+  double speed = 1.0;
+  // Sleep until this close to a deadline, then busy-spin on the clock
+  std::chrono::nanoseconds spin_threshold{100'000};
+  // Deliver through an SPSC queue to a dedicated consumer thread
+  bool threaded = false;
+  size_t queue_capacity = 65536;
+};
+
+struct ReplayStats {
+  uint64_t total_records = 0;
+  double elapsed_seconds = 0.0;
+  double data_span_seconds = 0.0;  // Last ts_event - first ts_event
+  PacingHistogram pacing_error;    // Empty when speed == 0
+
+  void print() const;
+};
+
+// Replays MBO records from a DbnParser, preserving the inter-arrival gaps
+// of ts_event scaled by the configured speed. Deadlines are measured on
+// std::chrono::steady_clock from the moment replay starts and are absolute
+// (start + offset / speed), so after a slow callback the overdue records are
+// delivered back to back until the schedule is caught up: lateness shows up
+// in the histogram and as a burst, and the original gaps are not kept.
+class ReplayEngine {
+public:
+  explicit ReplayEngine(const ReplayOptions& options = {}) : options_(options) {}
+
+  ReplayStats replay_mbo(DbnParser& parser, MboCallback callback);
+
+  // Request early termination (safe from any thread or the callback)
+  void stop() { stop_requested_.store(true, std::memory_order_relaxed); }
+
+  const ReplayOptions& options() const { return options_; }
+
+private:
+  ReplayOptions options_;
+  std::atomic<bool> stop_requested_{false};
+
+  ReplayStats replay_inline(DbnParser& parser, const MboCallback& callback);
+  ReplayStats replay_threaded(DbnParser& parser, const MboCallback& callback);
+};
+
+} // namespace databento
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "aggregate.hpp"
+#include "dbn.hpp"
+#include "flat_hash_map.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Rolling-Window Statistics
+// ============================================================================
+
+// Trade statistics over (now - window_ns, now]. All sums are integers, so
+// values after any number of evictions equal a fresh recomputation.
+struct WindowStats {
+  uint64_t window_ns = 0;
+  uint64_t trades = 0;
+  uint64_t volume = 0;
+  uint64_t buy_volume = 0;                       // Aggressor side 'B'
+  uint64_t sell_volume = 0;                      // Aggressor side 'A'
+  int128_t notional = 0;                         // sum(price * size), 1e-9 units
+  int64_t min_price = INT64_MAX;                 // INT64_MAX / INT64_MIN when no trades
+  int64_t max_price = INT64_MIN;
+
+  // Trade-to-trade price changes ending inside the window, 1e-9 units
+  uint64_t changes = 0;
+  int128_t sum_change = 0;
+  int128_t sum_change_sq = 0;
+
+  int64_t vwap_fixed() const { return databento::vwap_fixed(notional, volume); }
+  double vwap() const { return price_to_double(vwap_fixed()); }
+  // Sample standard deviation of price changes, in price units; 0 below 2 changes
+  double volatility() const;
+  // (buy - sell) / (buy + sell) aggressor volume, in [-1, 1]; 0 when no volume
+  double imbalance() const;
+
+  bool operator==(const WindowStats& other) const = default;
+};
+
+struct RollingOptions {
+  // Window lengths in ns; every instrument tracks all of them
+  std::vector<uint64_t> windows_ns = {100'000'000, 1'000'000'000, 60'000'000'000,
+                                      300'000'000'000};
+  std::string trade_actions = "T";
+};
+
+// Incremental per-instrument windows driven by ts_event. Each trade is
+// stored once per instrument; every window keeps a head index into that
+// history, running sums, and monotonic deques for min/max price, so an
+// update costs O(1) amortized per window. Feed records in time order from
+// a parse_mbo or batch callback; a timestamp earlier than the instrument's
+// last one is treated as equal to it.
+class RollingWindows {
+public:
+  explicit RollingWindows(const RollingOptions& options = {});
+
+  void add(const MboMsg& msg);
+  void add(const std::vector<MboMsg>& batch);
+
+  // Stats of windows_ns[window] ending at now() (the latest ts_event fed),
+  // or at `now`. Evicts lazily up to min(now, now()), hence non-const; a
+  // `now` past now() is answered from a copy, so later records older than
+  // it still count. Eviction is permanent, so per instrument queries must
+  // not go back in time: throws std::invalid_argument when `now` is before
+  // the instrument's last trade or an earlier query's eviction point (the
+  // no-argument overload evicts to now()), and std::out_of_range for a bad
+  // window index. Unknown instruments give empty stats.
+  WindowStats stats(uint32_t instrument_id, size_t window);
+  WindowStats stats(uint32_t instrument_id, size_t window, uint64_t now);
+
+  uint64_t now() const { return now_; }
+  size_t num_windows() const { return windows_ns_.size(); }
+  std::vector<uint32_t> instruments() const;  // Those with a trade, sorted
+
+private:
+  struct Trade {
+    uint64_t ts;
+    int64_t price;
+    uint32_t size;
+    char side;
+    bool has_change;
+    int64_t change;
+  };
+
+  struct Window {
+    WindowStats stats;
+    uint64_t head = 0;                 // Sequence number of the oldest trade inside
+    std::deque<uint64_t> min_seq;      // Increasing prices
+    std::deque<uint64_t> max_seq;      // Decreasing prices
+  };
+
+  struct Instrument {
+    std::deque<Trade> trades;          // Sequence numbers [base, base + size)
+    uint64_t base = 0;
+    uint64_t last_ts = 0;
+    uint64_t evicted_to = 0;           // Latest time windows were evicted to
+    bool has_trade = false;
+    int64_t last_price = 0;
+    std::vector<Window> windows;
+  };
+
+  std::vector<uint64_t> windows_ns_;
+  std::array<uint8_t, 256> is_trade_action_{};
+  FlatHashMap<uint32_t, uint32_t> index_;
+  std::vector<uint32_t> ids_;
+  std::vector<Instrument> instruments_;
+  uint64_t now_ = 0;
+
+  const Trade& trade_at(const Instrument& inst, uint64_t seq) const {
+    return inst.trades[static_cast<size_t>(seq - inst.base)];
+  }
+  void push(Instrument& inst, const Trade& trade);
+  static void remove_trade(WindowStats& s, const Trade& trade);
+  void evict(Instrument& inst, uint64_t now);
+  WindowStats stats_at(const Instrument& inst, size_t window, uint64_t now) const;
+};
+
+} // namespace databento
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "dbn.hpp"
+#include "flat_hash_map.hpp"
+#include "query.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Quantile Sketch (KLL)
+// ============================================================================
+
+// Karnin-Lang-Liberty compactor sketch. Level h holds items of weight 2^h;
+// a full level is sorted and every other item (random offset) promoted.
+// Retains about 3k items regardless of stream length; rank error is
+// roughly 1.7 / k (k = 200 -> under 1%). Mergeable, so chunks can be
+// sketched in parallel. The compaction coin is a seeded PRNG, so the same
+// input and seed always give the same sketch.
+class KllSketch {
+public:
+  explicit KllSketch(uint32_t k = 200, uint64_t seed = 1);
+
+  void update(double value);
+  void merge(const KllSketch& other);
+
+  uint64_t count() const { return n_; }
+  bool empty() const { return n_ == 0; }
+  double min() const { return min_; }
+  double max() const { return max_; }
+
+  // Value at fraction q (0..1) of the distribution; NaN when empty
+  double quantile(double q) const;
+  // Estimated fraction of values <= value
+  double rank(double value) const;
+
+  size_t retained() const { return retained_; }
+
+private:
+  uint32_t k_;
+  uint64_t n_ = 0;
+  double min_;
+  double max_;
+  uint64_t rng_;
+  size_t retained_ = 0;
+  std::vector<std::vector<double>> levels_;
+  std::vector<size_t> capacities_;   // Per level; recomputed when a level is added
+  size_t total_capacity_ = 0;
+
+  void add_level();
+  void compress();
+  void compact(size_t level);
+};
+
+// ============================================================================
+// Cardinality Sketch (HyperLogLog)
+// ============================================================================
+
+// 2^precision one-byte registers (precision 12: 4 KB, ~1.6% standard
+// error), with linear counting for small cardinalities. Merge is a
+// register-wise max, so parallel chunks combine exactly.
+class HyperLogLog {
+public:
+  explicit HyperLogLog(uint8_t precision = 12);
+
+  void add(uint64_t key) { add_hash(mix_hash(key)); }
+  void add_hash(uint64_t hash) {
+    const size_t index = static_cast<size_t>(hash >> (64 - precision_));
+    const uint64_t rest = (hash << precision_) | (uint64_t{1} << (precision_ - 1));
+    const auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    registers_[index] = rank > registers_[index] ? rank : registers_[index];
+  }
+
+  void merge(const HyperLogLog& other);
+  double estimate() const;
+
+  uint8_t precision() const { return precision_; }
+
+private:
+  uint8_t precision_;
+  std::vector<uint8_t> registers_;
+};
+
+// ============================================================================
+// Per-Instrument Sketches
+// ============================================================================
+
+struct SketchOptions {
+  uint32_t kll_k = 200;
+  uint8_t hll_precision = 12;
+  std::string size_actions = "A";    // Records whose size feeds size quantiles
+  std::string trade_actions = "T";   // Consecutive prices feed price-change quantiles
+  uint64_t seed = 1;
+  unsigned threads = 0;              // sketch_by_instrument only; 0 = hardware concurrency
+};
+
+struct InstrumentSketch {
+  KllSketch sizes;
+  KllSketch price_changes;           // Trade-to-trade price change, 1e-9 units
+  HyperLogLog order_ids;             // Distinct non-zero order_ids
+
+  // First/last trade seen, to join price changes across merged chunks
+  bool has_trade = false;
+  int64_t first_trade_price = 0;
+  int64_t last_trade_price = 0;
+
+  explicit InstrumentSketch(const SketchOptions& options, uint32_t instrument_id);
+};
+
+// Sketches keyed by instrument_id. Feed records in order with add() (e.g.
+// from a parse_mbo or batch callback); merge() expects `later` to cover
+// records that come after this one's, so trade-to-trade changes spanning
+// the boundary are kept.
+class InstrumentSketches {
+public:
+  explicit InstrumentSketches(const SketchOptions& options = {});
+
+  void add(const MboMsg& msg);
+  void add(const std::vector<MboMsg>& batch);
+  void merge(const InstrumentSketches& later);
+
+  const InstrumentSketch* find(uint32_t instrument_id) const;
+  std::vector<uint32_t> instruments() const;  // Sorted
+  size_t size() const { return sketches_.size(); }
+
+private:
+  SketchOptions options_;
+  std::array<uint8_t, 256> is_size_action_{};
+  std::array<uint8_t, 256> is_trade_action_{};
+  FlatHashMap<uint32_t, uint32_t> index_;
+  std::vector<uint32_t> ids_;
+  std::vector<InstrumentSketch> sketches_;
+
+  InstrumentSketch& sketch_for(uint32_t instrument_id);
+};
+
+// Sketch a whole buffer, contiguous chunks in parallel merged in order
+InstrumentSketches sketch_by_instrument(const query::RecordRange& records,
+                                        const SketchOptions& options = {});
+
+} // namespace databento
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "parser.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace databento {
+
+// ============================================================================
+// Record Sorting
+// ============================================================================
+
+enum class SortKey : uint8_t {
+  TimeSequence,     // (ts_event, sequence): restore time order across channels
+  InstrumentTime,   // (instrument_id, ts_event): cluster per-symbol
+};
+
+struct SortOptions {
+  SortKey key = SortKey::TimeSequence;
+  unsigned threads = 0;                         // 0 = hardware concurrency
+  size_t memory_budget = size_t{1} << 30;       // Above this, sort_file spills runs
+  std::string temp_dir = "/tmp";                // Where spilled runs are written
+};
+
+// All sorts are stable LSD radix sorts over the composite key, one byte per
+// pass. Each pass builds per-thread histograms, turns them into per-thread
+// scatter offsets and scatters in parallel; passes over bytes that are equal
+// for every record are skipped, so narrow key ranges sort in a few passes.
+
+// Permutation that orders the parser's records by key (zero-copy; only
+// 4-byte indices move). Requires fewer than 2^32 records.
+std::vector<uint32_t> sort_record_indices(DbnParser& parser, const SortOptions& options = {});
+
+// Sort a buffer of MboMsg-layout records. Uses a scratch buffer the size of
+// the input.
+void sort_records_in_place(uint8_t* records, size_t count, const SortOptions& options = {});
+
+// Write the parser's metadata block followed by its records in `order`
+void write_records_in_order(DbnParser& parser, const std::vector<uint32_t>& order,
+                            const std::string& output_path);
+
+// Sort a whole DBN file into a new file. Files that fit in the memory
+// budget are sorted in memory; larger files are split into sorted runs on
+// disk and k-way merged, so peak memory stays within the budget.
+void sort_file(const std::string& input_path, const std::string& output_path,
+               const SortOptions& options = {});
+
+} // namespace databento
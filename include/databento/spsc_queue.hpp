@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace databento {
+
+// ============================================================================
+// Single-Producer Single-Consumer Ring Buffer
+// ============================================================================
+
+// Lock-free bounded queue for handing records between exactly two threads.
+// Capacity is rounded up to a power of two; head and tail live on separate
+// cache lines and each side caches the other's index to avoid ping-pong.
+template<typename T>
+class SpscQueue {
+public:
+  explicit SpscQueue(size_t capacity) {
+    if (capacity < 2) {
+      throw std::invalid_argument("SpscQueue capacity must be at least 2");
+    }
+    size_t cap = 1;
+    while (cap < capacity) {
+      cap <<= 1;
+    }
+    mask_ = cap - 1;
+    slots_ = std::make_unique<T[]>(cap);
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer side
+  bool try_push(const T& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool try_pop(T& out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    out = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+private:
+  static constexpr size_t CACHE_LINE = 64;
+
+  std::unique_ptr<T[]> slots_;
+  size_t mask_;
+
+  alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;  // Consumer's view of tail_
+
+  alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;  // Producer's view of head_
+};
+
+} // namespace databento
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace databento {
+
+// ============================================================================
+// Pipeline Tracing (Chrome / Perfetto trace format)
+// ============================================================================
+
+// Spans are recorded into per-thread buffers (single writer, no locks on
+// the hot path) and exported as Chrome trace JSON, viewable in
+// chrome://tracing or ui.perfetto.dev. While tracing is disabled a span
+// costs one relaxed load and a predictable branch.
+//
+// A buffer is returned to a free list when its thread exits and reused by
+// the next new thread, so short-lived worker pools share a few tracks and
+// memory stays bounded. Events past a buffer's capacity are dropped and
+// counted.
+
+constexpr size_t TRACE_DEFAULT_EVENTS_PER_THREAD = size_t{1} << 16;
+
+namespace detail {
+extern std::atomic<bool> trace_enabled_flag;
+void trace_record(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns);
+} // namespace detail
+
+inline bool trace_enabled() {
+  return detail::trace_enabled_flag.load(std::memory_order_relaxed);
+}
+
+inline uint64_t trace_now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// events_per_thread applies to buffers created after the call
+void trace_enable(size_t events_per_thread = TRACE_DEFAULT_EVENTS_PER_THREAD);
+void trace_disable();
+
+// Discard recorded events; call while no traced work is running
+void trace_clear();
+
+// Label the calling thread's track in the exported trace
+void trace_set_thread_name(const std::string& name);
+
+size_t trace_event_count();
+uint64_t trace_dropped_events();
+
+// Export everything recorded so far. Safe to call while other threads are
+// still recording; their in-flight spans are simply not included.
+std::string trace_chrome_json();
+void trace_write_chrome_json(const std::string& path);
+
+// Scoped begin/end span. name and category must outlive the export
+// (string literals in practice).
+class TraceSpan {
+public:
+  explicit TraceSpan(const char* name, const char* category = "databento")
+      : name_(name), category_(category), start_ns_(trace_enabled() ? trace_now_ns() : 0) {}
+
+  ~TraceSpan() {
+    if (start_ns_ != 0) {
+      detail::trace_record(name_, category_, start_ns_, trace_now_ns());
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+  const char* name_;
+  const char* category_;
+  uint64_t start_ns_;
+};
+
+} // namespace databento
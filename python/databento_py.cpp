@@ -78,11 +78,29 @@ PYBIND11_MODULE(databento_cpp, m) {
   // ParseStats struct
   // ============================================================================
   
+  py::class_<databento::PhaseCounters>(m, "PhaseCounters")
+    .def_readonly("cycles_per_record", &databento::PhaseCounters::cycles_per_record)
+    .def_readonly("instructions_per_record", &databento::PhaseCounters::instructions_per_record)
+    .def_readonly("llc_misses_per_record", &databento::PhaseCounters::llc_misses_per_record)
+    .def_readonly("dtlb_misses_per_record", &databento::PhaseCounters::dtlb_misses_per_record)
+    .def_readonly("page_faults_per_record", &databento::PhaseCounters::page_faults_per_record)
+    .def("__repr__", [](const databento::PhaseCounters& c) {
+      return "<PhaseCounters cycles/rec=" + std::to_string(c.cycles_per_record) +
+             " llc_misses/rec=" + std::to_string(c.llc_misses_per_record) +
+             " page_faults/rec=" + std::to_string(c.page_faults_per_record) + ">";
+    });
+
   py::class_<databento::ParseStats>(m, "ParseStats")
     .def_readonly("total_records", &databento::ParseStats::total_records)
     .def_readonly("elapsed_seconds", &databento::ParseStats::elapsed_seconds)
     .def_readonly("records_per_second", &databento::ParseStats::records_per_second)
     .def_readonly("throughput_gbps", &databento::ParseStats::throughput_gbps)
+    .def_readonly("load_seconds", &databento::ParseStats::load_seconds)
+    .def_readonly("parse_seconds", &databento::ParseStats::parse_seconds)
+    .def_readonly("counters_requested", &databento::ParseStats::counters_requested)
+    .def_readonly("counters_available", &databento::ParseStats::counters_available)
+    .def_readonly("load_counters", &databento::ParseStats::load_counters)
+    .def_readonly("parse_counters", &databento::ParseStats::parse_counters)
     .def("print", &databento::ParseStats::print)
     .def("__repr__", [](const databento::ParseStats& s) {
       return "<ParseStats records=" + std::to_string(s.total_records) +
@@ -154,15 +172,16 @@ PYBIND11_MODULE(databento_cpp, m) {
   // ============================================================================
   
   m.def("parse_file_mbo", 
-    [](const std::string& filepath, py::function callback) {
+    [](const std::string& filepath, py::function callback, bool hardware_counters) {
       auto cpp_callback = [&callback](const databento::MboMsg& msg) {
         callback(msg);
       };
-      return databento::parse_file_mbo(filepath, cpp_callback);
+      return databento::parse_file_mbo(filepath, cpp_callback, hardware_counters);
     },
     py::arg("filepath"),
     py::arg("callback"),
-    "Parse MBO file with callback function");
+    py::arg("hardware_counters") = false,
+    "Parse MBO file with callback function (hardware_counters: collect perf counters per phase)");
 
   m.def("parse_file_mbo_fast", 
     [](const std::string& filepath) {
@@ -25,7 +25,8 @@ here = os.path.abspath(os.path.dirname(__file__))
 ext_modules = [
     Pybind11Extension(
         "databento_cpp",
-        ["python/databento_py.cpp", "src/parser.cpp"],
+        ["python/databento_py.cpp", "src/parser.cpp", "src/perf_counters.cpp", "src/latency.cpp", "src/trace.cpp",
+         "src/buffer_pool.cpp"],
         include_dirs=[os.path.join(here, "include")],
         extra_compile_args=["-O3", "-march=native", "-std=c++20"],
         cxx_std=20,
@@ -0,0 +1,136 @@
+#include "databento/aggregate.hpp"
+#include "databento/flat_hash_map.hpp"
+#include "databento/parallel.hpp"
+#include <algorithm>
+
+namespace databento {
+
+namespace {
+
+// Per-action flags looked up once per record: slot index and whether the
+// record contributes to volume
+struct ActionTable {
+  std::array<uint8_t, 256> slot{};
+  std::array<uint8_t, 256> is_volume{};
+
+  explicit ActionTable(const std::string& volume_actions) {
+    for (size_t c = 0; c < 256; ++c) {
+      slot[c] = static_cast<uint8_t>(action_slot(static_cast<char>(c)));
+    }
+    for (char c : volume_actions) {
+      is_volume[static_cast<uint8_t>(c)] = 1;
+    }
+  }
+};
+
+void merge_into(InstrumentStats& into, const InstrumentStats& from) {
+  into.records += from.records;
+  for (size_t s = 0; s < NUM_ACTION_SLOTS; ++s) {
+    into.action_counts[s] += from.action_counts[s];
+  }
+  into.volume += from.volume;
+  into.notional += from.notional;
+  into.min_price = std::min(into.min_price, from.min_price);
+  into.max_price = std::max(into.max_price, from.max_price);
+}
+
+} // namespace
+
+// ============================================================================
+// Fixed-Point Helpers
+// ============================================================================
+
+int64_t vwap_fixed(int128_t notional, uint64_t volume) {
+  if (volume == 0) {
+    return 0;
+  }
+  const int128_t v = static_cast<int128_t>(volume);
+  const int128_t half = v / 2;
+  const int128_t rounded = notional >= 0 ? (notional + half) / v : (notional - half) / v;
+  return static_cast<int64_t>(rounded);
+}
+
+std::string int128_to_string(int128_t value) {
+  if (value == 0) {
+    return "0";
+  }
+  const bool negative = value < 0;
+  // Work in unsigned so the most negative value does not overflow
+  __extension__ unsigned __int128 magnitude =
+      negative ? -static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+  std::string digits;
+  while (magnitude > 0) {
+    digits.push_back(static_cast<char>('0' + static_cast<int>(magnitude % 10)));
+    magnitude /= 10;
+  }
+  if (negative) {
+    digits.push_back('-');
+  }
+  std::reverse(digits.begin(), digits.end());
+  return digits;
+}
+
+// ============================================================================
+// Aggregation
+// ============================================================================
+
+std::vector<InstrumentStats> aggregate_by_instrument(const query::RecordRange& records,
+                                                     const AggregateOptions& options) {
+  const ActionTable table(options.volume_actions);
+  const unsigned threads = static_cast<unsigned>(std::min<size_t>(
+      resolve_thread_count(options.threads), std::max<size_t>(1, records.count)));
+  std::vector<FlatHashMap<uint32_t, InstrumentStats>> partials(threads);
+
+  parallel_for(threads, [&](unsigned t) {
+    const auto [begin, end] = chunk_range(records.count, threads, t);
+    auto& map = partials[t];
+    // Consecutive records usually share an instrument; skip the probe then.
+    // The cached pointer is refreshed on every insertion, which is the only
+    // thing that invalidates it.
+    uint32_t last_id = 0;
+    InstrumentStats* stats = nullptr;
+
+    const uint8_t* rec = records.data + begin * records.stride;
+    for (size_t i = begin; i < end; ++i, rec += records.stride) {
+      const uint32_t id = FieldTraits<&MboMsg::instrument_id>::load(rec);
+      if (stats == nullptr || id != last_id) {
+        stats = &map[id];
+        last_id = id;
+      }
+      const auto action = static_cast<uint8_t>(FieldTraits<&MboMsg::action>::load(rec));
+      const int64_t price = FieldTraits<&MboMsg::price>::load(rec);
+      const uint32_t size = FieldTraits<&MboMsg::size>::load(rec);
+      const bool is_volume = table.is_volume[action];
+
+      ++stats->records;
+      ++stats->action_counts[table.slot[action]];
+      stats->volume += is_volume ? size : 0;
+      stats->notional += is_volume ? static_cast<int128_t>(price) * size : 0;
+      stats->min_price = is_volume && price < stats->min_price ? price : stats->min_price;
+      stats->max_price = is_volume && price > stats->max_price ? price : stats->max_price;
+    }
+  });
+
+  // Integer merges are order-independent, so the result does not depend on
+  // how records were split
+  FlatHashMap<uint32_t, InstrumentStats>& merged = partials[0];
+  for (unsigned t = 1; t < threads; ++t) {
+    partials[t].for_each([&](uint32_t id, const InstrumentStats& stats) {
+      merge_into(merged[id], stats);
+    });
+  }
+
+  std::vector<InstrumentStats> result;
+  result.reserve(merged.size());
+  merged.for_each([&](uint32_t id, const InstrumentStats& stats) {
+    result.push_back(stats);
+    result.back().instrument_id = id;
+  });
+  std::sort(result.begin(), result.end(),
+            [](const InstrumentStats& a, const InstrumentStats& b) {
+              return a.instrument_id < b.instrument_id;
+            });
+  return result;
+}
+
+} // namespace databento
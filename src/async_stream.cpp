@@ -0,0 +1,140 @@
+#include "databento/async_stream.hpp"
+#include "databento/file_watch.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+
+#include <poll.h>
+
+namespace databento {
+
+// ============================================================================
+// StreamScheduler
+// ============================================================================
+
+void StreamScheduler::spawn(Task task) {
+  ready_.push_back(task.handle_);
+  tasks_.push_back(std::move(task));
+}
+
+void StreamScheduler::park(WaitAwaiter* awaiter, std::coroutine_handle<> handle) {
+  if (awaiter->fd < 0 && awaiter->deadline <= Clock::now()) {
+    ready_.push_back(handle);  // yield(): straight to the back of the queue
+    return;
+  }
+  parked_.push_back({awaiter, handle});
+}
+
+void StreamScheduler::run() {
+  for (;;) {
+    while (!ready_.empty()) {
+      const std::coroutine_handle<> handle = ready_.front();
+      ready_.pop_front();
+      handle.resume();
+    }
+
+    for (auto& task : tasks_) {
+      if (task.handle_.done() && task.handle_.promise().exception) {
+        std::rethrow_exception(std::exchange(task.handle_.promise().exception, nullptr));
+      }
+    }
+    std::erase_if(tasks_, [](const Task& task) { return task.done(); });
+    if (tasks_.empty()) {
+      return;
+    }
+    if (parked_.empty()) {
+      throw std::logic_error("StreamScheduler: tasks suspended on something other than the scheduler");
+    }
+    wait_for_events();
+  }
+}
+
+void StreamScheduler::wait_for_events() {
+  std::vector<pollfd> fds;
+  Clock::time_point earliest = Clock::time_point::max();
+  for (const Parked& p : parked_) {
+    if (p.awaiter->fd >= 0) {
+      fds.push_back({p.awaiter->fd, POLLIN, 0});
+    }
+    earliest = std::min(earliest, p.awaiter->deadline);
+  }
+
+  const auto wait = std::max(Clock::duration::zero(), earliest - Clock::now());
+  const auto wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+  timespec ts{static_cast<time_t>(wait_ns / 1'000'000'000), static_cast<long>(wait_ns % 1'000'000'000)};
+  if (::ppoll(fds.data(), fds.size(), &ts, nullptr) < 0 && errno != EINTR) {
+    throw std::runtime_error("StreamScheduler: ppoll failed");
+  }
+
+  // Wake in parking order: readable fds, then expired deadlines
+  const Clock::time_point now = Clock::now();
+  size_t fd_index = 0;
+  std::vector<Parked> still_parked;
+  for (const Parked& p : parked_) {
+    const bool readable = p.awaiter->fd >= 0 && fds[fd_index++].revents != 0;
+    if (readable || p.awaiter->deadline <= now) {
+      p.awaiter->readable = readable;
+      ready_.push_back(p.handle);
+    } else {
+      still_parked.push_back(p);
+    }
+  }
+  parked_.swap(still_parked);
+}
+
+// ============================================================================
+// Record Sources
+// ============================================================================
+
+namespace {
+
+void check_batch_records(size_t batch_records) {
+  if (batch_records == 0) {
+    throw std::invalid_argument("batch_records must be positive");
+  }
+}
+
+} // namespace
+
+AsyncGenerator<RecordView<MboMsg>> mbo_batches(DbnParser& parser, size_t batch_records) {
+  check_batch_records(batch_records);
+  const RecordView<MboMsg> records = parser.records<MboMsg>();
+  for (size_t i = 0; i < records.size(); i += batch_records) {
+    co_yield records.subview(i, std::min(batch_records, records.size() - i));
+  }
+}
+
+AsyncGenerator<RecordView<MboMsg>> follow_mbo_batches(DbnParser& parser, StreamScheduler& scheduler,
+                                                      FollowOptions options, size_t batch_records) {
+  check_batch_records(batch_records);
+  if (options.start_at_end) {
+    while (parser.poll_mbo_batch(std::numeric_limits<size_t>::max()).size() > 0) {
+    }
+  }
+
+  const detail::FileWatch watch(parser.filepath(), options.use_inotify);
+  auto last_growth = StreamScheduler::Clock::now();
+  for (;;) {
+    const RecordView<MboMsg> batch = parser.poll_mbo_batch(batch_records);
+    if (batch.size() > 0) {
+      last_growth = StreamScheduler::Clock::now();
+      co_yield batch;
+      continue;
+    }
+
+    if (options.idle_timeout.count() > 0 &&
+        StreamScheduler::Clock::now() - last_growth >= options.idle_timeout) {
+      co_return;
+    }
+    if (watch.fd >= 0) {
+      if (co_await scheduler.readable(watch.fd, options.poll_interval)) {
+        watch.drain();
+      }
+    } else {
+      co_await scheduler.sleep(options.poll_interval);
+    }
+  }
+}
+
+} // namespace databento
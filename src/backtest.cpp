@@ -0,0 +1,263 @@
+#include "databento/backtest.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace databento {
+
+namespace {
+
+inline bool pending_later(uint64_t a_ts, uint64_t a_seq, uint64_t b_ts, uint64_t b_seq) {
+  return a_ts != b_ts ? a_ts > b_ts : a_seq > b_seq;
+}
+
+inline char opposite_side(char side) {
+  return side == 'A' ? 'B' : (side == 'B' ? 'A' : 'N');
+}
+
+} // namespace
+
+// ============================================================================
+// MatchingSimulator Implementation
+// ============================================================================
+
+MatchingSimulator::MatchingSimulator(const MatchingOptions& options)
+    : options_(options) {
+}
+
+uint64_t MatchingSimulator::submit(uint32_t instrument_id, Side side, int64_t price,
+                                   uint32_t size, uint64_t now_ns) {
+  if (side != Side::Bid && side != Side::Ask) {
+    throw std::invalid_argument("Simulated orders must be Bid or Ask");
+  }
+  if (size == 0) {
+    throw std::invalid_argument("Simulated order size must be positive");
+  }
+
+  const uint64_t id = orders_.size();
+  orders_.push_back(SimOrder{id, instrument_id, static_cast<char>(side), price, size,
+                             size, 0, 0, now_ns, 0, SimOrderStatus::Pending});
+  schedule(now_ns + options_.entry_latency_ns, id, PendingType::Submit);
+  return id;
+}
+
+void MatchingSimulator::cancel(uint64_t order_id, uint64_t now_ns) {
+  if (order_id >= orders_.size()) {
+    throw std::out_of_range("Unknown simulated order");
+  }
+  schedule(now_ns + options_.cancel_latency_ns, order_id, PendingType::Cancel);
+}
+
+void MatchingSimulator::schedule(uint64_t ts, uint64_t order_id, PendingType type) {
+  pending_.push_back(PendingAction{ts, pending_seq_++, order_id, type});
+  std::push_heap(pending_.begin(), pending_.end(),
+                 [](const PendingAction& a, const PendingAction& b) {
+                   return pending_later(a.ts, a.seq, b.ts, b.seq);
+                 });
+}
+
+void MatchingSimulator::advance_to(uint64_t ts) {
+  auto later = [](const PendingAction& a, const PendingAction& b) {
+    return pending_later(a.ts, a.seq, b.ts, b.seq);
+  };
+  while (!pending_.empty() && pending_.front().ts <= ts) {
+    std::pop_heap(pending_.begin(), pending_.end(), later);
+    const PendingAction action = pending_.back();
+    pending_.pop_back();
+
+    SimOrder& order = orders_[action.order_id];
+    if (action.type == PendingType::Submit) {
+      activate(order, action.ts);
+    } else if (order.status == SimOrderStatus::Pending) {
+      order.status = SimOrderStatus::Cancelled;
+    } else if (order.status == SimOrderStatus::Active) {
+      deactivate(order);
+      order.status = SimOrderStatus::Cancelled;
+    }
+  }
+}
+
+void MatchingSimulator::on_mbo(const MboMsg& msg) {
+  advance_to(msg.ts_event);
+
+  if (active_count_ > 0) {
+    switch (static_cast<Action>(msg.action)) {
+      case Action::Cancel:
+        if (const RestingOrder* historical = book_.find(msg.order_id)) {
+          on_queue_reduction(*historical, std::min(msg.size, historical->size));
+        }
+        break;
+      case Action::Modify:
+        if (const RestingOrder* historical = book_.find(msg.order_id)) {
+          if (msg.price != historical->price || msg.size > historical->size) {
+            on_queue_reduction(*historical, historical->size);  // Re-queued
+          } else if (msg.size < historical->size) {
+            on_queue_reduction(*historical, historical->size - msg.size);
+          }
+        }
+        break;
+      case Action::Trade:
+        if (msg.side == 'A' || msg.side == 'B') {
+          on_trade(msg, opposite_side(msg.side));
+        }
+        break;
+      case Action::Clear:
+        on_clear(msg.instrument_id);
+        break;
+      case Action::Add:
+      case Action::Fill:
+        break;
+    }
+  }
+
+  book_.apply(msg);
+}
+
+void MatchingSimulator::activate(SimOrder& order, uint64_t ts) {
+  if (order.status != SimOrderStatus::Pending) {
+    return;
+  }
+  order.status = SimOrderStatus::Active;
+  order.active_ts = ts;
+  order.queue_ahead = book_.level(order.instrument_id, order.side, order.price).size;
+  order.priority = book_.next_priority();
+
+  const LevelKey key{order.instrument_id, order.side, order.price};
+  auto [slot, inserted] = level_index_.try_emplace(key, 0);
+  if (inserted) {
+    if (free_levels_.empty()) {
+      *slot = static_cast<uint32_t>(levels_.size());
+      levels_.emplace_back();
+    } else {
+      *slot = free_levels_.back();
+      free_levels_.pop_back();
+    }
+    std::vector<int64_t>& prices = active_prices_[side_key(order.instrument_id, order.side)];
+    prices.insert(std::lower_bound(prices.begin(), prices.end(), order.price), order.price);
+  }
+  levels_[*slot].orders.push_back(static_cast<uint32_t>(order.id));
+  ++active_count_;
+}
+
+void MatchingSimulator::deactivate(SimOrder& order) {
+  const LevelKey key{order.instrument_id, order.side, order.price};
+  uint32_t* slot = level_index_.find(key);
+  if (!slot) {
+    return;
+  }
+  std::vector<uint32_t>& ids = levels_[*slot].orders;
+  ids.erase(std::find(ids.begin(), ids.end(), static_cast<uint32_t>(order.id)));
+  if (ids.empty()) {
+    free_levels_.push_back(*slot);
+    level_index_.erase(key);
+    std::vector<int64_t>& prices = active_prices_[side_key(order.instrument_id, order.side)];
+    prices.erase(std::lower_bound(prices.begin(), prices.end(), order.price));
+  }
+  --active_count_;
+}
+
+MatchingSimulator::SimLevel* MatchingSimulator::find_level(uint32_t instrument_id,
+                                                           char side, int64_t price) {
+  const uint32_t* slot = level_index_.find(LevelKey{instrument_id, side, price});
+  return slot ? &levels_[*slot] : nullptr;
+}
+
+void MatchingSimulator::on_queue_reduction(const RestingOrder& historical, uint64_t removed) {
+  SimLevel* level = find_level(historical.instrument_id, historical.side, historical.price);
+  if (!level) {
+    return;
+  }
+  for (uint32_t id : level->orders) {
+    SimOrder& order = orders_[id];
+    if (historical.priority < order.priority) {
+      order.queue_ahead -= std::min(order.queue_ahead, removed);
+    }
+  }
+}
+
+void MatchingSimulator::on_trade(const MboMsg& msg, char passive_side) {
+  // fill() can empty levels and price lists, so work from copies held in
+  // reused scratch vectors rather than fresh allocations per trade
+  std::vector<std::pair<uint32_t, uint32_t>>& partial = scratch_partial_;
+  std::vector<int64_t>& through = scratch_prices_;
+  std::vector<uint32_t>& to_fill = scratch_orders_;
+
+  // Orders at the traded price: historical volume ahead trades first
+  if (SimLevel* level = find_level(msg.instrument_id, passive_side, msg.price)) {
+    uint64_t taken_by_sim = 0;
+    partial.clear();
+    for (uint32_t id : level->orders) {
+      SimOrder& order = orders_[id];
+      const uint64_t ahead = order.queue_ahead;
+      order.queue_ahead -= std::min<uint64_t>(ahead, msg.size);
+      const uint64_t reach = ahead + taken_by_sim;
+      if (msg.size <= reach) {
+        continue;
+      }
+      const uint32_t qty = static_cast<uint32_t>(
+          std::min<uint64_t>(order.remaining, msg.size - reach));
+      taken_by_sim += qty;
+      partial.emplace_back(id, qty);
+    }
+    for (const auto& [id, qty] : partial) {
+      fill(orders_[id], msg.ts_event, qty);
+    }
+  }
+
+  // Levels strictly better than the trade price were traded through
+  std::vector<int64_t>* prices = active_prices_.find(side_key(msg.instrument_id, passive_side));
+  if (!prices || prices->empty()) {
+    return;
+  }
+  to_fill.clear();
+  if (passive_side == 'B') {
+    through.assign(std::upper_bound(prices->begin(), prices->end(), msg.price), prices->end());
+  } else {
+    through.assign(prices->begin(), std::lower_bound(prices->begin(), prices->end(), msg.price));
+  }
+  for (int64_t price : through) {
+    if (SimLevel* level = find_level(msg.instrument_id, passive_side, price)) {
+      to_fill.insert(to_fill.end(), level->orders.begin(), level->orders.end());
+    }
+  }
+  for (uint32_t id : to_fill) {
+    SimOrder& order = orders_[id];
+    if (order.status == SimOrderStatus::Active) {
+      fill(order, msg.ts_event, order.remaining);
+    }
+  }
+}
+
+void MatchingSimulator::on_clear(uint32_t instrument_id) {
+  // Only the instrument's active levels, found through its price lists
+  for (char side : {'B', 'A'}) {
+    const std::vector<int64_t>* prices = active_prices_.find(side_key(instrument_id, side));
+    if (!prices) {
+      continue;
+    }
+    for (int64_t price : *prices) {
+      if (SimLevel* level = find_level(instrument_id, side, price)) {
+        for (uint32_t id : level->orders) {
+          orders_[id].queue_ahead = 0;
+        }
+      }
+    }
+  }
+}
+
+void MatchingSimulator::fill(SimOrder& order, uint64_t ts, uint32_t size) {
+  if (size == 0) {
+    return;
+  }
+  order.remaining -= size;
+  const SimFill sim_fill{order.id, ts, order.price, size, order.remaining};
+  fills_.push_back(sim_fill);
+  if (order.remaining == 0) {
+    deactivate(order);
+    order.status = SimOrderStatus::Filled;
+  }
+  if (on_fill_) {
+    on_fill_(sim_fill);
+  }
+}
+
+} // namespace databento
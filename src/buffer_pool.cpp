@@ -0,0 +1,217 @@
+#include "databento/buffer_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+constexpr size_t HUGE_2MB = size_t{2} << 20;
+constexpr size_t HUGE_1GB = size_t{1} << 30;
+
+size_t round_up(size_t value, size_t granularity) {
+  return (value + granularity - 1) / granularity * granularity;
+}
+
+size_t page_size() {
+  static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+struct Mapping {
+  uint8_t* data;
+  size_t capacity;
+  bool huge;
+};
+
+void advise_transparent(void* data, size_t bytes, HugePages mode) {
+#ifdef MADV_HUGEPAGE
+  if (mode != HugePages::None) {
+    ::madvise(data, bytes, MADV_HUGEPAGE);
+  }
+#else
+  (void)data;
+  (void)bytes;
+  (void)mode;
+#endif
+}
+
+// Explicit hugetlb pages when asked for and reserved, else normal pages
+// (hinted for transparent hugepages unless mode is None)
+Mapping map_pages(size_t bytes, HugePages mode) {
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (mode == HugePages::Explicit2MB || mode == HugePages::Explicit1GB) {
+    const bool gigantic = mode == HugePages::Explicit1GB;
+    const size_t capacity = round_up(bytes, gigantic ? HUGE_1GB : HUGE_2MB);
+    const int size_flag = (gigantic ? 30 : 21) << MAP_HUGE_SHIFT;
+    // Without MAP_NORESERVE, so an empty hugetlb pool fails here instead of
+    // with SIGBUS on first touch
+    void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flag, -1, 0);
+    if (p != MAP_FAILED) {
+      return {static_cast<uint8_t*>(p), capacity, true};
+    }
+  }
+#endif
+  const size_t capacity = round_up(bytes, mode == HugePages::None ? page_size() : HUGE_2MB);
+  void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  advise_transparent(p, capacity, mode);
+  return {static_cast<uint8_t*>(p), capacity, false};
+}
+
+} // namespace
+
+// ============================================================================
+// PooledBuffer
+// ============================================================================
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    huge_pages_ = other.huge_pages_;
+    huge_ = std::exchange(other.huge_, false);
+    pool_ = std::exchange(other.pool_, nullptr);
+  }
+  return *this;
+}
+
+void PooledBuffer::resize(size_t size) {
+  if (size > capacity_) {
+    // Geometric, so follow mode's many small appends stay amortised O(1)
+    reserve(capacity_ == 0 ? size : std::max(size, capacity_ * 2));
+  }
+  size_ = size;
+}
+
+void PooledBuffer::reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  if (data_ == nullptr) {
+    const Mapping m = map_pages(capacity, huge_pages_);
+    data_ = m.data;
+    capacity_ = m.capacity;
+    huge_ = m.huge;
+    return;
+  }
+
+#ifdef MREMAP_MAYMOVE
+  if (!huge_) {
+    const size_t rounded = round_up(capacity, huge_pages_ == HugePages::None ? page_size() : HUGE_2MB);
+    void* p = ::mremap(data_, capacity_, rounded, MREMAP_MAYMOVE);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    data_ = static_cast<uint8_t*>(p);
+    capacity_ = rounded;
+    advise_transparent(data_, capacity_, huge_pages_);
+    return;
+  }
+#endif
+  const Mapping m = map_pages(capacity, huge_pages_);
+  std::memcpy(m.data, data_, size_);
+  ::munmap(data_, capacity_);
+  data_ = m.data;
+  capacity_ = m.capacity;
+  huge_ = m.huge;
+}
+
+void PooledBuffer::release() {
+  if (data_ && pool_) {
+    BufferPool* pool = std::exchange(pool_, nullptr);
+    pool->give_back(std::move(*this));
+  }
+  unmap();
+}
+
+void PooledBuffer::unmap() {
+  if (data_) {
+    ::munmap(data_, capacity_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+  huge_ = false;
+}
+
+// ============================================================================
+// BufferPool
+// ============================================================================
+
+BufferPool::~BufferPool() {
+  trim();
+}
+
+PooledBuffer BufferPool::acquire(size_t bytes) {
+  PooledBuffer buffer(options_.huge_pages);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.acquires;
+    if (!cached_.empty()) {
+      // Smallest that fits, else the largest (its resident pages are reused)
+      auto best = cached_.end();
+      auto largest = cached_.begin();
+      for (auto it = cached_.begin(); it != cached_.end(); ++it) {
+        if (it->capacity() >= bytes && (best == cached_.end() || it->capacity() < best->capacity())) {
+          best = it;
+        }
+        if (it->capacity() > largest->capacity()) {
+          largest = it;
+        }
+      }
+      auto chosen = best != cached_.end() ? best : largest;
+      stats_.cached_bytes -= chosen->capacity();
+      buffer = std::move(*chosen);
+      *chosen = std::move(cached_.back());
+      cached_.pop_back();
+      ++stats_.reuses;
+    } else {
+      ++stats_.new_mappings;
+    }
+  }
+  buffer.reserve(bytes);  // Exact, not geometric: the size is known
+  buffer.size_ = bytes;
+  buffer.pool_ = this;
+  return buffer;
+}
+
+void BufferPool::give_back(PooledBuffer&& buffer) {
+  PooledBuffer returned = std::move(buffer);
+  returned.size_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.cached_bytes + returned.capacity() <= options_.max_cached_bytes) {
+      stats_.cached_bytes += returned.capacity();
+      cached_.push_back(std::move(returned));
+      return;
+    }
+  }
+  // Over the cap: `returned` unmaps here, outside the lock
+}
+
+void BufferPool::trim() {
+  std::vector<PooledBuffer> cached;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cached.swap(cached_);
+    stats_.cached_bytes = 0;
+  }
+}
+
+BufferPoolStats BufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace databento
@@ -0,0 +1,383 @@
+#include "databento/checkpoint.hpp"
+#include "databento/io.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+// File layout (little-endian):
+//   FileHeader
+//   snapshot*      { SnapshotHeader, SnapshotOrder[order_count],
+//                    u32 blob_count, { u32 name_len, name, u64 len, bytes }* }
+//   IndexEntry[n]
+//   FileTrailer
+constexpr char FILE_MAGIC[8] = {'D', 'B', 'N', 'C', 'K', 'P', 'T', '1'};
+constexpr char TRAILER_MAGIC[8] = {'D', 'B', 'N', 'C', 'K', 'I', 'D', 'X'};
+constexpr uint32_t SNAPSHOT_MARKER = 0x54504B43; // "CKPT"
+
+#pragma pack(push, 1)
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t source_size;     // Data file size covered by the last checkpoint
+  uint64_t header_hash;     // Hash of the data file's metadata block
+};
+
+struct SnapshotHeader {
+  uint32_t marker;
+  uint64_t record_index;
+  uint64_t ts_event;
+  uint64_t next_priority;
+  uint64_t order_count;
+};
+
+struct SnapshotOrder {
+  uint64_t order_id;
+  uint32_t instrument_id;
+  char side;
+  int64_t price;
+  uint32_t size;
+  uint64_t priority;
+};
+
+struct IndexEntry {
+  uint64_t record_index;
+  uint64_t ts_event;
+  uint64_t file_offset;
+  uint64_t order_count;
+};
+
+struct FileTrailer {
+  uint64_t index_offset;
+  uint64_t index_count;
+  char magic[8];
+};
+
+#pragma pack(pop)
+
+uint64_t hash_bytes(const uint8_t* data, size_t len) {
+  uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a
+  for (size_t i = 0; i < len; ++i) {
+    h ^= data[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+uint64_t metadata_hash(const DbnParser& parser) {
+  const size_t len = std::min(parser.size(), parser.metadata_offset());
+  return hash_bytes(parser.data(), len);
+}
+
+struct DataFileSummary {
+  uint64_t size;
+  uint64_t header_hash;
+};
+
+// Size and metadata hash of the parser's data file. An unloaded parser is
+// not loaded: only the metadata block is read, with pread after fstat.
+DataFileSummary summarize(const DbnParser& parser) {
+  if (parser.data()) {
+    return {parser.size(), metadata_hash(parser)};
+  }
+  const std::string& path = parser.filepath();
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  DataFileSummary summary;
+  try {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      throw std::runtime_error("Failed to stat file: " + path);
+    }
+    summary.size = static_cast<uint64_t>(st.st_size);
+    std::vector<uint8_t> metadata(std::min<uint64_t>(summary.size, parser.metadata_offset()));
+    pread_all(fd, metadata.data(), metadata.size(), 0, path);
+    summary.header_hash = hash_bytes(metadata.data(), metadata.size());
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+  return summary;
+}
+
+template<typename T>
+void write_pod(std::ofstream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+void read_pod(std::ifstream& in, T& value) {
+  in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if (!in) {
+    throw std::runtime_error("Truncated checkpoint file");
+  }
+}
+
+void write_snapshot(std::ofstream& out, uint64_t record_index, uint64_t ts_event,
+                    const OrderBook& book, const CheckpointRegistry& registry) {
+  write_pod(out, SnapshotHeader{SNAPSHOT_MARKER, record_index, ts_event,
+                                book.next_priority(), book.order_count()});
+
+  std::vector<SnapshotOrder> orders;
+  orders.reserve(book.order_count());
+  book.for_each_order([&](const RestingOrder& o) {
+    orders.push_back(SnapshotOrder{o.order_id, o.instrument_id, o.side,
+                                   o.price, o.size, o.priority});
+  });
+  out.write(reinterpret_cast<const char*>(orders.data()),
+            orders.size() * sizeof(SnapshotOrder));
+
+  write_pod(out, static_cast<uint32_t>(registry.entries().size()));
+  for (const auto& entry : registry.entries()) {
+    const std::string blob = entry.save();
+    write_pod(out, static_cast<uint32_t>(entry.name.size()));
+    out.write(entry.name.data(), entry.name.size());
+    write_pod(out, static_cast<uint64_t>(blob.size()));
+    out.write(blob.data(), blob.size());
+  }
+}
+
+} // namespace
+
+// ============================================================================
+// CheckpointRegistry Implementation
+// ============================================================================
+
+void CheckpointRegistry::register_state(const std::string& name, SaveFn save, LoadFn load) {
+  for (const auto& entry : entries_) {
+    if (entry.name == name) {
+      throw std::invalid_argument("Checkpoint state already registered: " + name);
+    }
+  }
+  entries_.push_back(Entry{name, std::move(save), std::move(load)});
+}
+
+// ============================================================================
+// Checkpoint Writing
+// ============================================================================
+
+std::string default_checkpoint_path(const std::string& data_path) {
+  return data_path + ".ckpt";
+}
+
+size_t build_checkpoints(DbnParser& parser, const std::string& checkpoint_path,
+                         OrderBook& book, const CheckpointRegistry& registry,
+                         MboCallback callback, const CheckpointOptions& options) {
+  if (options.interval_records == 0) {
+    throw std::invalid_argument("Checkpoint interval must be positive");
+  }
+  if (!parser.data()) {
+    parser.load_into_memory();
+  }
+
+  std::ofstream out(checkpoint_path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Failed to create checkpoint file: " + checkpoint_path);
+  }
+
+  FileHeader header{};
+  std::copy(std::begin(FILE_MAGIC), std::end(FILE_MAGIC), header.magic);
+  header.version = 1;
+  header.record_size = static_cast<uint32_t>(parser.record_size());
+  header.source_size = parser.metadata_offset() + parser.num_records() * parser.record_size();
+  header.header_hash = metadata_hash(parser);
+  write_pod(out, header);
+
+  std::vector<IndexEntry> index;
+  uint64_t last_ts = 0;
+  size_t record_index = 0;
+
+  auto checkpoint = [&] {
+    const uint64_t offset = static_cast<uint64_t>(out.tellp());
+    write_snapshot(out, record_index, last_ts, book, registry);
+    index.push_back(IndexEntry{record_index, last_ts, offset, book.order_count()});
+  };
+
+  parser.parse_mbo([&](const MboMsg& msg) {
+    book.apply(msg);
+    if (callback) {
+      callback(msg);
+    }
+    last_ts = msg.ts_event;
+    ++record_index;
+    if (record_index % options.interval_records == 0) {
+      checkpoint();
+    }
+  });
+  if (index.empty() || index.back().record_index != record_index) {
+    checkpoint();
+  }
+
+  const uint64_t index_offset = static_cast<uint64_t>(out.tellp());
+  out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+  FileTrailer trailer{index_offset, index.size(), {}};
+  std::copy(std::begin(TRAILER_MAGIC), std::end(TRAILER_MAGIC), trailer.magic);
+  write_pod(out, trailer);
+
+  if (!out) {
+    throw std::runtime_error("Failed to write checkpoint file: " + checkpoint_path);
+  }
+  return index.size();
+}
+
+// ============================================================================
+// CheckpointFile Implementation
+// ============================================================================
+
+CheckpointFile::CheckpointFile(const std::string& path) : path_(path) {
+  std::ifstream in(path_, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("Failed to open checkpoint file: " + path_);
+  }
+  const auto file_size = static_cast<uint64_t>(in.tellg());
+  if (file_size < sizeof(FileHeader) + sizeof(FileTrailer)) {
+    throw std::runtime_error("Invalid checkpoint file: " + path_);
+  }
+
+  in.seekg(0);
+  FileHeader header;
+  read_pod(in, header);
+  if (!std::equal(std::begin(FILE_MAGIC), std::end(FILE_MAGIC), header.magic) ||
+      header.version != 1) {
+    throw std::runtime_error("Invalid checkpoint file: " + path_);
+  }
+  source_size_ = header.source_size;
+  header_hash_ = header.header_hash;
+  record_size_ = header.record_size;
+
+  in.seekg(static_cast<std::streamoff>(file_size - sizeof(FileTrailer)));
+  FileTrailer trailer;
+  read_pod(in, trailer);
+  if (!std::equal(std::begin(TRAILER_MAGIC), std::end(TRAILER_MAGIC), trailer.magic)) {
+    throw std::runtime_error("Checkpoint file has no index (incomplete write?): " + path_);
+  }
+
+  std::vector<IndexEntry> entries(trailer.index_count);
+  in.seekg(static_cast<std::streamoff>(trailer.index_offset));
+  in.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(IndexEntry));
+  if (!in) {
+    throw std::runtime_error("Truncated checkpoint index: " + path_);
+  }
+
+  index_.reserve(entries.size());
+  for (const IndexEntry& e : entries) {
+    index_.push_back(CheckpointInfo{e.record_index, e.ts_event, e.file_offset, e.order_count});
+  }
+}
+
+const CheckpointInfo* CheckpointFile::find_before_ts(uint64_t ts) const {
+  // Checkpoints are written in record order; ts_event is assumed monotonic
+  auto it = std::upper_bound(index_.begin(), index_.end(), ts,
+                             [](uint64_t t, const CheckpointInfo& c) { return t < c.ts_event; });
+  return it == index_.begin() ? nullptr : &*(it - 1);
+}
+
+const CheckpointInfo* CheckpointFile::find_before_record(uint64_t record_index) const {
+  auto it = std::upper_bound(index_.begin(), index_.end(), record_index,
+                             [](uint64_t r, const CheckpointInfo& c) { return r < c.record_index; });
+  return it == index_.begin() ? nullptr : &*(it - 1);
+}
+
+void CheckpointFile::validate(const DbnParser& parser) const {
+  const DataFileSummary data = summarize(parser);
+  if (record_size_ != parser.record_size() || source_size_ > data.size ||
+      header_hash_ != data.header_hash) {
+    throw std::runtime_error("Checkpoint does not match data file: " + path_);
+  }
+}
+
+void CheckpointFile::restore(const CheckpointInfo& checkpoint, OrderBook& book,
+                             const CheckpointRegistry& registry) const {
+  std::ifstream in(path_, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Failed to open checkpoint file: " + path_);
+  }
+  in.seekg(static_cast<std::streamoff>(checkpoint.file_offset));
+
+  SnapshotHeader header;
+  read_pod(in, header);
+  if (header.marker != SNAPSHOT_MARKER || header.record_index != checkpoint.record_index) {
+    throw std::runtime_error("Corrupt checkpoint snapshot: " + path_);
+  }
+
+  std::vector<SnapshotOrder> orders(header.order_count);
+  in.read(reinterpret_cast<char*>(orders.data()), orders.size() * sizeof(SnapshotOrder));
+  if (!in) {
+    throw std::runtime_error("Truncated checkpoint snapshot: " + path_);
+  }
+
+  book.clear();
+  for (const SnapshotOrder& o : orders) {
+    book.insert(RestingOrder{o.order_id, o.instrument_id, o.side, o.price, o.size, o.priority});
+  }
+  book.set_next_priority(header.next_priority);
+
+  uint32_t blob_count;
+  read_pod(in, blob_count);
+  for (uint32_t i = 0; i < blob_count; ++i) {
+    uint32_t name_len;
+    read_pod(in, name_len);
+    std::string name(name_len, '\0');
+    in.read(name.data(), name_len);
+    uint64_t blob_len;
+    read_pod(in, blob_len);
+    std::string blob(blob_len, '\0');
+    in.read(blob.data(), static_cast<std::streamsize>(blob_len));
+    if (!in) {
+      throw std::runtime_error("Truncated checkpoint state blob: " + path_);
+    }
+    for (const auto& entry : registry.entries()) {
+      if (entry.name == name) {
+        entry.load(blob);
+        break;
+      }
+    }
+  }
+}
+
+// ============================================================================
+// Resume Helpers
+// ============================================================================
+
+size_t restore_checkpoint(DbnParser& parser, const std::string& checkpoint_path,
+                          uint64_t target_ts, OrderBook& book,
+                          const CheckpointRegistry& registry) {
+  // Validation reads only the data file's metadata and size, so restoring
+  // does not load the file
+  CheckpointFile file(checkpoint_path);
+  file.validate(parser);
+
+  const CheckpointInfo* checkpoint = file.find_before_ts(target_ts);
+  if (!checkpoint) {
+    book.clear();
+    book.set_next_priority(0);
+    return 0;
+  }
+  file.restore(*checkpoint, book, registry);
+  return checkpoint->record_index;
+}
+
+size_t resume_mbo(DbnParser& parser, const std::string& checkpoint_path,
+                  uint64_t target_ts, OrderBook& book,
+                  const CheckpointRegistry& registry, MboCallback callback) {
+  const size_t start = restore_checkpoint(parser, checkpoint_path, target_ts, book, registry);
+  parser.parse_mbo_from(start, [&](const MboMsg& msg) {
+    book.apply(msg);
+    callback(msg);
+  });
+  return start;
+}
+
+} // namespace databento
@@ -0,0 +1,397 @@
+#include "databento/codec.hpp"
+#include "databento/trace.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace databento {
+
+namespace {
+
+constexpr char CODEC_MAGIC[8] = {'D', 'B', 'N', 'M', 'B', 'O', 'Z', '1'};
+constexpr uint32_t CODEC_VERSION = 1;
+
+// Zero bytes after the last block so unpacking whole groups of eight
+// values never reads past the buffer
+constexpr size_t TAIL_PADDING = 72;
+
+// Stream mode bits
+constexpr uint8_t MODE_DELTA = 0x01;   // Values are deltas from the previous record
+constexpr uint8_t MODE_SCALED = 0x02;  // Packed values are multiples of a common factor
+
+#pragma pack(push, 1)
+struct FrameHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t block_records;
+  uint64_t count;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(MboMsg) == 48, "codec assumes the 48-byte MBO layout");
+
+// Byte ranges of the record, covering all 48 bytes
+struct FieldSpec {
+  size_t offset;
+  size_t bytes;
+};
+
+constexpr FieldSpec FIELDS[] = {
+    {0, 8},   // ts_event
+    {8, 4},   // instrument_id
+    {12, 1},  // action
+    {13, 1},  // side
+    {14, 1},  // flags
+    {15, 1},  // depth
+    {16, 8},  // price
+    {24, 4},  // size
+    {28, 4},  // channel_id
+    {32, 8},  // order_id
+    {40, 4},  // sequence
+    {44, 1},  // ts_in_delta
+    {45, 3},  // reserved
+};
+
+constexpr size_t NUM_FIELDS = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+template<size_t F>
+inline uint64_t load_field(const uint8_t* record) {
+  uint64_t v = 0;
+  std::memcpy(&v, record + FIELDS[F].offset, FIELDS[F].bytes);
+  return v;
+}
+
+template<size_t F>
+inline void store_field(uint8_t* record, uint64_t v) {
+  std::memcpy(record + FIELDS[F].offset, &v, FIELDS[F].bytes);
+}
+
+template<typename Fn, size_t... F>
+inline void for_each_field_impl(Fn&& fn, std::index_sequence<F...>) {
+  (fn(std::integral_constant<size_t, F>{}), ...);
+}
+
+// fn(std::integral_constant<size_t, F>) for every field
+template<typename Fn>
+inline void for_each_field(Fn&& fn) {
+  for_each_field_impl(fn, std::make_index_sequence<NUM_FIELDS>{});
+}
+
+inline unsigned bit_width(uint64_t v) {
+  return v == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(v));
+}
+
+inline size_t packed_bytes(size_t count, unsigned width) {
+  return (count * width + 7) / 8;
+}
+
+// ----------------------------------------------------------------------------
+// Bit packing
+// ----------------------------------------------------------------------------
+
+void pack(const uint64_t* values, size_t count, unsigned width, std::vector<uint8_t>& out) {
+  const size_t start = out.size();
+  out.resize(start + packed_bytes(count, width), 0);
+  if (width == 0) {
+    return;
+  }
+  uint8_t* dst = out.data() + start;
+  size_t bit = 0;
+  for (size_t i = 0; i < count; ++i, bit += width) {
+    // Spread the value over at most 9 bytes starting at bit / 8
+    uint64_t v = values[i];
+    size_t byte = bit / 8;
+    unsigned shift = bit % 8;
+    unsigned remaining = width;
+    dst[byte] |= static_cast<uint8_t>(v << shift);
+    const unsigned first = std::min(remaining, 8 - shift);
+    v = first == 64 ? 0 : v >> first;
+    remaining -= first;
+    while (remaining > 0) {
+      dst[++byte] = static_cast<uint8_t>(v);
+      v >>= 8;
+      remaining -= std::min(remaining, 8u);
+    }
+  }
+}
+
+template<unsigned W, unsigned Bit>
+inline uint64_t extract(const uint8_t* in) {
+  constexpr unsigned byte = Bit / 8;
+  constexpr unsigned shift = Bit % 8;
+  constexpr uint64_t mask = W == 64 ? ~uint64_t{0} : (uint64_t{1} << W) - 1;
+  uint64_t lo;
+  std::memcpy(&lo, in + byte, sizeof(lo));
+  uint64_t v = lo >> shift;
+  if constexpr (shift + W > 64) {
+    v |= static_cast<uint64_t>(in[byte + 8]) << (64 - shift);
+  }
+  return v & mask;
+}
+
+template<unsigned W, size_t... J>
+inline void unpack8(const uint8_t* in, uint64_t* out, std::index_sequence<J...>) {
+  ((out[J] = extract<W, J * W>(in)), ...);
+}
+
+// Unpack a multiple of eight values; eight W-bit values span W bytes
+template<unsigned W>
+void unpack(const uint8_t* in, size_t count, uint64_t* out) {
+  for (size_t i = 0; i < count; i += 8, in += W) {
+    unpack8<W>(in, out + i, std::make_index_sequence<8>{});
+  }
+}
+
+using UnpackFn = void (*)(const uint8_t*, size_t, uint64_t*);
+
+template<size_t... W>
+constexpr std::array<UnpackFn, sizeof...(W)> make_unpack_table(std::index_sequence<W...>) {
+  return {&unpack<static_cast<unsigned>(W)>...};
+}
+
+// Indexed by width 1..64; entry 0 is never called
+const auto UNPACK = make_unpack_table(std::make_index_sequence<65>{});
+
+// out[i] = base + sum(values[0..i] + step); count is a multiple of four
+void delta_decode(uint64_t* values, size_t count, uint64_t base, uint64_t step) {
+#ifdef __AVX2__
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i min_delta = _mm256_set1_epi64x(static_cast<long long>(step));
+  __m256i run = _mm256_set1_epi64x(static_cast<long long>(base));
+  for (size_t i = 0; i < count; i += 4) {
+    auto* p = reinterpret_cast<__m256i*>(values + i);
+    __m256i x = _mm256_add_epi64(_mm256_loadu_si256(p), min_delta);
+    // In-register inclusive prefix sum over the four lanes
+    __m256i t = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0));
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(t, zero, 0x03));
+    t = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0));
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(t, zero, 0x0F));
+    x = _mm256_add_epi64(x, run);
+    _mm256_storeu_si256(p, x);
+    run = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+#else
+  uint64_t acc = base;
+  for (size_t i = 0; i < count; ++i) {
+    acc += values[i] + step;
+    values[i] = acc;
+  }
+#endif
+}
+
+// Greatest common divisor of values[0..count), 0 if all are zero
+uint64_t common_factor(const uint64_t* values, size_t count) {
+  uint64_t g = 0;
+  for (size_t i = 0; i < count && g != 1; ++i) {
+    g = std::gcd(g, values[i]);
+  }
+  return g;
+}
+
+template<typename T>
+void append_pod(std::vector<uint8_t>& out, const T& value) {
+  const auto* p = reinterpret_cast<const uint8_t*>(&value);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+// ============================================================================
+// Compression
+// ============================================================================
+
+void compress_mbo(const MboMsg* records, size_t count, std::vector<uint8_t>& out) {
+  out.clear();
+  out.reserve(sizeof(FrameHeader) + count * sizeof(MboMsg) / 2 + TAIL_PADDING);
+
+  FrameHeader header{};
+  std::copy(std::begin(CODEC_MAGIC), std::end(CODEC_MAGIC), header.magic);
+  header.version = CODEC_VERSION;
+  header.block_records = MBO_CODEC_BLOCK;
+  header.count = count;
+  const auto* h = reinterpret_cast<const uint8_t*>(&header);
+  out.insert(out.end(), h, h + sizeof(header));
+
+  const auto* base = reinterpret_cast<const uint8_t*>(records);
+  uint64_t values[MBO_CODEC_BLOCK];
+  uint64_t deltas[MBO_CODEC_BLOCK];
+
+  for (size_t first = 0; first < count; first += MBO_CODEC_BLOCK) {
+    const size_t n = std::min(MBO_CODEC_BLOCK, count - first);
+    const uint8_t* block = base + first * sizeof(MboMsg);
+
+    for_each_field([&](auto field) {
+      constexpr size_t F = decltype(field)::value;
+      uint64_t lo = UINT64_MAX;
+      uint64_t hi = 0;
+      int64_t min_delta = INT64_MAX;
+      for (size_t i = 0; i < n; ++i) {
+        const uint64_t v = load_field<F>(block + i * sizeof(MboMsg));
+        values[i] = v;
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+        if (i > 0) {
+          min_delta = std::min(min_delta, static_cast<int64_t>(v - values[i - 1]));
+        }
+      }
+      if (n == 1) {
+        min_delta = 0;
+      }
+
+      // Delta candidate: the first record's delta is defined as min_delta
+      // so every packed delta is non-negative
+      const auto step = static_cast<uint64_t>(min_delta);
+      uint64_t max_delta = 0;
+      deltas[0] = 0;
+      for (size_t i = 1; i < n; ++i) {
+        deltas[i] = values[i] - values[i - 1] - step;
+        max_delta = std::max(max_delta, deltas[i]);
+      }
+      for (size_t i = 0; i < n; ++i) {
+        values[i] -= lo;
+      }
+
+      const uint64_t offset_scale = std::max<uint64_t>(1, common_factor(values, n));
+      const uint64_t delta_scale = std::max<uint64_t>(1, common_factor(deltas, n));
+      const unsigned offset_width = bit_width((hi - lo) / offset_scale);
+      const unsigned delta_width = bit_width(max_delta / delta_scale);
+      const bool use_delta = delta_width < offset_width;
+      const unsigned width = use_delta ? delta_width : offset_width;
+      const uint64_t scale = use_delta ? delta_scale : offset_scale;
+      uint64_t* packed = use_delta ? deltas : values;
+
+      uint8_t mode = 0;
+      mode |= use_delta ? MODE_DELTA : 0;
+      mode |= (scale > 1 && width > 0) ? MODE_SCALED : 0;
+      out.push_back(mode);
+      out.push_back(static_cast<uint8_t>(width));
+      append_pod(out, use_delta ? values[0] + lo - step : lo);
+      if (mode & MODE_DELTA) {
+        append_pod(out, step);
+      }
+      if (mode & MODE_SCALED) {
+        append_pod(out, scale);
+        for (size_t i = 0; i < n; ++i) {
+          packed[i] /= scale;
+        }
+      }
+      pack(packed, n, width, out);
+    });
+  }
+
+  out.resize(out.size() + TAIL_PADDING, 0);
+}
+
+std::vector<uint8_t> compress_mbo(const MboMsg* records, size_t count) {
+  std::vector<uint8_t> out;
+  compress_mbo(records, count, out);
+  return out;
+}
+
+// ============================================================================
+// Decompression
+// ============================================================================
+
+size_t compressed_mbo_count(const uint8_t* data, size_t size) {
+  FrameHeader header;
+  if (size < sizeof(header) + TAIL_PADDING) {
+    throw std::runtime_error("Compressed MBO buffer too small");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (!std::equal(std::begin(CODEC_MAGIC), std::end(CODEC_MAGIC), header.magic) ||
+      header.version != CODEC_VERSION || header.block_records != MBO_CODEC_BLOCK) {
+    throw std::runtime_error("Not a compressed MBO buffer");
+  }
+  return header.count;
+}
+
+void decompress_mbo(const uint8_t* data, size_t size, MboMsg* out) {
+  TraceSpan span("decompress_mbo", "codec");
+  const size_t count = compressed_mbo_count(data, size);
+  const uint8_t* pos = data + sizeof(FrameHeader);
+  const uint8_t* end = data + size - TAIL_PADDING;
+  auto* dst = reinterpret_cast<uint8_t*>(out);
+
+  // Fields are decoded column by column, then records are written in one
+  // sequential pass
+  alignas(32) uint64_t columns[NUM_FIELDS][MBO_CODEC_BLOCK];
+
+  for (size_t first = 0; first < count; first += MBO_CODEC_BLOCK) {
+    const size_t n = std::min(MBO_CODEC_BLOCK, count - first);
+    uint8_t* block = dst + first * sizeof(MboMsg);
+
+    for_each_field([&](auto field) {
+      constexpr size_t F = decltype(field)::value;
+      uint64_t* values = columns[F];
+      auto read_u64 = [&]() {
+        if (end - pos < 8) {
+          throw std::runtime_error("Compressed MBO buffer truncated");
+        }
+        uint64_t v;
+        std::memcpy(&v, pos, sizeof(v));
+        pos += sizeof(v);
+        return v;
+      };
+
+      if (end - pos < 2) {
+        throw std::runtime_error("Compressed MBO buffer truncated");
+      }
+      const uint8_t mode = pos[0];
+      const unsigned width = pos[1];
+      pos += 2;
+      const uint64_t reference = read_u64();
+      const uint64_t step = (mode & MODE_DELTA) ? read_u64() : 0;
+      const uint64_t scale = (mode & MODE_SCALED) ? read_u64() : 1;
+      const size_t bytes = packed_bytes(n, width);
+      if (width > 64 || static_cast<size_t>(end - pos) < bytes) {
+        throw std::runtime_error("Compressed MBO buffer corrupt");
+      }
+
+      const size_t rounded = (n + 7) & ~size_t{7};
+      if (width == 0) {
+        std::fill(values, values + rounded, mode & MODE_DELTA ? 0 : reference);
+        if (!(mode & MODE_DELTA)) {
+          return;
+        }
+      } else {
+        UNPACK[width](pos, rounded, values);
+        pos += bytes;
+      }
+      if (mode & MODE_SCALED) {
+        for (size_t i = 0; i < rounded; ++i) {
+          values[i] *= scale;
+        }
+      }
+      if (mode & MODE_DELTA) {
+        delta_decode(values, rounded, reference, step);
+      } else {
+        for (size_t i = 0; i < n; ++i) {
+          values[i] += reference;
+        }
+      }
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t* record = block + i * sizeof(MboMsg);
+      for_each_field([&](auto field) {
+        constexpr size_t F = decltype(field)::value;
+        store_field<F>(record, columns[F][i]);
+      });
+    }
+  }
+}
+
+std::vector<MboMsg> decompress_mbo(const uint8_t* data, size_t size) {
+  std::vector<MboMsg> out(compressed_mbo_count(data, size));
+  decompress_mbo(data, size, out.data());
+  return out;
+}
+
+} // namespace databento
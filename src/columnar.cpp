@@ -0,0 +1,710 @@
+#include "databento/columnar.hpp"
+#include "databento/parser.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'D', 'B', 'N', 'C', 'O', 'L', '0', '1'};
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr size_t MAX_DICT_SIZE = 65536;
+
+enum Encoding : uint8_t {
+  ENC_RAW = 0,     // [enc][width] values
+  ENC_DELTA = 1,   // [enc][width][u64 first] zigzag(delta)[rows - 1]
+  ENC_DICT = 2,    // [enc][code_bits][u32 n][value_width] dict[n] codes
+};
+
+#pragma pack(push, 1)
+
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t block_rows;
+  uint64_t num_rows;
+  uint64_t num_blocks;
+  uint64_t source_size;
+  int64_t source_mtime_ns;
+  uint64_t source_header_hash;
+  uint64_t directory_offset;
+};
+
+struct BlockMeta {
+  uint64_t first_row;
+  uint64_t rows;
+  uint64_t ts_min, ts_max;
+  uint32_t instrument_min, instrument_max;
+  int64_t price_min, price_max;
+  uint64_t column_offset[NUM_COLUMNS];
+};
+
+#pragma pack(pop)
+
+// ----------------------------------------------------------------------------
+// Source file identity
+// ----------------------------------------------------------------------------
+
+struct SourceKey {
+  uint64_t size;
+  int64_t mtime_ns;
+  uint64_t header_hash;
+};
+
+SourceKey source_key(const std::string& dbn_path) {
+  struct stat st;
+  if (::stat(dbn_path.c_str(), &st) != 0) {
+    throw std::runtime_error("Failed to stat file: " + dbn_path);
+  }
+
+  std::vector<char> header(DbnParser(dbn_path).metadata_offset());
+  std::ifstream in(dbn_path, std::ios::binary);
+  in.read(header.data(), static_cast<std::streamsize>(header.size()));
+
+  uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+  for (std::streamsize i = 0; i < in.gcount(); ++i) {
+    hash ^= static_cast<uint8_t>(header[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return SourceKey{static_cast<uint64_t>(st.st_size),
+                   static_cast<int64_t>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec,
+                   hash};
+}
+
+// ----------------------------------------------------------------------------
+// Encoding
+// ----------------------------------------------------------------------------
+
+inline uint64_t zigzag(uint64_t v) {
+  const int64_t s = static_cast<int64_t>(v);
+  return (static_cast<uint64_t>(s) << 1) ^ static_cast<uint64_t>(s >> 63);
+}
+
+inline uint64_t unzigzag(uint64_t v) {
+  return (v >> 1) ^ (~(v & 1) + 1);
+}
+
+uint8_t byte_width(uint64_t max_value) {
+  if (max_value <= 0xFF) return 1;
+  if (max_value <= 0xFFFF) return 2;
+  if (max_value <= 0xFFFFFFFFULL) return 4;
+  return 8;
+}
+
+uint8_t code_bits(size_t dict_size) {
+  if (dict_size <= 2) return 1;
+  if (dict_size <= 4) return 2;
+  if (dict_size <= 16) return 4;
+  if (dict_size <= 256) return 8;
+  return 16;
+}
+
+template<typename T>
+void append_pod(std::vector<uint8_t>& out, const T& value) {
+  const auto* p = reinterpret_cast<const uint8_t*>(&value);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+void append_width(std::vector<uint8_t>& out, uint64_t value, uint8_t width) {
+  const auto* p = reinterpret_cast<const uint8_t*>(&value);
+  out.insert(out.end(), p, p + width);  // Little-endian truncation
+}
+
+void encode_raw(const std::vector<uint64_t>& values, std::vector<uint8_t>& out) {
+  const uint64_t max_value = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+  const uint8_t width = byte_width(max_value);
+  out.push_back(ENC_RAW);
+  out.push_back(width);
+  for (uint64_t v : values) {
+    append_width(out, v, width);
+  }
+}
+
+void encode_delta(const std::vector<uint64_t>& values, std::vector<uint8_t>& out) {
+  uint64_t max_zz = 0;
+  for (size_t i = 1; i < values.size(); ++i) {
+    max_zz = std::max(max_zz, zigzag(values[i] - values[i - 1]));
+  }
+  const uint8_t width = byte_width(max_zz);
+  out.push_back(ENC_DELTA);
+  out.push_back(width);
+  append_pod(out, values.empty() ? uint64_t{0} : values[0]);
+  for (size_t i = 1; i < values.size(); ++i) {
+    append_width(out, zigzag(values[i] - values[i - 1]), width);
+  }
+}
+
+void encode_dict(const std::vector<uint64_t>& values, std::vector<uint8_t>& out) {
+  std::vector<uint64_t> dict(values);
+  std::sort(dict.begin(), dict.end());
+  dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+  if (dict.size() > MAX_DICT_SIZE) {
+    encode_raw(values, out);
+    return;
+  }
+
+  const uint8_t bits = code_bits(dict.size());
+  const uint8_t value_width = byte_width(dict.empty() ? 0 : dict.back());
+  out.push_back(ENC_DICT);
+  out.push_back(bits);
+  append_pod(out, static_cast<uint32_t>(dict.size()));
+  out.push_back(value_width);
+  for (uint64_t v : dict) {
+    append_width(out, v, value_width);
+  }
+
+  const size_t code_bytes = (values.size() * bits + 7) / 8;
+  const size_t start = out.size();
+  out.resize(start + code_bytes, 0);
+  uint8_t* codes = out.data() + start;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto code = static_cast<uint32_t>(
+        std::lower_bound(dict.begin(), dict.end(), values[i]) - dict.begin());
+    if (bits == 16) {
+      codes[2 * i] = static_cast<uint8_t>(code);
+      codes[2 * i + 1] = static_cast<uint8_t>(code >> 8);
+    } else {
+      const size_t bit = i * bits;
+      codes[bit / 8] |= static_cast<uint8_t>(code << (bit % 8));
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Decoding
+// ----------------------------------------------------------------------------
+
+template<typename W>
+inline uint64_t load_as(const uint8_t* p, size_t i) {
+  W v;
+  std::memcpy(&v, p + i * sizeof(W), sizeof(W));
+  return v;
+}
+
+// Invoke fn with a value of the unsigned type matching width
+template<typename Fn>
+void with_width(uint8_t width, Fn&& fn) {
+  switch (width) {
+    case 1: fn(uint8_t{}); break;
+    case 2: fn(uint16_t{}); break;
+    case 4: fn(uint32_t{}); break;
+    case 8: fn(uint64_t{}); break;
+    default: throw std::runtime_error("Corrupt columnar cache: bad width");
+  }
+}
+
+struct DictView {
+  uint8_t bits;
+  uint32_t size;
+  uint8_t value_width;
+  const uint8_t* values;
+  const uint8_t* codes;
+
+  uint64_t value(size_t i) const {
+    uint64_t v = 0;
+    std::memcpy(&v, values + i * value_width, value_width);
+    return v;
+  }
+};
+
+DictView dict_view(const uint8_t* col) {
+  DictView d;
+  d.bits = col[1];
+  std::memcpy(&d.size, col + 2, sizeof(uint32_t));
+  d.value_width = col[6];
+  d.values = col + 7;
+  d.codes = d.values + static_cast<size_t>(d.size) * d.value_width;
+  return d;
+}
+
+template<typename T>
+void decode_column(const uint8_t* col, size_t rows, T* out) {
+  const uint8_t enc = col[0];
+  if (enc == ENC_RAW) {
+    const uint8_t* p = col + 2;
+    with_width(col[1], [&](auto w) {
+      using W = decltype(w);
+      for (size_t i = 0; i < rows; ++i) {
+        out[i] = static_cast<T>(load_as<W>(p, i));
+      }
+    });
+  } else if (enc == ENC_DELTA) {
+    uint64_t acc;
+    std::memcpy(&acc, col + 2, sizeof(uint64_t));
+    const uint8_t* p = col + 10;
+    if (rows == 0) {
+      return;
+    }
+    out[0] = static_cast<T>(acc);
+    with_width(col[1], [&](auto w) {
+      using W = decltype(w);
+      for (size_t i = 1; i < rows; ++i) {
+        acc += unzigzag(load_as<W>(p, i - 1));
+        out[i] = static_cast<T>(acc);
+      }
+    });
+  } else if (enc == ENC_DICT) {
+    const DictView d = dict_view(col);
+    T lookup[256];
+    std::vector<T> big_lookup;
+    const T* table = lookup;
+    if (d.size <= 256) {
+      for (uint32_t i = 0; i < d.size; ++i) {
+        lookup[i] = static_cast<T>(d.value(i));
+      }
+    } else {
+      big_lookup.resize(d.size);
+      for (uint32_t i = 0; i < d.size; ++i) {
+        big_lookup[i] = static_cast<T>(d.value(i));
+      }
+      table = big_lookup.data();
+    }
+
+    switch (d.bits) {
+      case 16:
+        for (size_t i = 0; i < rows; ++i) {
+          out[i] = table[load_as<uint16_t>(d.codes, i)];
+        }
+        break;
+      case 8:
+        for (size_t i = 0; i < rows; ++i) {
+          out[i] = table[d.codes[i]];
+        }
+        break;
+      default: {
+        const unsigned bits = d.bits;
+        const unsigned mask = (1u << bits) - 1;
+        for (size_t i = 0; i < rows; ++i) {
+          const size_t bit = i * bits;
+          out[i] = table[(d.codes[bit / 8] >> (bit % 8)) & mask];
+        }
+      }
+    }
+  } else {
+    throw std::runtime_error("Corrupt columnar cache: bad encoding");
+  }
+}
+
+// Compact values[sel[k]] -> values[k]; sel is strictly increasing
+template<typename T>
+void compact(std::vector<T>& values, const std::vector<uint32_t>& sel) {
+  for (size_t k = 0; k < sel.size(); ++k) {
+    values[k] = values[sel[k]];
+  }
+}
+
+struct Scratch {
+  std::vector<uint64_t> ts_event;
+  std::vector<uint32_t> instrument_id;
+  std::vector<char> action;
+  std::vector<char> side;
+  std::vector<uint8_t> flags;
+  std::vector<uint8_t> depth;
+  std::vector<int64_t> price;
+  std::vector<uint32_t> size;
+  std::vector<uint32_t> channel_id;
+  std::vector<uint64_t> order_id;
+  std::vector<uint32_t> sequence;
+  std::vector<uint8_t> ts_in_delta;
+};
+
+} // namespace
+
+// ============================================================================
+// Building
+// ============================================================================
+
+void ColumnarCache::build(const std::string& dbn_path, const std::string& cache_path,
+                          const ColumnarOptions& options) {
+  if (options.block_rows == 0) {
+    throw std::invalid_argument("Columnar block size must be positive");
+  }
+  const SourceKey key = source_key(dbn_path);
+
+  DbnParser parser(dbn_path);
+  parser.load_into_memory();
+  const size_t total = parser.num_records();
+  const size_t num_blocks = (total + options.block_rows - 1) / options.block_rows;
+
+  std::ofstream out(cache_path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Failed to create columnar cache: " + cache_path);
+  }
+
+  CacheHeader header{};
+  std::copy(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic);
+  header.version = CACHE_VERSION;
+  header.block_rows = options.block_rows;
+  header.num_rows = total;
+  header.num_blocks = num_blocks;
+  header.source_size = key.size;
+  header.source_mtime_ns = key.mtime_ns;
+  header.source_header_hash = key.header_hash;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<BlockMeta> directory(num_blocks);
+  std::vector<std::vector<uint64_t>> columns(NUM_COLUMNS);
+  std::vector<uint8_t> encoded;
+  uint64_t offset = sizeof(header);
+
+  for (size_t b = 0; b < num_blocks; ++b) {
+    const size_t first = b * options.block_rows;
+    const size_t rows = std::min<size_t>(options.block_rows, total - first);
+    for (auto& col : columns) {
+      col.resize(rows);
+    }
+
+    BlockMeta& meta = directory[b];
+    meta.first_row = first;
+    meta.rows = rows;
+    meta.ts_min = UINT64_MAX;
+    meta.ts_max = 0;
+    meta.instrument_min = UINT32_MAX;
+    meta.instrument_max = 0;
+    meta.price_min = INT64_MAX;
+    meta.price_max = INT64_MIN;
+
+    const uint8_t* rec = parser.get_record(first);
+    for (size_t i = 0; i < rows; ++i, rec += parser.record_size()) {
+      const MboMsg m = parse_mbo(rec);
+      columns[static_cast<size_t>(Column::TsEvent)][i] = m.ts_event;
+      columns[static_cast<size_t>(Column::InstrumentId)][i] = m.instrument_id;
+      columns[static_cast<size_t>(Column::Action)][i] = static_cast<uint8_t>(m.action);
+      columns[static_cast<size_t>(Column::Side)][i] = static_cast<uint8_t>(m.side);
+      columns[static_cast<size_t>(Column::Flags)][i] = m.flags;
+      columns[static_cast<size_t>(Column::Depth)][i] = m.depth;
+      columns[static_cast<size_t>(Column::Price)][i] = static_cast<uint64_t>(m.price);
+      columns[static_cast<size_t>(Column::Size)][i] = m.size;
+      columns[static_cast<size_t>(Column::ChannelId)][i] = m.channel_id;
+      columns[static_cast<size_t>(Column::OrderId)][i] = m.order_id;
+      columns[static_cast<size_t>(Column::Sequence)][i] = m.sequence;
+      columns[static_cast<size_t>(Column::TsInDelta)][i] = m.ts_in_delta;
+
+      meta.ts_min = std::min(meta.ts_min, m.ts_event);
+      meta.ts_max = std::max(meta.ts_max, m.ts_event);
+      meta.instrument_min = std::min(meta.instrument_min, m.instrument_id);
+      meta.instrument_max = std::max(meta.instrument_max, m.instrument_id);
+      meta.price_min = std::min(meta.price_min, m.price);
+      meta.price_max = std::max(meta.price_max, m.price);
+    }
+
+    for (size_t c = 0; c < NUM_COLUMNS; ++c) {
+      encoded.clear();
+      switch (static_cast<Column>(c)) {
+        case Column::TsEvent:
+        case Column::Price:
+        case Column::OrderId:
+        case Column::Sequence:
+          encode_delta(columns[c], encoded);
+          break;
+        case Column::Size:
+        case Column::TsInDelta:
+          encode_raw(columns[c], encoded);
+          break;
+        default:
+          encode_dict(columns[c], encoded);
+          break;
+      }
+      meta.column_offset[c] = offset;
+      out.write(reinterpret_cast<const char*>(encoded.data()),
+                static_cast<std::streamsize>(encoded.size()));
+      offset += encoded.size();
+    }
+  }
+
+  header.directory_offset = offset;
+  out.write(reinterpret_cast<const char*>(directory.data()),
+            static_cast<std::streamsize>(directory.size() * sizeof(BlockMeta)));
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Failed to write columnar cache: " + cache_path);
+  }
+}
+
+ColumnarCache ColumnarCache::open_or_build(const std::string& dbn_path,
+                                           const std::string& cache_path,
+                                           const ColumnarOptions& options) {
+  const std::string path = cache_path.empty() ? dbn_path + ".col" : cache_path;
+
+  try {
+    ColumnarCache cache(path);
+    if (cache.is_current_for(dbn_path)) {
+      return cache;
+    }
+  } catch (const std::runtime_error&) {
+    // Missing or unreadable: rebuild below
+  }
+
+  // Build beside the target and rename so concurrent readers never see a
+  // partially written cache
+  const std::string tmp = path + ".tmp" + std::to_string(::getpid());
+  try {
+    build(dbn_path, tmp, options);
+  } catch (...) {
+    std::remove(tmp.c_str());
+    throw;
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Failed to install columnar cache: " + path);
+  }
+  return ColumnarCache(path);
+}
+
+// ============================================================================
+// Opening
+// ============================================================================
+
+ColumnarCache::ColumnarCache(const std::string& cache_path) : path_(cache_path) {
+  const int fd = ::open(cache_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open columnar cache: " + cache_path);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CacheHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Invalid columnar cache: " + cache_path);
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("Failed to map columnar cache: " + cache_path);
+  }
+  data_ = static_cast<const uint8_t*>(mapped);
+
+  CacheHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  const bool valid =
+      std::equal(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic) &&
+      header.version == CACHE_VERSION &&
+      header.directory_offset + header.num_blocks * sizeof(BlockMeta) <= size_;
+  if (!valid) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+    throw std::runtime_error("Invalid columnar cache: " + cache_path);
+  }
+}
+
+ColumnarCache::ColumnarCache(ColumnarCache&& other) noexcept
+    : data_(other.data_), size_(other.size_), path_(std::move(other.path_)) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+ColumnarCache::~ColumnarCache() {
+  if (data_) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+bool ColumnarCache::is_current_for(const std::string& dbn_path) const {
+  CacheHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  const SourceKey key = source_key(dbn_path);
+  return header.source_size == key.size && header.source_mtime_ns == key.mtime_ns &&
+         header.source_header_hash == key.header_hash;
+}
+
+uint64_t ColumnarCache::num_rows() const {
+  CacheHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  return header.num_rows;
+}
+
+size_t ColumnarCache::num_blocks() const {
+  CacheHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  return header.num_blocks;
+}
+
+const uint8_t* ColumnarCache::block_meta(size_t block) const {
+  CacheHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (block >= header.num_blocks) {
+    throw std::out_of_range("Block index out of range");
+  }
+  return data_ + header.directory_offset + block * sizeof(BlockMeta);
+}
+
+ZoneMap ColumnarCache::zone_map(size_t block) const {
+  BlockMeta meta;
+  std::memcpy(&meta, block_meta(block), sizeof(meta));
+  return ZoneMap{meta.ts_min, meta.ts_max, meta.instrument_min, meta.instrument_max,
+                 meta.price_min, meta.price_max};
+}
+
+// ============================================================================
+// Scanning
+// ============================================================================
+
+ScanStats ColumnarCache::scan(const ScanPredicate& predicate, ColumnMask projection,
+                              const std::function<void(const ColumnBatch&)>& callback) const {
+  ScanStats stats;
+  const size_t blocks = num_blocks();
+  stats.blocks_total = blocks;
+
+  std::vector<uint32_t> wanted(predicate.instrument_ids);
+  std::sort(wanted.begin(), wanted.end());
+  const bool filter_instrument = !wanted.empty();
+
+  Scratch s;
+  std::vector<uint32_t> sel;
+
+  for (size_t b = 0; b < blocks; ++b) {
+    BlockMeta meta;
+    std::memcpy(&meta, block_meta(b), sizeof(meta));
+    const size_t rows = meta.rows;
+    auto column = [&](Column c) { return data_ + meta.column_offset[static_cast<size_t>(c)]; };
+
+    // Zone maps
+    bool skip = meta.ts_max < predicate.ts_min || meta.ts_min > predicate.ts_max ||
+                meta.price_max < predicate.price_min || meta.price_min > predicate.price_max;
+    bool instrument_rows = false;
+    if (!skip && filter_instrument) {
+      auto lo = std::lower_bound(wanted.begin(), wanted.end(), meta.instrument_min);
+      skip = lo == wanted.end() || *lo > meta.instrument_max;
+
+      // The block dictionary gives an exact membership test
+      const uint8_t* col = column(Column::InstrumentId);
+      if (!skip && col[0] == ENC_DICT) {
+        const DictView d = dict_view(col);
+        size_t hits = 0;
+        for (uint32_t i = 0; i < d.size; ++i) {
+          hits += std::binary_search(wanted.begin(), wanted.end(),
+                                     static_cast<uint32_t>(d.value(i)));
+        }
+        skip = hits == 0;
+        instrument_rows = hits != d.size;
+      } else {
+        instrument_rows = true;
+      }
+    }
+    if (skip) {
+      ++stats.blocks_skipped;
+      continue;
+    }
+
+    const bool ts_rows = meta.ts_min < predicate.ts_min || meta.ts_max > predicate.ts_max;
+    const bool price_rows = meta.price_min < predicate.price_min ||
+                            meta.price_max > predicate.price_max;
+    const bool action_rows = predicate.action != 0;
+    const bool side_rows = predicate.side != 0;
+
+    ColumnMask needed = projection;
+    if (ts_rows) needed |= column_bit(Column::TsEvent);
+    if (instrument_rows) needed |= column_bit(Column::InstrumentId);
+    if (price_rows) needed |= column_bit(Column::Price);
+    if (action_rows) needed |= column_bit(Column::Action);
+    if (side_rows) needed |= column_bit(Column::Side);
+
+    auto decode = [&](Column c, auto& vec) {
+      if (needed & column_bit(c)) {
+        vec.resize(rows);
+        decode_column(column(c), rows, vec.data());
+      }
+    };
+    decode(Column::TsEvent, s.ts_event);
+    decode(Column::InstrumentId, s.instrument_id);
+    decode(Column::Action, s.action);
+    decode(Column::Side, s.side);
+    decode(Column::Flags, s.flags);
+    decode(Column::Depth, s.depth);
+    decode(Column::Price, s.price);
+    decode(Column::Size, s.size);
+    decode(Column::ChannelId, s.channel_id);
+    decode(Column::OrderId, s.order_id);
+    decode(Column::Sequence, s.sequence);
+    decode(Column::TsInDelta, s.ts_in_delta);
+    stats.rows_scanned += rows;
+
+    size_t matched = rows;
+    if (ts_rows || instrument_rows || price_rows || action_rows || side_rows) {
+      sel.clear();
+      for (size_t i = 0; i < rows; ++i) {
+        bool ok = true;
+        if (ts_rows) {
+          ok &= s.ts_event[i] >= predicate.ts_min && s.ts_event[i] <= predicate.ts_max;
+        }
+        if (price_rows) {
+          ok &= s.price[i] >= predicate.price_min && s.price[i] <= predicate.price_max;
+        }
+        if (action_rows) {
+          ok &= s.action[i] == predicate.action;
+        }
+        if (side_rows) {
+          ok &= s.side[i] == predicate.side;
+        }
+        if (ok && instrument_rows) {
+          ok = std::binary_search(wanted.begin(), wanted.end(), s.instrument_id[i]);
+        }
+        if (ok) {
+          sel.push_back(static_cast<uint32_t>(i));
+        }
+      }
+      matched = sel.size();
+      if (matched == 0) {
+        continue;
+      }
+      if (matched != rows) {
+        auto project = [&](Column c, auto& vec) {
+          if (projection & column_bit(c)) {
+            compact(vec, sel);
+          }
+        };
+        project(Column::TsEvent, s.ts_event);
+        project(Column::InstrumentId, s.instrument_id);
+        project(Column::Action, s.action);
+        project(Column::Side, s.side);
+        project(Column::Flags, s.flags);
+        project(Column::Depth, s.depth);
+        project(Column::Price, s.price);
+        project(Column::Size, s.size);
+        project(Column::ChannelId, s.channel_id);
+        project(Column::OrderId, s.order_id);
+        project(Column::Sequence, s.sequence);
+        project(Column::TsInDelta, s.ts_in_delta);
+      }
+    }
+    stats.rows_matched += matched;
+
+    ColumnBatch batch;
+    batch.rows = matched;
+    batch.first_row = meta.first_row;
+    if (matched != rows) {
+      batch.row_index = sel.data();
+    }
+    auto expose = [&](Column c, auto& vec, auto& ptr) {
+      if (projection & column_bit(c)) {
+        ptr = vec.data();
+      }
+    };
+    expose(Column::TsEvent, s.ts_event, batch.ts_event);
+    expose(Column::InstrumentId, s.instrument_id, batch.instrument_id);
+    expose(Column::Action, s.action, batch.action);
+    expose(Column::Side, s.side, batch.side);
+    expose(Column::Flags, s.flags, batch.flags);
+    expose(Column::Depth, s.depth, batch.depth);
+    expose(Column::Price, s.price, batch.price);
+    expose(Column::Size, s.size, batch.size);
+    expose(Column::ChannelId, s.channel_id, batch.channel_id);
+    expose(Column::OrderId, s.order_id, batch.order_id);
+    expose(Column::Sequence, s.sequence, batch.sequence);
+    expose(Column::TsInDelta, s.ts_in_delta, batch.ts_in_delta);
+    callback(batch);
+  }
+  return stats;
+}
+
+} // namespace databento
@@ -0,0 +1,423 @@
+#include "databento/export.hpp"
+#include "databento/fields.hpp"
+#include "databento/io.hpp"
+#include "databento/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+// Databento's null price
+constexpr int64_t UNDEF_PRICE = INT64_MAX;
+constexpr uint64_t NS_PER_SECOND = 1'000'000'000;
+
+// ----------------------------------------------------------------------------
+// Number Formatting
+// ----------------------------------------------------------------------------
+
+// "00".."99": two digits per lookup and one 2-byte store
+constexpr auto DIGIT_PAIRS = [] {
+  std::array<char, 200> table{};
+  for (int i = 0; i < 100; ++i) {
+    table[2 * i] = static_cast<char>('0' + i / 10);
+    table[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return table;
+}();
+
+int count_digits(uint64_t v) {
+  int n = 1;
+  for (;;) {
+    if (v < 10) return n;
+    if (v < 100) return n + 1;
+    if (v < 1000) return n + 2;
+    if (v < 10000) return n + 3;
+    v /= 10000;
+    n += 4;
+  }
+}
+
+// Exactly `digits` digits, zero padded, filled from the right
+char* write_padded(char* p, uint64_t v, int digits) {
+  char* const end = p + digits;
+  char* q = end;
+  while (digits >= 2) {
+    q -= 2;
+    std::memcpy(q, &DIGIT_PAIRS[2 * (v % 100)], 2);
+    v /= 100;
+    digits -= 2;
+  }
+  if (digits) {
+    *--q = static_cast<char>('0' + v % 10);
+  }
+  return end;
+}
+
+char* write_u64(char* p, uint64_t v) {
+  return write_padded(p, v, count_digits(v));
+}
+
+char* write_i64(char* p, int64_t v) {
+  if (v < 0) {
+    *p++ = '-';
+    return write_u64(p, 0 - static_cast<uint64_t>(v));
+  }
+  return write_u64(p, static_cast<uint64_t>(v));
+}
+
+// 1e-9 fixed point as "[-]units.nnnnnnnnn"
+char* write_price(char* p, int64_t price) {
+  uint64_t magnitude = static_cast<uint64_t>(price);
+  if (price < 0) {
+    *p++ = '-';
+    magnitude = 0 - magnitude;
+  }
+  p = write_u64(p, magnitude / NS_PER_SECOND);
+  *p++ = '.';
+  return write_padded(p, magnitude % NS_PER_SECOND, 9);
+}
+
+template<size_t N>
+char* write_literal(char* p, const char (&text)[N]) {
+  std::memcpy(p, text, N - 1);
+  return p + N - 1;
+}
+
+// ----------------------------------------------------------------------------
+// Timestamps
+// ----------------------------------------------------------------------------
+
+// "YYYY-MM-DDTHH:MM:SS" of the last second seen. Consecutive records are
+// almost always in the same second, so the calendar math rarely runs.
+struct TimestampCache {
+  uint64_t second = UINT64_MAX;
+  char prefix[19];
+
+  void update(uint64_t s) {
+    second = s;
+    // Days to civil date (H. Hinnant's algorithm), valid for all u64 ns
+    const uint64_t z = s / 86400 + 719468;
+    const uint64_t era = z / 146097;
+    const uint64_t doe = z - era * 146097;
+    const uint64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint64_t mp = (5 * doy + 2) / 153;
+    const uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+    const uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const uint64_t year = yoe + era * 400 + (month <= 2);
+    const uint64_t sod = s % 86400;
+
+    char* p = write_padded(prefix, year, 4);
+    *p++ = '-';
+    p = write_padded(p, month, 2);
+    *p++ = '-';
+    p = write_padded(p, day, 2);
+    *p++ = 'T';
+    p = write_padded(p, sod / 3600, 2);
+    *p++ = ':';
+    p = write_padded(p, sod / 60 % 60, 2);
+    *p++ = ':';
+    write_padded(p, sod % 60, 2);
+  }
+};
+
+char* write_iso_timestamp(char* p, uint64_t ns, TimestampCache& cache) {
+  const uint64_t second = ns / NS_PER_SECOND;
+  if (second != cache.second) {
+    cache.update(second);
+  }
+  std::memcpy(p, cache.prefix, sizeof(cache.prefix));
+  p += sizeof(cache.prefix);
+  *p++ = '.';
+  p = write_padded(p, ns % NS_PER_SECOND, 9);
+  *p++ = 'Z';
+  return p;
+}
+
+// ----------------------------------------------------------------------------
+// Single-Character Fields
+// ----------------------------------------------------------------------------
+
+// NUL is an empty field; separators and quotes get CSV quoting
+char* write_csv_char(char* p, char c) {
+  if (c == '\0') {
+    return p;
+  }
+  if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+    *p++ = '"';
+    if (c == '"') {
+      *p++ = '"';
+    }
+    *p++ = c;
+    *p++ = '"';
+    return p;
+  }
+  *p++ = c;
+  return p;
+}
+
+char* write_json_char(char* p, char c) {
+  *p++ = '"';
+  const auto u = static_cast<unsigned char>(c);
+  if (c == '"' || c == '\\') {
+    *p++ = '\\';
+    *p++ = c;
+  } else if (u >= 0x20 && u < 0x80) {
+    *p++ = c;
+  } else if (u != 0) {
+    // Control and non-ASCII bytes as \u00XX (Latin-1), keeping output UTF-8
+    static constexpr char HEX[] = "0123456789abcdef";
+    p = write_literal(p, "\\u00");
+    *p++ = HEX[u >> 4];
+    *p++ = HEX[u & 0xF];
+  }
+  *p++ = '"';
+  return p;
+}
+
+// ----------------------------------------------------------------------------
+// Records
+// ----------------------------------------------------------------------------
+
+char* encode_csv(char* p, const MboMsg& m, const ExportOptions& options, TimestampCache& cache) {
+  p = options.iso_timestamps ? write_iso_timestamp(p, m.ts_event, cache) : write_u64(p, m.ts_event);
+  *p++ = ',';
+  p = write_u64(p, m.instrument_id);
+  *p++ = ',';
+  p = write_csv_char(p, m.action);
+  *p++ = ',';
+  p = write_csv_char(p, m.side);
+  *p++ = ',';
+  p = write_u64(p, m.flags);
+  *p++ = ',';
+  p = write_u64(p, m.depth);
+  *p++ = ',';
+  if (m.price != UNDEF_PRICE) {
+    p = options.decimal_prices ? write_price(p, m.price) : write_i64(p, m.price);
+  }
+  *p++ = ',';
+  p = write_u64(p, m.size);
+  *p++ = ',';
+  p = write_u64(p, m.channel_id);
+  *p++ = ',';
+  p = write_u64(p, m.order_id);
+  *p++ = ',';
+  p = write_u64(p, m.sequence);
+  *p++ = ',';
+  p = write_u64(p, m.ts_in_delta);
+  *p++ = '\n';
+  return p;
+}
+
+char* encode_json(char* p, const MboMsg& m, const ExportOptions& options, TimestampCache& cache) {
+  p = write_literal(p, "{\"ts_event\":");
+  if (options.iso_timestamps) {
+    *p++ = '"';
+    p = write_iso_timestamp(p, m.ts_event, cache);
+    *p++ = '"';
+  } else {
+    p = write_u64(p, m.ts_event);
+  }
+  p = write_literal(p, ",\"instrument_id\":");
+  p = write_u64(p, m.instrument_id);
+  p = write_literal(p, ",\"action\":");
+  p = write_json_char(p, m.action);
+  p = write_literal(p, ",\"side\":");
+  p = write_json_char(p, m.side);
+  p = write_literal(p, ",\"flags\":");
+  p = write_u64(p, m.flags);
+  p = write_literal(p, ",\"depth\":");
+  p = write_u64(p, m.depth);
+  p = write_literal(p, ",\"price\":");
+  if (m.price == UNDEF_PRICE) {
+    p = write_literal(p, "null");
+  } else if (options.decimal_prices) {
+    *p++ = '"';
+    p = write_price(p, m.price);
+    *p++ = '"';
+  } else {
+    p = write_i64(p, m.price);
+  }
+  p = write_literal(p, ",\"size\":");
+  p = write_u64(p, m.size);
+  p = write_literal(p, ",\"channel_id\":");
+  p = write_u64(p, m.channel_id);
+  p = write_literal(p, ",\"order_id\":");
+  p = write_u64(p, m.order_id);
+  p = write_literal(p, ",\"sequence\":");
+  p = write_u64(p, m.sequence);
+  p = write_literal(p, ",\"ts_in_delta\":");
+  p = write_u64(p, m.ts_in_delta);
+  p = write_literal(p, "}\n");
+  return p;
+}
+
+template<bool Json>
+size_t encode_records(const query::RecordRange& records, const ExportOptions& options, char* out) {
+  TimestampCache cache;
+  char* p = out;
+  const uint8_t* record = records.data;
+  for (size_t i = 0; i < records.count; ++i, record += records.stride) {
+    const MboMsg msg = parse_mbo(record);
+    p = Json ? encode_json(p, msg, options, cache) : encode_csv(p, msg, options, cache);
+  }
+  return static_cast<size_t>(p - out);
+}
+
+} // namespace
+
+// ============================================================================
+// ExportStats
+// ============================================================================
+
+void ExportStats::print() const {
+  std::cout << "\n" << std::string(70, '=') << "\n";
+  std::cout << "Text Export Statistics\n";
+  std::cout << std::string(70, '=') << "\n";
+  std::cout << "Total records:  " << records << "\n";
+  std::cout << "Bytes written:  " << bytes_written << "\n";
+  std::cout << "Threads:        " << threads << "\n";
+  std::cout << "Elapsed time:   " << elapsed_seconds << " seconds\n";
+  std::cout << "Throughput:     " << megabytes_per_second() << " MB/s\n";
+  std::cout << std::string(70, '=') << "\n";
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+std::string text_header(const ExportOptions& options) {
+  if (options.format != TextFormat::Csv || !options.header) {
+    return {};
+  }
+  const char* names[] = {
+      FieldTraits<&MboMsg::ts_event>::name,   FieldTraits<&MboMsg::instrument_id>::name,
+      FieldTraits<&MboMsg::action>::name,     FieldTraits<&MboMsg::side>::name,
+      FieldTraits<&MboMsg::flags>::name,      FieldTraits<&MboMsg::depth>::name,
+      FieldTraits<&MboMsg::price>::name,      FieldTraits<&MboMsg::size>::name,
+      FieldTraits<&MboMsg::channel_id>::name, FieldTraits<&MboMsg::order_id>::name,
+      FieldTraits<&MboMsg::sequence>::name,   FieldTraits<&MboMsg::ts_in_delta>::name,
+  };
+  std::string header;
+  for (const char* name : names) {
+    if (!header.empty()) {
+      header += ',';
+    }
+    header += name;
+  }
+  header += '\n';
+  return header;
+}
+
+size_t encode_mbo_text(const query::RecordRange& records, const ExportOptions& options, char* out) {
+  return options.format == TextFormat::JsonLines ? encode_records<true>(records, options, out)
+                                                 : encode_records<false>(records, options, out);
+}
+
+// ============================================================================
+// Parallel Export
+// ============================================================================
+
+ExportStats export_mbo_text(const query::RecordRange& records, const std::string& output_path,
+                            const ExportOptions& options) {
+  if (options.chunk_records == 0) {
+    throw std::invalid_argument("chunk_records must be positive");
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  const int fd = ::open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to create file: " + output_path);
+  }
+
+  const size_t chunks = (records.count + options.chunk_records - 1) / options.chunk_records;
+  const unsigned threads = static_cast<unsigned>(
+      std::min<size_t>(resolve_thread_count(options.threads), std::max<size_t>(1, chunks)));
+  const size_t rounds = (chunks + threads - 1) / threads;
+
+  // Round r: thread t encodes chunk r * threads + t into its own buffer.
+  // At the barrier the sizes become file offsets (in chunk order), then
+  // each thread pwrites its buffer while the others move on.
+  const std::string header = text_header(options);
+  std::vector<size_t> sizes(threads, 0);
+  std::vector<uint64_t> offsets(threads, 0);
+  uint64_t end_offset = header.size();
+  auto assign_offsets = [&]() noexcept {
+    for (unsigned t = 0; t < threads; ++t) {
+      offsets[t] = end_offset;
+      end_offset += sizes[t];
+    }
+  };
+  std::barrier sync(static_cast<std::ptrdiff_t>(threads), assign_offsets);
+  std::atomic<bool> failed{false};
+
+  try {
+    if (!header.empty()) {
+      pwrite_all(fd, header.data(), header.size(), 0, output_path);
+    }
+    parallel_for(threads, [&](unsigned t) {
+      // Uninitialised: only the encoded prefix is ever read
+      auto buffer = std::make_unique_for_overwrite<char[]>(options.chunk_records * MAX_TEXT_RECORD_BYTES);
+      std::exception_ptr error;
+      for (size_t round = 0; round < rounds; ++round) {
+        sizes[t] = 0;
+        const size_t chunk = round * threads + t;
+        if (chunk < chunks && !failed.load(std::memory_order_relaxed)) {
+          try {
+            const size_t first = chunk * options.chunk_records;
+            const size_t count = std::min(options.chunk_records, records.count - first);
+            sizes[t] = encode_mbo_text(
+                query::RecordRange(records.data + first * records.stride, count, records.stride),
+                options, buffer.get());
+          } catch (...) {
+            error = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+          }
+        }
+        // Every thread arrives every round, even after a failure
+        sync.arrive_and_wait();
+        if (sizes[t] > 0 && !error) {
+          try {
+            pwrite_all(fd, buffer.get(), sizes[t], offsets[t], output_path);
+          } catch (...) {
+            error = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+          }
+        }
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    });
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  if (::close(fd) != 0) {
+    throw std::runtime_error("Failed to write file: " + output_path);
+  }
+
+  ExportStats stats;
+  stats.records = records.count;
+  stats.bytes_written = end_offset;
+  stats.threads = threads;
+  stats.elapsed_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+} // namespace databento
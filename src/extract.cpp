@@ -0,0 +1,231 @@
+#include "databento/extract.hpp"
+#include "databento/dbn.hpp"
+#include "databento/io.hpp"
+#include "databento/parser.hpp"
+#include "databento/trace.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+namespace databento {
+
+namespace {
+
+// Closes on scope exit
+class FileDescriptor {
+public:
+  FileDescriptor(int fd) : fd_(fd) {}
+  ~FileDescriptor() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int get() const { return fd_; }
+
+private:
+  int fd_;
+};
+
+// Metadata and record sizes as DbnParser sees them, plus the count of
+// complete records
+struct Layout {
+  size_t metadata_size;
+  size_t record_size;
+  uint64_t num_records;
+};
+
+Layout layout_of(int fd, const std::string& path) {
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    throw std::runtime_error("Failed to stat file: " + path);
+  }
+  const DbnParser parser(path);
+  const auto size = static_cast<uint64_t>(st.st_size);
+  Layout layout{parser.metadata_offset(), parser.record_size(), 0};
+  if (size > layout.metadata_size) {
+    layout.num_records = (size - layout.metadata_size) / layout.record_size;
+  }
+  return layout;
+}
+
+// First record with ts_event >= ts
+uint64_t lower_bound_ts(int fd, const Layout& layout, uint64_t ts, const std::string& path) {
+  uint64_t lo = 0;
+  uint64_t hi = layout.num_records;
+  while (lo < hi) {
+    const uint64_t mid = lo + (hi - lo) / 2;
+    uint64_t mid_ts;
+    pread_all(fd, &mid_ts, sizeof(mid_ts),
+              layout.metadata_size + mid * layout.record_size + offsetof(MboMsg, ts_event), path);
+    if (mid_ts < ts) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+RecordSpan find_span(int fd, const Layout& layout, uint64_t start_ts, uint64_t end_ts,
+                     const std::string& path) {
+  if (start_ts > end_ts) {
+    throw std::invalid_argument("Time range start is after its end");
+  }
+  const uint64_t first = lower_bound_ts(fd, layout, start_ts, path);
+  const uint64_t last = std::max(first, lower_bound_ts(fd, layout, end_ts, path));
+  return {first, last};
+}
+
+// Each in-kernel copier returns the bytes it moved before giving up; an
+// error before the first byte means "not supported here", after it is fatal
+
+bool unsupported(int err) {
+  return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP || err == EBADF;
+}
+
+#ifdef __linux__
+
+uint64_t copy_with_copy_file_range(int in, int out, uint64_t in_offset, uint64_t out_offset,
+                                   uint64_t bytes, const std::string& path) {
+  loff_t src = static_cast<loff_t>(in_offset);
+  loff_t dst = static_cast<loff_t>(out_offset);
+  uint64_t copied = 0;
+  while (copied < bytes) {
+    const ssize_t n = ::copy_file_range(in, &src, out, &dst, bytes - copied, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && copied == 0 && unsupported(errno)) {
+      return 0;
+    }
+    if (n <= 0) {
+      throw std::runtime_error("Failed to copy records into: " + path);
+    }
+    copied += static_cast<uint64_t>(n);
+  }
+  return copied;
+}
+
+uint64_t copy_with_sendfile(int in, int out, uint64_t in_offset, uint64_t out_offset,
+                            uint64_t bytes, const std::string& path) {
+  if (::lseek(out, static_cast<off_t>(out_offset), SEEK_SET) < 0) {
+    return 0;
+  }
+  off_t src = static_cast<off_t>(in_offset);
+  uint64_t copied = 0;
+  while (copied < bytes) {
+    const ssize_t n = ::sendfile(out, in, &src, bytes - copied);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && copied == 0 && unsupported(errno)) {
+      return 0;
+    }
+    if (n <= 0) {
+      throw std::runtime_error("Failed to copy records into: " + path);
+    }
+    copied += static_cast<uint64_t>(n);
+  }
+  return copied;
+}
+
+#endif
+
+void copy_with_read_write(int in, int out, uint64_t in_offset, uint64_t out_offset,
+                          uint64_t bytes, const std::string& input_path,
+                          const std::string& output_path) {
+  std::vector<uint8_t> buffer(std::min<uint64_t>(bytes, uint64_t{4} << 20));
+  while (bytes > 0) {
+    const size_t len = static_cast<size_t>(std::min<uint64_t>(bytes, buffer.size()));
+    pread_all(in, buffer.data(), len, in_offset, input_path);
+    pwrite_all(out, buffer.data(), len, out_offset, output_path);
+    in_offset += len;
+    out_offset += len;
+    bytes -= len;
+  }
+}
+
+} // namespace
+
+const char* copy_method_name(CopyMethod method) {
+  switch (method) {
+    case CopyMethod::None: return "none";
+    case CopyMethod::CopyFileRange: return "copy_file_range";
+    case CopyMethod::Sendfile: return "sendfile";
+    case CopyMethod::ReadWrite: return "read/write";
+  }
+  return "unknown";
+}
+
+RecordSpan find_time_range(const std::string& path, uint64_t start_ts, uint64_t end_ts) {
+  const FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.get() < 0) {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  return find_span(fd.get(), layout_of(fd.get(), path), start_ts, end_ts, path);
+}
+
+ExtractResult extract_time_range(const std::string& input_path, const std::string& output_path,
+                                 uint64_t start_ts, uint64_t end_ts,
+                                 const ExtractOptions& options) {
+  TraceSpan trace("extract_time_range", "io");
+  const FileDescriptor in(::open(input_path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (in.get() < 0) {
+    throw std::runtime_error("Failed to open file: " + input_path);
+  }
+  const Layout layout = layout_of(in.get(), input_path);
+  const RecordSpan span = find_span(in.get(), layout, start_ts, end_ts, input_path);
+
+  const FileDescriptor out(::open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (out.get() < 0) {
+    throw std::runtime_error("Failed to create file: " + output_path);
+  }
+
+  // The metadata block is small; copy it through user space
+  std::vector<uint8_t> metadata(layout.metadata_size);
+  pread_all(in.get(), metadata.data(), metadata.size(), 0, input_path);
+  pwrite_all(out.get(), metadata.data(), metadata.size(), 0, output_path);
+
+  ExtractResult result;
+  result.first_record = span.first;
+  result.num_records = span.last - span.first;
+  result.bytes_copied = result.num_records * layout.record_size;
+
+  const uint64_t src = layout.metadata_size + span.first * layout.record_size;
+  const uint64_t dst = layout.metadata_size;
+  uint64_t done = 0;
+#ifdef __linux__
+  if (options.kernel_copy && done < result.bytes_copied) {
+    done = copy_with_copy_file_range(in.get(), out.get(), src, dst, result.bytes_copied,
+                                     output_path);
+    result.method = done > 0 ? CopyMethod::CopyFileRange : result.method;
+  }
+  if (options.kernel_copy && done < result.bytes_copied) {
+    done = copy_with_sendfile(in.get(), out.get(), src, dst, result.bytes_copied, output_path);
+    result.method = done > 0 ? CopyMethod::Sendfile : result.method;
+  }
+#else
+  (void)options;
+#endif
+  if (done < result.bytes_copied) {
+    copy_with_read_write(in.get(), out.get(), src, dst, result.bytes_copied, input_path,
+                         output_path);
+    result.method = CopyMethod::ReadWrite;
+  }
+  return result;
+}
+
+} // namespace databento
@@ -0,0 +1,408 @@
+#include "databento/generator.hpp"
+#include "databento/io.hpp"
+#include "databento/parallel.hpp"
+#include "databento/trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+constexpr size_t METADATA_SIZE = 200;
+constexpr uint64_t ORDER_ID_BASE = 1'000'000;
+constexpr size_t PATH_REFRESH = 4096;  // Records between mid path updates
+
+// ----------------------------------------------------------------------------
+// Portable RNG (std distributions differ between standard libraries)
+// ----------------------------------------------------------------------------
+
+inline uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// xoshiro256**
+class Rng {
+public:
+  Rng(uint64_t seed, uint64_t stream) {
+    uint64_t sm = seed ^ (stream * 0xd1b54a32d192ed03ULL);
+    for (auto& word : s_) {
+      word = splitmix64(sm);
+    }
+  }
+
+  uint64_t next() {
+    const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // [0, 1)
+  double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+  // [0, n)
+  uint64_t below(uint64_t n) { return static_cast<uint64_t>(uniform() * static_cast<double>(n)); }
+
+  bool chance(double p) { return uniform() < p; }
+
+  // Mean 1
+  double exponential() { return -std::log(1.0 - uniform()); }
+
+private:
+  uint64_t s_[4];
+
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// ----------------------------------------------------------------------------
+// Shared plan (computed once, read by every chunk)
+// ----------------------------------------------------------------------------
+
+constexpr size_t SIZE_TABLE_BITS = 12;
+
+struct Plan {
+  size_t num_chunks;
+  // Walker alias table for the Zipf instrument distribution: O(1) samples
+  std::vector<double> alias_prob;
+  std::vector<uint32_t> alias;
+  // Quantiles of the heavy-tailed order size distribution
+  std::vector<uint32_t> sizes;
+  std::vector<int64_t> mids;           // [chunk boundary][instrument], num_chunks + 1 rows
+};
+
+void build_alias_table(const std::vector<double>& weights, Plan& plan) {
+  const size_t n = weights.size();
+  double total = 0;
+  for (double w : weights) {
+    total += w;
+  }
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < n; ++i) {
+    scaled[i] = weights[i] * n / total;
+    (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+  }
+  plan.alias_prob.assign(n, 1.0);
+  plan.alias.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    plan.alias[i] = static_cast<uint32_t>(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    const uint32_t s = small.back();
+    small.pop_back();
+    const uint32_t l = large.back();
+    plan.alias_prob[s] = scaled[s];
+    plan.alias[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+}
+
+Plan make_plan(const GeneratorOptions& options) {
+  if (options.num_instruments == 0 || options.chunk_records == 0 || options.levels == 0 ||
+      options.tick_size <= 0) {
+    throw std::invalid_argument("Invalid generator options");
+  }
+  const ActionMix& mix = options.action_mix;
+  if (mix.add < 0 || mix.cancel < 0 || mix.modify < 0 || mix.trade < 0 ||
+      mix.add + mix.cancel + mix.modify + mix.trade <= 0) {
+    throw std::invalid_argument("Action mix weights must be non-negative with a positive sum");
+  }
+
+  Plan plan;
+  plan.num_chunks = (options.num_records + options.chunk_records - 1) / options.chunk_records;
+
+  const uint32_t n = options.num_instruments;
+  std::vector<double> weights(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), options.instrument_skew);
+  }
+  build_alias_table(weights, plan);
+
+  // Pareto(1.5) sizes in [1, 1000], sampled by quantile
+  plan.sizes.resize(size_t{1} << SIZE_TABLE_BITS);
+  for (size_t q = 0; q < plan.sizes.size(); ++q) {
+    const double u = (q + 0.5) / plan.sizes.size();
+    const double pareto = std::pow(1.0 - u, -1.0 / 1.5);
+    plan.sizes[q] = static_cast<uint32_t>(std::min(1000.0, 1.0 + std::floor((pareto - 1.0) * 3.0)));
+  }
+
+  // Coarse random walk of each instrument's mid at chunk boundaries, so
+  // independently generated chunks join up
+  Rng rng(options.seed, ~uint64_t{0});
+  plan.mids.resize((plan.num_chunks + 1) * n);
+  for (uint32_t i = 0; i < n; ++i) {
+    const int64_t base_ticks = (100 + 53 * static_cast<int64_t>(i)) * 1'000'000'000LL /
+                               options.tick_size;
+    plan.mids[i] = base_ticks * options.tick_size;
+  }
+  for (size_t c = 1; c <= plan.num_chunks; ++c) {
+    for (uint32_t i = 0; i < n; ++i) {
+      const int64_t step = static_cast<int64_t>(rng.below(7)) - 3;
+      const int64_t prev = plan.mids[(c - 1) * n + i];
+      plan.mids[c * n + i] = std::max(prev + step * options.tick_size,
+                                      (options.levels + 1) * options.tick_size);
+    }
+  }
+  return plan;
+}
+
+// ----------------------------------------------------------------------------
+// Chunk generation
+// ----------------------------------------------------------------------------
+
+struct LiveOrder {
+  uint64_t order_id;
+  int64_t price;
+  uint32_t size;
+  char side;
+};
+
+enum class Event { Add, Cancel, Modify, Trade };
+
+void generate_chunk(const GeneratorOptions& options, const Plan& plan, size_t chunk,
+                    MboMsg* out) {
+  const uint64_t first = chunk * options.chunk_records;
+  const size_t count = std::min<uint64_t>(options.chunk_records, options.num_records - first);
+  const uint32_t n = options.num_instruments;
+  const int64_t tick = options.tick_size;
+  const int64_t* mid_start = &plan.mids[chunk * n];
+  const int64_t* mid_end = &plan.mids[(chunk + 1) * n];
+
+  const ActionMix& mix = options.action_mix;
+  const double total_weight = mix.add + mix.cancel + mix.modify + mix.trade;
+  const double p_add = mix.add / total_weight;
+  const double p_cancel = p_add + mix.cancel / total_weight;
+  const double p_modify = p_cancel + mix.modify / total_weight;
+
+  Rng rng(options.seed, chunk);
+  std::vector<std::vector<LiveOrder>> live(n);
+  std::vector<int64_t> offset(n, 0);  // Local mid drift in ticks
+  std::vector<int64_t> path(n);
+  std::vector<double> gaps(count);
+  bool in_burst = false;
+
+  for (size_t i = 0; i < count; ++i) {
+    MboMsg& m = out[i];
+    m = MboMsg{};
+    m.channel_id = options.channel_id;
+    m.sequence = static_cast<uint32_t>(first + i);
+    m.ts_in_delta = static_cast<uint8_t>(rng.below(200));
+    m.flags = F_LAST;
+
+    // Bursty inter-arrival: mean 1 outside bursts, scaled down inside
+    if (in_burst) {
+      in_burst = !rng.chance(1.0 / std::max(1u, options.mean_burst_length));
+    } else {
+      in_burst = rng.chance(options.burst_probability);
+    }
+    gaps[i] = rng.exponential() * (in_burst ? options.burst_gap_scale : 1.0);
+
+    const auto column = static_cast<uint32_t>(rng.below(n));
+    const uint32_t inst = rng.uniform() < plan.alias_prob[column] ? column : plan.alias[column];
+    m.instrument_id = options.first_instrument_id + inst;
+
+    if (rng.chance(0.01)) {
+      offset[inst] += rng.chance(0.5) ? 1 : -1;
+      if (std::abs(offset[inst]) > static_cast<int64_t>(options.levels) / 2) {
+        offset[inst] += offset[inst] > 0 ? -1 : 1;
+      }
+    }
+    if ((i & (PATH_REFRESH - 1)) == 0) {
+      // Interpolate along the chunk-boundary walk
+      const double progress = static_cast<double>(i) / static_cast<double>(count);
+      for (uint32_t k = 0; k < n; ++k) {
+        path[k] = mid_start[k] +
+            static_cast<int64_t>(std::llround((mid_end[k] - mid_start[k]) / tick * progress)) * tick;
+      }
+    }
+    const int64_t mid = path[inst] + offset[inst] * tick;
+
+    auto& orders = live[inst];
+    const double u = rng.uniform();
+    Event event = u < p_add ? Event::Add
+                : u < p_cancel ? Event::Cancel
+                : u < p_modify ? Event::Modify
+                : Event::Trade;
+    if (orders.empty()) {
+      event = Event::Add;
+    } else if (event == Event::Add && orders.size() >= options.max_live_orders) {
+      event = Event::Cancel;
+    } else if (event == Event::Trade && i + 1 == count) {
+      event = Event::Cancel;  // No room for the trade's fill record
+    }
+
+    switch (event) {
+      case Event::Add: {
+        LiveOrder order;
+        order.order_id = ORDER_ID_BASE + first + i;
+        order.side = rng.chance(0.5) ? 'B' : 'A';
+        uint32_t away = 1;
+        while (away < options.levels && rng.chance(0.35)) {
+          ++away;
+        }
+        order.price = order.side == 'B' ? mid - away * tick : mid + away * tick;
+        order.size = plan.sizes[rng.next() >> (64 - SIZE_TABLE_BITS)];
+        orders.push_back(order);
+        m.action = 'A';
+        m.side = order.side;
+        m.price = order.price;
+        m.size = order.size;
+        m.order_id = order.order_id;
+        break;
+      }
+      case Event::Cancel: {
+        const size_t idx = rng.below(orders.size());
+        const LiveOrder order = orders[idx];
+        orders[idx] = orders.back();
+        orders.pop_back();
+        m.action = 'C';
+        m.side = order.side;
+        m.price = order.price;
+        m.size = order.size;
+        m.order_id = order.order_id;
+        break;
+      }
+      case Event::Modify: {
+        LiveOrder& order = orders[rng.below(orders.size())];
+        order.size = plan.sizes[rng.next() >> (64 - SIZE_TABLE_BITS)];
+        if (rng.chance(0.25)) {
+          // Move one tick, staying on the order's side of the mid
+          const int64_t moved = order.price + (rng.chance(0.5) ? tick : -tick);
+          if (order.side == 'B' ? moved < mid : moved > mid) {
+            order.price = moved;
+          }
+        }
+        m.action = 'M';
+        m.side = order.side;
+        m.price = order.price;
+        m.size = order.size;
+        m.order_id = order.order_id;
+        break;
+      }
+      case Event::Trade: {
+        const size_t idx = rng.below(orders.size());
+        LiveOrder& resting = orders[idx];
+        const auto qty = static_cast<uint32_t>(1 + rng.below(resting.size));
+
+        m.action = 'T';
+        m.side = resting.side == 'B' ? 'A' : 'B';  // Aggressor
+        m.price = resting.price;
+        m.size = qty;
+        m.flags = 0;  // Event continues with the fill
+
+        MboMsg& fill = out[++i];
+        fill = m;
+        fill.action = 'F';
+        fill.side = resting.side;
+        fill.order_id = resting.order_id;
+        fill.flags = F_LAST;
+        fill.sequence = static_cast<uint32_t>(first + i);
+        gaps[i] = 0;
+
+        resting.size -= qty;
+        if (resting.size == 0) {
+          orders[idx] = orders.back();
+          orders.pop_back();
+        }
+        break;
+      }
+    }
+  }
+
+  // Spread the bursty gaps over this chunk's fixed time window so chunks
+  // never overlap in time
+  double total = 0;
+  for (double g : gaps) {
+    total += g;
+  }
+  const uint64_t window = count * options.mean_gap_ns;
+  const uint64_t chunk_start = options.start_ts + first * options.mean_gap_ns;
+  const double scale = total > 0 ? static_cast<double>(window) / total : 0.0;
+  double elapsed = 0;
+  for (size_t i = 0; i < count; ++i) {
+    elapsed += gaps[i];
+    const auto ts = static_cast<uint64_t>(elapsed * scale);
+    out[i].ts_event = chunk_start + std::min(ts, window > 0 ? window - 1 : 0);
+  }
+}
+
+// fn(thread, chunk, first, count) for every chunk, round-robin across threads
+template<typename Fn>
+void for_each_chunk(const GeneratorOptions& options, const Plan& plan, Fn&& fn) {
+  const unsigned threads = static_cast<unsigned>(std::min<size_t>(
+      resolve_thread_count(options.threads), std::max<size_t>(1, plan.num_chunks)));
+  parallel_for(threads, [&](unsigned t) {
+    for (size_t chunk = t; chunk < plan.num_chunks; chunk += threads) {
+      const uint64_t first = chunk * options.chunk_records;
+      const size_t count = std::min<uint64_t>(options.chunk_records, options.num_records - first);
+      TraceSpan span("generate_chunk", "generator");
+      fn(t, chunk, first, count);
+    }
+  });
+}
+
+} // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+std::vector<MboMsg> generate_mbo_records(const GeneratorOptions& options) {
+  const Plan plan = make_plan(options);
+  std::vector<MboMsg> records(options.num_records);
+  for_each_chunk(options, plan, [&](unsigned, size_t chunk, uint64_t first, size_t) {
+    generate_chunk(options, plan, chunk, records.data() + first);
+  });
+  return records;
+}
+
+void write_synthetic_dbn(const std::string& path, const GeneratorOptions& options) {
+  const Plan plan = make_plan(options);
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to create file: " + path);
+  }
+  try {
+    uint8_t metadata[METADATA_SIZE] = {};
+    metadata[0] = 1;  // Version
+    pwrite_all(fd, metadata, sizeof(metadata), 0, path);
+    const uint64_t total_size = METADATA_SIZE + options.num_records * sizeof(MboMsg);
+    if (::ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+      throw std::runtime_error("Failed to size file: " + path);
+    }
+
+    // One reusable chunk buffer per thread
+    std::vector<std::vector<MboMsg>> buffers(resolve_thread_count(options.threads));
+    for_each_chunk(options, plan, [&](unsigned t, size_t chunk, uint64_t first, size_t count) {
+      auto& buffer = buffers[t];
+      buffer.resize(count);
+      generate_chunk(options, plan, chunk, buffer.data());
+      pwrite_all(fd, buffer.data(), count * sizeof(MboMsg),
+                 METADATA_SIZE + first * sizeof(MboMsg), path);
+    });
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+} // namespace databento
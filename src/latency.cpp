@@ -0,0 +1,147 @@
+#include "databento/latency.hpp"
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+namespace databento {
+
+// ============================================================================
+// TSC Calibration
+// ============================================================================
+
+double tsc_ns_per_tick() {
+  static const double ns_per_tick = [] {
+#if defined(__x86_64__) || defined(__i386__)
+    const auto wall_start = std::chrono::steady_clock::now();
+    const uint64_t tsc_start = read_tsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const uint64_t tsc_end = read_tsc();
+    const auto wall_end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(wall_end - wall_start).count();
+    return tsc_end > tsc_start ? ns / static_cast<double>(tsc_end - tsc_start) : 1.0;
+#else
+    return 1.0;
+#endif
+  }();
+  return ns_per_tick;
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+  const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+  const uint64_t mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+  // The top bucket ends at UINT64_MAX; computing (mantissa + 1) << shift would overflow
+  if (mantissa + 1 == 2 * SUB_BUCKETS && shift == 64 - SUB_BUCKET_BITS - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return ((mantissa + 1) << shift) - 1;
+}
+
+double LatencyHistogram::mean() const {
+  const uint64_t n = count();
+  return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+  const uint64_t n = count();
+  if (n == 0) {
+    return 0;
+  }
+  p = p < 0 ? 0 : (p > 1 ? 1 : p);
+  uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(n) + 0.5);
+  rank = rank == 0 ? 1 : (rank > n ? n : rank);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    seen += counts_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      const uint64_t bound = bucket_upper_bound(i);
+      return bound < max() ? bound : max();
+    }
+  }
+  return max();  // Concurrent writers bumped count_ ahead of the buckets
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    const uint64_t c = other.counts_[i].load(std::memory_order_relaxed);
+    if (c) {
+      counts_[i].fetch_add(c, std::memory_order_relaxed);
+    }
+  }
+  const uint64_t n = other.count();
+  if (n == 0) {
+    return;
+  }
+  count_.fetch_add(n, std::memory_order_relaxed);
+  sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+  const uint64_t other_min = other.min();
+  uint64_t seen = min_.load(std::memory_order_relaxed);
+  while (other_min < seen && !min_.compare_exchange_weak(seen, other_min, std::memory_order_relaxed)) {
+  }
+  const uint64_t other_max = other.max();
+  seen = max_.load(std::memory_order_relaxed);
+  while (other_max > seen && !max_.compare_exchange_weak(seen, other_max, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::reset() {
+  for (auto& c : counts_) {
+    c.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// LatencyProbe
+// ============================================================================
+
+LatencyProbe::LatencyProbe(uint32_t sample_every) {
+  uint32_t stride = 1;
+  while (stride < sample_every && stride < (1u << 31)) {
+    stride <<= 1;
+  }
+  sample_mask_ = stride - 1;
+}
+
+LatencySummary LatencyProbe::summary() const {
+  const double scale = tsc_ns_per_tick();
+  LatencySummary s;
+  s.samples = histogram_.count();
+  s.mean_ns = histogram_.mean() * scale;
+  s.p50_ns = histogram_.percentile(0.50) * scale;
+  s.p90_ns = histogram_.percentile(0.90) * scale;
+  s.p99_ns = histogram_.percentile(0.99) * scale;
+  s.p999_ns = histogram_.percentile(0.999) * scale;
+  s.max_ns = histogram_.max() * scale;
+  return s;
+}
+
+void LatencyProbe::print(const std::string& label) const {
+  const auto s = summary();
+  std::cout << "\n=== Latency: " << label << " ===\n";
+  if (!LATENCY_PROBES_ENABLED) {
+    std::cout << "(built without DATABENTO_ENABLE_LATENCY_PROBES)\n";
+  }
+  std::cout << std::fixed << std::setprecision(1)
+            << "Samples:  " << s.samples << " (1 in " << sample_every() << ")\n"
+            << "Mean:     " << s.mean_ns << " ns\n"
+            << "p50:      " << s.p50_ns << " ns\n"
+            << "p90:      " << s.p90_ns << " ns\n"
+            << "p99:      " << s.p99_ns << " ns\n"
+            << "p99.9:    " << s.p999_ns << " ns\n"
+            << "Max:      " << s.max_ns << " ns\n";
+}
+
+} // namespace databento
@@ -0,0 +1,156 @@
+#include "databento/multi_file.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+// Page cache hints are best effort; failures are ignored
+void advise(const std::string& path, int advice) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    ::posix_fadvise(fd, 0, 0, advice);
+    ::close(fd);
+  }
+}
+
+uint64_t file_size(const std::string& path) {
+  struct stat st {};
+  return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+std::unique_ptr<DbnParser> load_file(const std::string& path, bool drop_behind, BufferPool* pool) {
+  auto parser = std::make_unique<DbnParser>(path);
+  parser->set_buffer_pool(pool);
+  parser->load_into_memory();
+  // The bytes now live in the parser's buffer; the cached copy is dead weight
+  if (drop_behind) {
+    advise(path, POSIX_FADV_DONTNEED);
+  }
+  return parser;
+}
+
+} // namespace
+
+// ============================================================================
+// MultiFileStats
+// ============================================================================
+
+void MultiFileStats::print() const {
+  std::cout << "\n" << std::string(70, '=') << "\n";
+  std::cout << "Multi-File Scan Statistics\n";
+  std::cout << std::string(70, '=') << "\n";
+  std::cout << "Files:          " << files << " (" << prefetched << " prefetched)\n";
+  std::cout << "Total records:  " << records << "\n";
+  std::cout << "Total bytes:    " << bytes << "\n";
+  std::cout << "Load wait:      " << load_wait_seconds << " seconds\n";
+  std::cout << "Elapsed time:   " << elapsed_seconds << " seconds\n";
+  std::cout << std::string(70, '=') << "\n";
+}
+
+// ============================================================================
+// MultiFileScan
+// ============================================================================
+
+MultiFileScan::MultiFileScan(std::vector<std::string> paths, const MultiFileOptions& options)
+    : paths_(std::move(paths)), options_(options) {}
+
+std::vector<std::string> MultiFileScan::list_directory(const std::string& directory,
+                                                       const std::string& extension) {
+  std::error_code ec;
+  std::filesystem::directory_iterator it(directory, ec);
+  if (ec) {
+    throw std::runtime_error("Failed to open directory: " + directory);
+  }
+  std::vector<std::string> paths;
+  for (const auto& entry : it) {
+    const std::string name = entry.path().filename().string();
+    if (entry.is_regular_file() && name.ends_with(extension)) {
+      paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+MultiFileStats MultiFileScan::for_each_file(const std::function<void(DbnParser&, size_t)>& fn) {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  const size_t n = paths_.size();
+
+  std::vector<uint64_t> sizes(n);
+  for (size_t i = 0; i < n; ++i) {
+    sizes[i] = file_size(paths_[i]);
+  }
+
+  // Declared before the loads so it outlives every parser borrowing from it
+  BufferPoolOptions pool_options;
+  pool_options.huge_pages = options_.huge_pages;
+  BufferPool pool(pool_options);
+  BufferPool* borrow = options_.reuse_buffers ? &pool : nullptr;
+
+  // Futures from std::async join in their destructors, so an exception
+  // leaves no load running behind our back
+  std::vector<std::future<std::unique_ptr<DbnParser>>> loads(n);
+  std::vector<bool> hinted(n, false);
+  size_t next_load = 0;
+  uint64_t in_memory = 0;
+
+  // Start loads up to `last`; the current file (`first`) always loads, the
+  // rest only within the budget, and otherwise get a readahead hint
+  auto start_loads = [&](size_t first, size_t last) {
+    while (next_load < n && next_load <= last) {
+      if (next_load != first && in_memory + sizes[next_load] > options_.memory_budget) {
+        if (!hinted[next_load]) {
+          advise(paths_[next_load], POSIX_FADV_WILLNEED);
+          hinted[next_load] = true;
+        }
+        return;
+      }
+      loads[next_load] = std::async(std::launch::async, load_file, paths_[next_load],
+                                    options_.drop_behind, borrow);
+      in_memory += sizes[next_load];
+      ++next_load;
+    }
+  };
+
+  MultiFileStats stats;
+  for (size_t i = 0; i < n; ++i) {
+    stats.prefetched += next_load > i ? 1 : 0;
+    start_loads(i, i);
+
+    const auto wait_start = Clock::now();
+    std::unique_ptr<DbnParser> parser = loads[i].get();
+    stats.load_wait_seconds += std::chrono::duration<double>(Clock::now() - wait_start).count();
+
+    // Next files load while fn works on this one
+    start_loads(i, i + options_.prefetch_files);
+
+    fn(*parser, i);
+    ++stats.files;
+    stats.records += parser->num_records();
+    stats.bytes += parser->size();
+    parser.reset();
+    in_memory -= sizes[i];
+  }
+
+  stats.elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return stats;
+}
+
+MultiFileStats MultiFileScan::parse_mbo(const MboCallback& callback) {
+  return for_each_file([&](DbnParser& parser, size_t) { parser.parse_mbo(callback); });
+}
+
+} // namespace databento
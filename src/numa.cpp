@@ -0,0 +1,314 @@
+#include "databento/numa.hpp"
+#include "databento/io.hpp"
+#include "databento/parallel.hpp"
+#include "databento/parser.hpp"
+#include "databento/trace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+// CPUs in the process affinity mask
+std::vector<int> allowed_cpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    const int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < n; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// Restores the calling thread's affinity on scope exit; the caller of
+// parallel_for runs thread 0 and must not stay pinned
+class ScopedAffinity {
+public:
+  ScopedAffinity() {
+#ifdef __linux__
+    CPU_ZERO(&saved_);
+    saved_valid_ = ::sched_getaffinity(0, sizeof(saved_), &saved_) == 0;
+#endif
+  }
+  ~ScopedAffinity() {
+#ifdef __linux__
+    if (saved_valid_) {
+      ::sched_setaffinity(0, sizeof(saved_), &saved_);
+    }
+#endif
+  }
+  ScopedAffinity(const ScopedAffinity&) = delete;
+  ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+private:
+#ifdef __linux__
+  cpu_set_t saved_;
+  bool saved_valid_ = false;
+#endif
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// ============================================================================
+// Topology
+// ============================================================================
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string token = list.substr(pos, end - pos);
+    token.erase(std::remove_if(token.begin(), token.end(),
+                               [](unsigned char c) { return std::isspace(c); }),
+                token.end());
+    pos = end + 1;
+    if (token.empty()) {
+      continue;
+    }
+
+    const size_t dash = token.find('-');
+    try {
+      size_t used = 0;
+      const int first = std::stoi(token.substr(0, dash), &used);
+      int last = first;
+      if (dash != std::string::npos) {
+        last = std::stoi(token.substr(dash + 1), &used);
+      }
+      if (used == 0 || first < 0 || last < first) {
+        throw std::invalid_argument(token);
+      }
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::logic_error&) {
+      throw std::invalid_argument("Malformed CPU list: " + list);
+    }
+  }
+  return cpus;
+}
+
+std::vector<NumaNode> numa_topology(const std::string& sysfs_root) {
+  const std::vector<int> allowed = allowed_cpus();
+  std::vector<NumaNode> nodes;
+
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(sysfs_root, ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+        !std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+      continue;
+    }
+    std::ifstream in(entry.path() / "cpulist");
+    std::string list;
+    if (!in || !std::getline(in, list)) {
+      continue;
+    }
+    NumaNode node;
+    node.id = std::stoi(name.substr(4));
+    for (int cpu : parse_cpu_list(list)) {
+      if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+        node.cpus.push_back(cpu);
+      }
+    }
+    // Memory-only nodes, or nodes outside our cpuset, cannot run threads
+    if (!node.cpus.empty()) {
+      nodes.push_back(std::move(node));
+    }
+  }
+
+  if (nodes.empty()) {
+    nodes.push_back(NumaNode{0, allowed});
+  }
+  std::sort(nodes.begin(), nodes.end(),
+            [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+  return nodes;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return CPU_COUNT(&set) > 0 && ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+// ============================================================================
+// NumaDbnFile
+// ============================================================================
+
+NumaDbnFile::NumaDbnFile(const std::string& path, const NumaOptions& options)
+    : options_(options), nodes_(numa_topology(options.sysfs_root)) {
+  for (size_t n = 0; n < nodes_.size(); ++n) {
+    const unsigned threads = options_.threads_per_node > 0
+                                 ? options_.threads_per_node
+                                 : static_cast<unsigned>(nodes_[n].cpus.size());
+    thread_node_.insert(thread_node_.end(), threads, n);
+    NumaNodeStats stats;
+    stats.node = nodes_[n].id;
+    stats.threads = threads;
+    node_stats_.push_back(stats);
+  }
+
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  try {
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      throw std::runtime_error("Failed to stat file: " + path);
+    }
+    const DbnParser layout(path);
+    size_ = static_cast<size_t>(st.st_size);
+    metadata_offset_ = std::min(size_, layout.metadata_offset());
+    record_size_ = layout.record_size();
+    num_records_ = (size_ - metadata_offset_) / record_size_;
+
+    // Untouched pages: each goes to the node of the thread that first writes it
+    mapped_size_ = std::max<size_t>(size_, 1);
+    void* mapping = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error("Failed to map buffer for: " + path);
+    }
+    data_ = static_cast<uint8_t*>(mapping);
+
+    TraceSpan span("numa_load", "loader");
+    std::vector<double> seconds(num_threads());
+    run_pinned([&](unsigned t) {
+      const auto start = std::chrono::steady_clock::now();
+      if (t == 0) {
+        pread_all(fd, data_, metadata_offset_, 0, path);
+      }
+      const auto [begin, end] = chunk(t);
+      const size_t offset = metadata_offset_ + begin * record_size_;
+      pread_all(fd, data_ + offset, (end - begin) * record_size_, offset, path);
+      seconds[t] = seconds_since(start);
+    });
+
+    for (unsigned t = 0; t < num_threads(); ++t) {
+      NumaNodeStats& stats = node_stats_[thread_node_[t]];
+      const auto [begin, end] = chunk(t);
+      stats.records += end - begin;
+      stats.bytes += (end - begin) * record_size_;
+      stats.load_seconds = std::max(stats.load_seconds, seconds[t]);
+    }
+  } catch (...) {
+    ::close(fd);
+    if (data_) {
+      ::munmap(data_, mapped_size_);
+    }
+    throw;
+  }
+  ::close(fd);
+}
+
+NumaDbnFile::~NumaDbnFile() {
+  if (data_) {
+    ::munmap(data_, mapped_size_);
+  }
+}
+
+std::pair<size_t, size_t> NumaDbnFile::chunk(unsigned thread) const {
+  return chunk_range(num_records_, num_threads(), thread);
+}
+
+void NumaDbnFile::run_pinned(const std::function<void(unsigned)>& fn) {
+  // One node means nothing to place; leave scheduling to the OS
+  const bool pin = options_.pin_threads && nodes_.size() > 1;
+  parallel_for(num_threads(), [&](unsigned t) {
+    ScopedAffinity restore;
+    if (pin) {
+      pin_current_thread(nodes_[thread_node_[t]].cpus);
+    }
+    fn(t);
+  });
+}
+
+void NumaDbnFile::scan(const std::function<void(unsigned, int, const query::RecordRange&)>& fn) {
+  TraceSpan span("numa_scan", "parser");
+  std::vector<double> seconds(num_threads());
+  run_pinned([&](unsigned t) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto [begin, end] = chunk(t);
+    const query::RecordRange range(data_ + metadata_offset_ + begin * record_size_, end - begin,
+                                   record_size_);
+    fn(t, nodes_[thread_node_[t]].id, range);
+    seconds[t] = seconds_since(start);
+  });
+
+  for (auto& stats : node_stats_) {
+    stats.scan_seconds = 0.0;
+  }
+  for (unsigned t = 0; t < num_threads(); ++t) {
+    NumaNodeStats& stats = node_stats_[thread_node_[t]];
+    stats.scan_seconds = std::max(stats.scan_seconds, seconds[t]);
+  }
+}
+
+query::RecordRange NumaDbnFile::records() const {
+  return query::RecordRange(data_ + metadata_offset_, num_records_, record_size_);
+}
+
+void NumaDbnFile::print_stats() const {
+  std::cout << "\n" << std::string(70, '=') << "\n";
+  std::cout << "NUMA Load/Scan Statistics (" << nodes_.size() << " node"
+            << (nodes_.size() == 1 ? "" : "s") << ")\n";
+  std::cout << std::string(70, '=') << "\n";
+  // Restore the caller's stream format afterwards
+  const std::ios_base::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
+  std::cout << std::fixed << std::setprecision(2);
+  for (const auto& s : node_stats_) {
+    std::cout << "Node " << s.node << ": " << s.threads << " threads, " << s.records
+              << " records, load " << s.load_gbps() << " GB/s, scan " << s.scan_gbps()
+              << " GB/s\n";
+  }
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+  std::cout << std::string(70, '=') << "\n";
+}
+
+} // namespace databento
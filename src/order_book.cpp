@@ -0,0 +1,129 @@
+#include "databento/order_book.hpp"
+#include <algorithm>
+
+namespace databento {
+
+// ============================================================================
+// OrderBook Implementation
+// ============================================================================
+
+void OrderBook::apply(const MboMsg& msg) {
+  switch (static_cast<Action>(msg.action)) {
+    case Action::Add: {
+      if (const RestingOrder* existing = orders_.find(msg.order_id)) {
+        remove_from_level(*existing, existing->size, true);
+        orders_.erase(msg.order_id);
+      }
+      RestingOrder order{msg.order_id, msg.instrument_id, msg.side,
+                         msg.price, msg.size, next_priority_++};
+      orders_.try_emplace(msg.order_id, order);
+      add_to_level(order);
+      break;
+    }
+    case Action::Cancel:
+    case Action::Fill:
+      reduce(msg.order_id, msg.size);
+      break;
+    case Action::Modify: {
+      RestingOrder* order = orders_.find(msg.order_id);
+      if (!order) {
+        // Order predates our view of the book: treat as a new add
+        RestingOrder added{msg.order_id, msg.instrument_id, msg.side,
+                           msg.price, msg.size, next_priority_++};
+        orders_.try_emplace(msg.order_id, added);
+        add_to_level(added);
+        break;
+      }
+      const bool loses_priority = msg.price != order->price || msg.size > order->size;
+      remove_from_level(*order, order->size, true);
+      order->price = msg.price;
+      order->size = msg.size;
+      if (loses_priority) {
+        order->priority = next_priority_++;
+      }
+      if (order->size == 0) {
+        orders_.erase(msg.order_id);
+      } else {
+        add_to_level(*order);
+      }
+      break;
+    }
+    case Action::Clear:
+      clear_instrument(msg.instrument_id);
+      break;
+    case Action::Trade:
+      break;
+  }
+}
+
+LevelInfo OrderBook::level(uint32_t instrument_id, char side, int64_t price) const {
+  const LevelInfo* info = levels_.find(LevelKey{instrument_id, side, price});
+  return info ? *info : LevelInfo{0, 0};
+}
+
+void OrderBook::clear() {
+  orders_.clear();
+  levels_.clear();
+}
+
+void OrderBook::clear_instrument(uint32_t instrument_id) {
+  std::vector<uint64_t> ids;
+  orders_.for_each([&](uint64_t id, const RestingOrder& order) {
+    if (order.instrument_id == instrument_id) {
+      ids.push_back(id);
+    }
+  });
+  for (uint64_t id : ids) {
+    const RestingOrder order = *orders_.find(id);
+    remove_from_level(order, order.size, true);
+    orders_.erase(id);
+  }
+}
+
+void OrderBook::insert(const RestingOrder& order) {
+  if (const RestingOrder* existing = orders_.find(order.order_id)) {
+    remove_from_level(*existing, existing->size, true);
+    orders_.erase(order.order_id);
+  }
+  orders_.try_emplace(order.order_id, order);
+  add_to_level(order);
+  next_priority_ = std::max(next_priority_, order.priority + 1);
+}
+
+void OrderBook::add_to_level(const RestingOrder& order) {
+  LevelInfo& info = levels_[LevelKey{order.instrument_id, order.side, order.price}];
+  info.size += order.size;
+  info.order_count += 1;
+}
+
+void OrderBook::remove_from_level(const RestingOrder& order, uint32_t size, bool last) {
+  const LevelKey key{order.instrument_id, order.side, order.price};
+  LevelInfo* info = levels_.find(key);
+  if (!info) {
+    return;
+  }
+  info->size -= std::min<uint64_t>(info->size, size);
+  if (last) {
+    info->order_count -= 1;
+    if (info->order_count == 0) {
+      levels_.erase(key);
+    }
+  }
+}
+
+void OrderBook::reduce(uint64_t order_id, uint32_t size) {
+  RestingOrder* order = orders_.find(order_id);
+  if (!order) {
+    return;
+  }
+  const uint32_t removed = std::min(size, order->size);
+  const bool last = removed == order->size;
+  remove_from_level(*order, removed, last);
+  if (last) {
+    orders_.erase(order_id);
+  } else {
+    order->size -= removed;
+  }
+}
+
+} // namespace databento
@@ -1,9 +1,18 @@
 #include "databento/parser.hpp"
+#include "databento/file_watch.hpp"
+#include "databento/io.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <chrono>
 #include <stdexcept>
 #include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace databento {
 
@@ -17,14 +26,23 @@ DbnParser::DbnParser(const std::string& filepath)
       size_(0),
       metadata_offset_(200),  // Standard DBN metadata size
       record_size_(48),       // MBO/Trade record size
-      num_records_(0) {
+      num_records_(0),
+      pool_(nullptr),
+      follow_fd_(-1),
+      next_record_(0),
+      stop_requested_(false),
+      probe_(nullptr) {
 }
 
 DbnParser::~DbnParser() {
-  // buffer_ automatically cleans up
+  // buffer_ unmaps itself, or goes back to its pool
+  if (follow_fd_ >= 0) {
+    ::close(follow_fd_);
+  }
 }
 
 void DbnParser::load_into_memory() {
+  TraceSpan span("load", "loader");
   std::ifstream file(filepath_, std::ios::binary | std::ios::ate);
   if (!file) {
     throw std::runtime_error("Failed to open file: " + filepath_);
@@ -33,7 +51,7 @@ void DbnParser::load_into_memory() {
   size_ = file.tellg();
   file.seekg(0, std::ios::beg);
 
-  buffer_.resize(size_);
+  resize_buffer(size_);
   file.read(reinterpret_cast<char*>(buffer_.data()), size_);
   
   if (!file) {
@@ -51,30 +69,115 @@ void DbnParser::load_into_memory() {
   }
 }
 
+void DbnParser::reset(const std::string& filepath) {
+  if (follow_fd_ >= 0) {
+    ::close(follow_fd_);
+    follow_fd_ = -1;
+  }
+  filepath_ = filepath;
+  data_ = nullptr;
+  size_ = 0;
+  num_records_ = 0;
+  next_record_ = 0;
+  stop_requested_.store(false, std::memory_order_relaxed);
+  buffer_.resize(0);  // Keeps the mapping
+}
+
+void DbnParser::resize_buffer(size_t size) {
+  if (buffer_.capacity() == 0 && pool_) {
+    buffer_ = pool_->acquire(size);
+    return;
+  }
+  buffer_.resize(size);
+}
+
 void DbnParser::parse_mbo(MboCallback callback) {
   if (!data_) {
     load_into_memory();
   }
+  TraceSpan span("parse_mbo", "parser");
 
   const uint8_t* ptr = data_ + metadata_offset_;
   for (size_t i = 0; i < num_records_; ++i) {
     MboMsg msg;
     std::memcpy(&msg, ptr, sizeof(MboMsg));
-    callback(msg);
+    probe_call(probe_, i, [&] { callback(msg); });
     ptr += record_size_;
   }
 }
 
+void DbnParser::parse_mbo_from(size_t start_index, MboCallback callback) {
+  if (!data_) {
+    stream_mbo_from(start_index, callback);
+    return;
+  }
+  if (start_index > num_records_) {
+    throw std::out_of_range("Start index beyond data");
+  }
+  TraceSpan span("parse_mbo", "parser");
+
+  const uint8_t* ptr = data_ + metadata_offset_ + start_index * record_size_;
+  for (size_t i = start_index; i < num_records_; ++i) {
+    MboMsg msg;
+    std::memcpy(&msg, ptr, sizeof(MboMsg));
+    probe_call(probe_, i, [&] { callback(msg); });
+    ptr += record_size_;
+  }
+}
+
+void DbnParser::stream_mbo_from(size_t start_index, const MboCallback& callback) {
+  // Not loaded: read only the tail through a bounded chunk, so resuming
+  // near the end of a large file costs the remaining records, not the file
+  const int fd = ::open(filepath_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open file: " + filepath_);
+  }
+  try {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      throw std::runtime_error("Failed to stat file: " + filepath_);
+    }
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    const size_t total = file_size > metadata_offset_
+        ? (file_size - metadata_offset_) / record_size_ : 0;
+    if (start_index > total) {
+      throw std::out_of_range("Start index beyond data");
+    }
+    TraceSpan span("parse_mbo", "parser");
+
+    constexpr size_t CHUNK_BYTES = 4 << 20;
+    const size_t chunk_records = std::max<size_t>(1, CHUNK_BYTES / record_size_);
+    std::vector<uint8_t> chunk(std::min(chunk_records, total - start_index) * record_size_);
+    for (size_t i = start_index; i < total;) {
+      const size_t count = std::min(chunk_records, total - i);
+      pread_all(fd, chunk.data(), count * record_size_,
+                metadata_offset_ + static_cast<uint64_t>(i) * record_size_, filepath_);
+      const uint8_t* ptr = chunk.data();
+      for (const size_t end = i + count; i < end; ++i) {
+        MboMsg msg;
+        std::memcpy(&msg, ptr, sizeof(MboMsg));
+        probe_call(probe_, i, [&] { callback(msg); });
+        ptr += record_size_;
+      }
+    }
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
 void DbnParser::parse_trade(TradeCallback callback) {
   if (!data_) {
     load_into_memory();
   }
+  TraceSpan span("parse_trade", "parser");
 
   const uint8_t* ptr = data_ + metadata_offset_;
   for (size_t i = 0; i < num_records_; ++i) {
     TradeMsg msg;
     std::memcpy(&msg, ptr, sizeof(TradeMsg));
-    callback(msg);
+    probe_call(probe_, i, [&] { callback(msg); });
     ptr += record_size_;
   }
 }
@@ -93,10 +196,199 @@ const uint8_t* DbnParser::get_batch(size_t start_index, size_t count) const {
   return data_ + metadata_offset_ + (start_index * record_size_);
 }
 
+// ============================================================================
+// Follow Mode
+// ============================================================================
+
+bool DbnParser::grow_to_file_size() {
+  if (follow_fd_ < 0) {
+    follow_fd_ = ::open(filepath_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (follow_fd_ < 0) {
+      throw std::runtime_error("Failed to open file: " + filepath_);
+    }
+  }
+
+  struct stat st;
+  if (::fstat(follow_fd_, &st) != 0) {
+    throw std::runtime_error("Failed to stat file: " + filepath_);
+  }
+
+  const size_t file_size = static_cast<size_t>(st.st_size);
+  if (file_size < size_) {
+    throw std::runtime_error("File truncated while following: " + filepath_);
+  }
+  if (file_size == size_) {
+    return false;
+  }
+
+  // Only the appended bytes are read; buffer growth is geometric (and
+  // usually an in-place mremap) so reallocation cost is amortised.
+  const size_t old_size = size_;
+  resize_buffer(file_size);
+  size_t done = old_size;
+  while (done < file_size) {
+    const ssize_t n = ::pread(follow_fd_, buffer_.data() + done,
+                              file_size - done, static_cast<off_t>(done));
+    if (n < 0) {
+      throw std::runtime_error("Failed to read file: " + filepath_);
+    }
+    if (n == 0) {
+      break;  // Raced with a concurrent truncate; keep what we have
+    }
+    done += static_cast<size_t>(n);
+  }
+
+  buffer_.resize(done);
+  data_ = buffer_.data();
+  size_ = done;
+
+  const size_t old_records = num_records_;
+  num_records_ = size_ > metadata_offset_
+      ? (size_ - metadata_offset_) / record_size_
+      : 0;
+  return num_records_ > old_records;
+}
+
+size_t DbnParser::deliver_new_mbo(const MboCallback& callback, bool stoppable) {
+  if (next_record_ >= num_records_) {
+    return 0;  // Idle polls would otherwise flood the trace
+  }
+  TraceSpan span("deliver_mbo", "parser");
+  const size_t first = next_record_;
+  const uint8_t* ptr = data_ + metadata_offset_ + first * record_size_;
+  while (next_record_ < num_records_) {
+    if (stoppable && stop_requested_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    MboMsg msg;
+    std::memcpy(&msg, ptr, sizeof(MboMsg));
+    probe_call(probe_, next_record_++, [&] { callback(msg); });
+    ptr += record_size_;
+  }
+  return next_record_ - first;
+}
+
+size_t DbnParser::poll_mbo(MboCallback callback) {
+  grow_to_file_size();
+  return deliver_new_mbo(callback, false);
+}
+
+RecordView<MboMsg> DbnParser::poll_mbo_batch(size_t max_records) {
+  if (next_record_ >= num_records_) {
+    grow_to_file_size();
+  }
+  if (!data_) {
+    return {};  // Nothing loaded yet (empty or missing file)
+  }
+  const size_t count = std::min(max_records, num_records_ - next_record_);
+  const uint8_t* first = data_ + metadata_offset_ + next_record_ * record_size_;
+  next_record_ += count;
+  return RecordView<MboMsg>(first, count, record_size_);
+}
+
+void DbnParser::follow_mbo(MboCallback callback, const FollowOptions& options) {
+  grow_to_file_size();
+  if (options.start_at_end) {
+    next_record_ = num_records_;
+  }
+
+  const detail::FileWatch watch(filepath_, options.use_inotify);
+  // Clear the stop request however we leave, so the next follow runs
+  struct StopReset {
+    std::atomic<bool>& flag;
+    ~StopReset() { flag.store(false, std::memory_order_relaxed); }
+  } stop_reset{stop_requested_};
+
+  const auto timeout_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      options.poll_interval);
+  auto last_growth = std::chrono::steady_clock::now();
+
+  while (!stop_requested_.load(std::memory_order_relaxed)) {
+    grow_to_file_size();
+    if (deliver_new_mbo(callback, true) > 0) {
+      last_growth = std::chrono::steady_clock::now();
+      continue;
+    }
+
+    if (options.idle_timeout.count() > 0 &&
+        std::chrono::steady_clock::now() - last_growth >= options.idle_timeout) {
+      break;
+    }
+
+#ifdef __linux__
+    if (watch.fd >= 0) {
+      pollfd pfd{watch.fd, POLLIN, 0};
+      timespec ts{static_cast<time_t>(timeout_ns.count() / 1'000'000'000),
+                  static_cast<long>(timeout_ns.count() % 1'000'000'000)};
+      if (::ppoll(&pfd, 1, &ts, nullptr) > 0) {
+        watch.drain();
+      }
+      continue;
+    }
+#endif
+    std::this_thread::sleep_for(timeout_ns);
+  }
+}
+
 // ============================================================================
 // ParseStats Implementation
 // ============================================================================
 
+namespace {
+
+void print_phase(const char* name, double seconds, const PhaseCounters& c) {
+  std::cout << name << seconds << " seconds";
+  auto metric = [](const char* label, double value) {
+    if (value == value) {  // Not NaN
+      std::cout << ", " << value << " " << label;
+    }
+  };
+  metric("cycles/rec", c.cycles_per_record);
+  metric("instr/rec", c.instructions_per_record);
+  metric("LLC misses/rec", c.llc_misses_per_record);
+  metric("dTLB misses/rec", c.dtlb_misses_per_record);
+  metric("page faults/rec", c.page_faults_per_record);
+  std::cout << "\n";
+}
+
+// Time load_into_memory() and fn() separately, with optional counters
+template<typename Fn>
+ParseStats measure_parse(DbnParser& parser, bool hardware_counters, Fn&& fn) {
+  std::unique_ptr<PerfCounters> counters;
+  if (hardware_counters) {
+    counters = std::make_unique<PerfCounters>();
+  }
+  PerfSample load_sample;
+  PerfSample parse_sample;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  if (counters) counters->start();
+  parser.load_into_memory();
+  if (counters) load_sample = counters->stop();
+
+  auto loaded = std::chrono::high_resolution_clock::now();
+  if (counters) counters->start();
+  fn();
+  if (counters) parse_sample = counters->stop();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  ParseStats stats;
+  stats.total_records = parser.num_records();
+  stats.load_seconds = std::chrono::duration<double>(loaded - start).count();
+  stats.parse_seconds = std::chrono::duration<double>(end - loaded).count();
+  stats.elapsed_seconds = stats.load_seconds + stats.parse_seconds;
+  stats.records_per_second = stats.total_records / stats.elapsed_seconds;
+  stats.throughput_gbps = (stats.total_records * static_cast<double>(parser.record_size())) /
+                          (stats.elapsed_seconds * 1024 * 1024 * 1024);
+  stats.counters_requested = hardware_counters;
+  stats.counters_available = counters && counters->available();
+  stats.load_counters = PhaseCounters::from(load_sample, stats.total_records);
+  stats.parse_counters = PhaseCounters::from(parse_sample, stats.total_records);
+  return stats;
+}
+
+} // namespace
+
 void ParseStats::print() const {
   std::cout << "\n" << std::string(70, '=') << "\n";
   std::cout << "Parse Statistics\n";
@@ -105,6 +397,11 @@ void ParseStats::print() const {
   std::cout << "Elapsed time:   " << elapsed_seconds << " seconds\n";
   std::cout << "Records/sec:    " << static_cast<uint64_t>(records_per_second) << " rec/s\n";
   std::cout << "Throughput:     " << throughput_gbps << " GB/s\n";
+  print_phase("Load:           ", load_seconds, load_counters);
+  print_phase("Parse:          ", parse_seconds, parse_counters);
+  if (counters_requested && !counters_available) {
+    std::cout << "(performance counters unavailable)\n";
+  }
   std::cout << std::string(70, '=') << "\n";
 }
 
@@ -112,42 +409,16 @@ void ParseStats::print() const {
 // High-Level Utility Functions
 // ============================================================================
 
-ParseStats parse_file_mbo(const std::string& filepath, MboCallback callback) {
-  auto start = std::chrono::high_resolution_clock::now();
-
+ParseStats parse_file_mbo(const std::string& filepath, MboCallback callback,
+                          bool hardware_counters) {
   DbnParser parser(filepath);
-  parser.load_into_memory();
-  parser.parse_mbo(callback);
-
-  auto end = std::chrono::high_resolution_clock::now();
-  double elapsed = std::chrono::duration<double>(end - start).count();
-
-  ParseStats stats;
-  stats.total_records = parser.num_records();
-  stats.elapsed_seconds = elapsed;
-  stats.records_per_second = stats.total_records / elapsed;
-  stats.throughput_gbps = (stats.total_records * 48.0) / (elapsed * 1024 * 1024 * 1024);
-
-  return stats;
+  return measure_parse(parser, hardware_counters, [&] { parser.parse_mbo(callback); });
 }
 
-ParseStats parse_file_trade(const std::string& filepath, TradeCallback callback) {
-  auto start = std::chrono::high_resolution_clock::now();
-
+ParseStats parse_file_trade(const std::string& filepath, TradeCallback callback,
+                            bool hardware_counters) {
   DbnParser parser(filepath);
-  parser.load_into_memory();
-  parser.parse_trade(callback);
-
-  auto end = std::chrono::high_resolution_clock::now();
-  double elapsed = std::chrono::duration<double>(end - start).count();
-
-  ParseStats stats;
-  stats.total_records = parser.num_records();
-  stats.elapsed_seconds = elapsed;
-  stats.records_per_second = stats.total_records / elapsed;
-  stats.throughput_gbps = (stats.total_records * 48.0) / (elapsed * 1024 * 1024 * 1024);
-
-  return stats;
+  return measure_parse(parser, hardware_counters, [&] { parser.parse_trade(callback); });
 }
 
 } // namespace databento
@@ -0,0 +1,153 @@
+#include "databento/perf_counters.hpp"
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace databento {
+
+namespace {
+
+#ifdef __linux__
+
+struct EventSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfEvent
+constexpr EventSpec EVENTS[NUM_PERF_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int open_event(const EventSpec& spec, bool exclude_kernel) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = exclude_kernel;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+int open_event(const EventSpec& spec) {
+  // Page faults taken while the kernel copies file data into our buffer
+  // are kernel-mode, so software events try to include the kernel first
+  if (spec.type == PERF_TYPE_SOFTWARE) {
+    const int fd = open_event(spec, false);
+    if (fd >= 0) {
+      return fd;
+    }
+  }
+  return open_event(spec, true);
+}
+
+#endif
+
+} // namespace
+
+// ============================================================================
+// PerfSample / PhaseCounters
+// ============================================================================
+
+double PerfSample::per_record(PerfEvent e, uint64_t records) const {
+  if (!has(e) || records == 0) {
+    return PhaseCounters::NaN;
+  }
+  return static_cast<double>(get(e)) / static_cast<double>(records);
+}
+
+PhaseCounters PhaseCounters::from(const PerfSample& sample, uint64_t records) {
+  PhaseCounters c;
+  c.sample = sample;
+  c.cycles_per_record = sample.per_record(PerfEvent::Cycles, records);
+  c.instructions_per_record = sample.per_record(PerfEvent::Instructions, records);
+  c.llc_misses_per_record = sample.per_record(PerfEvent::LlcMisses, records);
+  c.dtlb_misses_per_record = sample.per_record(PerfEvent::DtlbMisses, records);
+  c.page_faults_per_record = sample.per_record(PerfEvent::PageFaults, records);
+  return c;
+}
+
+// ============================================================================
+// PerfCounters
+// ============================================================================
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+#ifdef __linux__
+  for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+    fds_[e] = open_event(EVENTS[e]);
+    if (fds_[e] >= 0) {
+      available_mask_ |= 1u << e;
+    }
+  }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+PerfSample PerfCounters::stop() {
+  PerfSample sample;
+#ifdef __linux__
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+    if (fds_[e] < 0) {
+      continue;
+    }
+    uint64_t buf[3];  // value, time enabled, time running
+    if (::read(fds_[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+      continue;
+    }
+    uint64_t value = buf[0];
+    if (buf[2] > 0 && buf[2] < buf[1]) {
+      value = static_cast<uint64_t>(static_cast<double>(value) * buf[1] / buf[2]);
+    } else if (buf[2] == 0 && buf[1] > 0) {
+      continue;  // Never scheduled on the PMU
+    }
+    sample.values[e] = value;
+    sample.available_mask |= 1u << e;
+  }
+#endif
+  return sample;
+}
+
+} // namespace databento
@@ -0,0 +1,276 @@
+#include "databento/replay.hpp"
+#include "databento/spsc_queue.hpp"
+#include <bit>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace databento {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+inline int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now().time_since_epoch()).count();
+}
+
+// Hybrid wait: coarse sleep while far from the deadline, then spin on the
+// clock so wake-up jitter from the scheduler does not reach the callback.
+inline int64_t wait_until_ns(int64_t deadline_ns, int64_t spin_threshold_ns) {
+  int64_t now = now_ns();
+  const int64_t remaining = deadline_ns - now;
+  if (remaining > spin_threshold_ns) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - spin_threshold_ns));
+    now = now_ns();
+  }
+  while (now < deadline_ns) {
+    cpu_relax();
+    now = now_ns();
+  }
+  return now;
+}
+
+// Maps ts_event to a steady-clock deadline; out-of-order timestamps are
+// clamped so the schedule never runs backwards.
+class Schedule {
+public:
+  Schedule(double speed, uint64_t first_ts, int64_t start_ns)
+      : speed_(speed), first_ts_(first_ts), last_ts_(first_ts), start_ns_(start_ns) {}
+
+  int64_t deadline(uint64_t ts_event) {
+    if (ts_event > last_ts_) {
+      last_ts_ = ts_event;
+    }
+    const uint64_t offset = last_ts_ - first_ts_;
+    if (speed_ == 1.0) {
+      return start_ns_ + static_cast<int64_t>(offset);
+    }
+    return start_ns_ + static_cast<int64_t>(static_cast<double>(offset) / speed_);
+  }
+
+private:
+  double speed_;
+  uint64_t first_ts_;
+  uint64_t last_ts_;
+  int64_t start_ns_;
+};
+
+struct ScheduledRecord {
+  MboMsg msg;
+  int64_t deadline_ns;
+};
+
+} // namespace
+
+// ============================================================================
+// PacingHistogram Implementation
+// ============================================================================
+
+void PacingHistogram::record(int64_t error_ns) {
+  if (error_ns < 0) {
+    ++early_;
+  }
+  const uint64_t abs_err = error_ns < 0 ? static_cast<uint64_t>(-error_ns)
+                                        : static_cast<uint64_t>(error_ns);
+  size_t bucket = static_cast<size_t>(std::bit_width(abs_err));
+  if (bucket >= NUM_BUCKETS) {
+    bucket = NUM_BUCKETS - 1;
+  }
+  ++buckets_[bucket];
+  ++count_;
+  sum_abs_ns_ += abs_err;
+  if (abs_err > max_abs_ns_) {
+    max_abs_ns_ = abs_err;
+  }
+}
+
+uint64_t PacingHistogram::percentile(double pct) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const double target = pct / 100.0 * static_cast<double>(count_);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    seen += buckets_[i];
+    if (static_cast<double>(seen) >= target && buckets_[i] > 0) {
+      return i == 0 ? 0 : (uint64_t{1} << i) - 1;
+    }
+  }
+  return max_abs_ns_;
+}
+
+void PacingHistogram::print() const {
+  std::cout << "Pacing error (|actual - scheduled|):\n";
+  std::cout << "  samples: " << count_ << " (early: " << early_ << ")\n";
+  std::cout << "  mean:    " << std::fixed << std::setprecision(1) << mean_abs_ns() << " ns\n";
+  std::cout << "  p50:     <= " << percentile(50) << " ns\n";
+  std::cout << "  p99:     <= " << percentile(99) << " ns\n";
+  std::cout << "  p99.9:   <= " << percentile(99.9) << " ns\n";
+  std::cout << "  max:     " << max_abs_ns_ << " ns\n";
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    if (buckets_[i] == 0) {
+      continue;
+    }
+    const uint64_t upper = i == 0 ? 0 : (uint64_t{1} << i) - 1;
+    std::cout << "  <= " << std::setw(12) << upper << " ns: " << buckets_[i] << "\n";
+  }
+}
+
+// ============================================================================
+// ReplayStats Implementation
+// ============================================================================
+
+void ReplayStats::print() const {
+  std::cout << "\n" << std::string(70, '=') << "\n";
+  std::cout << "Replay Statistics\n";
+  std::cout << std::string(70, '=') << "\n";
+  std::cout << "Total records:  " << total_records << "\n";
+  std::cout << "Data span:      " << data_span_seconds << " seconds\n";
+  std::cout << "Elapsed time:   " << elapsed_seconds << " seconds\n";
+  if (pacing_error.count() > 0) {
+    pacing_error.print();
+  }
+  std::cout << std::string(70, '=') << "\n";
+}
+
+// ============================================================================
+// ReplayEngine Implementation
+// ============================================================================
+
+ReplayStats ReplayEngine::replay_mbo(DbnParser& parser, MboCallback callback) {
+  if (!parser.data()) {
+    parser.load_into_memory();
+  }
+  if (options_.speed < 0.0) {
+    throw std::invalid_argument("Replay speed must be >= 0");
+  }
+
+  stop_requested_.store(false, std::memory_order_relaxed);
+  ReplayStats stats = options_.threaded ? replay_threaded(parser, callback)
+                                        : replay_inline(parser, callback);
+
+  if (parser.num_records() > 0) {
+    const uint64_t first = read_u64_le(parser.get_record(0));
+    const uint64_t last = read_u64_le(parser.get_record(parser.num_records() - 1));
+    stats.data_span_seconds = last > first ? (last - first) / 1e9 : 0.0;
+  }
+  return stats;
+}
+
+ReplayStats ReplayEngine::replay_inline(DbnParser& parser, const MboCallback& callback) {
+  ReplayStats stats;
+  const size_t total = parser.num_records();
+  const int64_t start_ns = now_ns();
+  const int64_t spin_ns = options_.spin_threshold.count();
+  const bool paced = options_.speed > 0.0;
+
+  if (total > 0) {
+    Schedule schedule(options_.speed, read_u64_le(parser.get_record(0)), start_ns);
+    const uint8_t* ptr = parser.get_record(0);
+
+    for (size_t i = 0; i < total; ++i) {
+      if (stop_requested_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      const MboMsg msg = parse_mbo(ptr);
+      if (paced) {
+        const int64_t deadline = schedule.deadline(msg.ts_event);
+        const int64_t delivered = wait_until_ns(deadline, spin_ns);
+        stats.pacing_error.record(delivered - deadline);
+      }
+      callback(msg);
+      ++stats.total_records;
+      ptr += parser.record_size();
+    }
+  }
+
+  stats.elapsed_seconds = (now_ns() - start_ns) / 1e9;
+  return stats;
+}
+
+ReplayStats ReplayEngine::replay_threaded(DbnParser& parser, const MboCallback& callback) {
+  ReplayStats stats;
+  const size_t total = parser.num_records();
+  if (total == 0) {
+    return stats;
+  }
+
+  SpscQueue<ScheduledRecord> queue(options_.queue_capacity);
+  std::atomic<bool> producer_done{false};
+  std::exception_ptr consumer_error;
+  const int64_t spin_ns = options_.spin_threshold.count();
+  const bool paced = options_.speed > 0.0;
+  const int64_t start_ns = now_ns();
+
+  // The consumer owns pacing so queue hand-off latency is not added to the
+  // delivery jitter; the producer only has to stay ahead of the schedule.
+  std::thread consumer([&] {
+    try {
+      ScheduledRecord rec;
+      while (true) {
+        if (!queue.try_pop(rec)) {
+          if (producer_done.load(std::memory_order_acquire) && !queue.try_pop(rec)) {
+            break;
+          }
+          if (stop_requested_.load(std::memory_order_relaxed)) {
+            break;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+        if (stop_requested_.load(std::memory_order_relaxed)) {
+          break;
+        }
+        if (paced) {
+          const int64_t delivered = wait_until_ns(rec.deadline_ns, spin_ns);
+          stats.pacing_error.record(delivered - rec.deadline_ns);
+        }
+        callback(rec.msg);
+        ++stats.total_records;
+      }
+    } catch (...) {
+      consumer_error = std::current_exception();
+      stop_requested_.store(true, std::memory_order_relaxed);
+    }
+  });
+
+  Schedule schedule(options_.speed, read_u64_le(parser.get_record(0)), start_ns);
+  const uint8_t* ptr = parser.get_record(0);
+  for (size_t i = 0; i < total; ++i) {
+    ScheduledRecord rec;
+    rec.msg = parse_mbo(ptr);
+    rec.deadline_ns = paced ? schedule.deadline(rec.msg.ts_event) : 0;
+    while (!queue.try_push(rec)) {
+      if (stop_requested_.load(std::memory_order_relaxed)) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+    if (stop_requested_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    ptr += parser.record_size();
+  }
+  producer_done.store(true, std::memory_order_release);
+  consumer.join();
+
+  if (consumer_error) {
+    std::rethrow_exception(consumer_error);
+  }
+
+  stats.elapsed_seconds = (now_ns() - start_ns) / 1e9;
+  return stats;
+}
+
+} // namespace databento
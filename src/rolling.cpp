@@ -0,0 +1,218 @@
+#include "databento/rolling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace databento {
+
+// ============================================================================
+// WindowStats
+// ============================================================================
+
+double WindowStats::volatility() const {
+  if (changes < 2) {
+    return 0.0;
+  }
+  // n * sum(x^2) - sum(x)^2 is exact in 128 bits; only the final divide rounds
+  const int128_t n = static_cast<int128_t>(changes);
+  const int128_t numerator = n * sum_change_sq - sum_change * sum_change;
+  const long double variance = static_cast<long double>(numerator) /
+                               (static_cast<long double>(changes) * static_cast<long double>(changes - 1));
+  return static_cast<double>(std::sqrt(variance) / 1e9L);
+}
+
+double WindowStats::imbalance() const {
+  const uint64_t total = buy_volume + sell_volume;
+  if (total == 0) {
+    return 0.0;
+  }
+  return (static_cast<double>(buy_volume) - static_cast<double>(sell_volume)) /
+         static_cast<double>(total);
+}
+
+// ============================================================================
+// RollingWindows
+// ============================================================================
+
+RollingWindows::RollingWindows(const RollingOptions& options) : windows_ns_(options.windows_ns) {
+  if (windows_ns_.empty()) {
+    throw std::invalid_argument("RollingWindows needs at least one window");
+  }
+  for (uint64_t ns : windows_ns_) {
+    if (ns == 0) {
+      throw std::invalid_argument("Rolling window length must be positive");
+    }
+  }
+  for (char c : options.trade_actions) {
+    is_trade_action_[static_cast<uint8_t>(c)] = 1;
+  }
+}
+
+void RollingWindows::add(const MboMsg& msg) {
+  now_ = std::max(now_, msg.ts_event);
+  if (!is_trade_action_[static_cast<uint8_t>(msg.action)]) {
+    return;
+  }
+  auto [slot, inserted] = index_.try_emplace(msg.instrument_id, static_cast<uint32_t>(instruments_.size()));
+  if (inserted) {
+    instruments_.emplace_back();
+    instruments_.back().windows.resize(windows_ns_.size());
+    for (size_t w = 0; w < windows_ns_.size(); ++w) {
+      instruments_.back().windows[w].stats.window_ns = windows_ns_[w];
+    }
+    ids_.push_back(msg.instrument_id);
+  }
+  Instrument& inst = instruments_[*slot];
+
+  const uint64_t ts = std::max(msg.ts_event, inst.last_ts);
+  const Trade trade{ts, msg.price, msg.size, msg.side, inst.has_trade,
+                    inst.has_trade ? msg.price - inst.last_price : 0};
+  inst.last_ts = ts;
+  inst.has_trade = true;
+  inst.last_price = msg.price;
+  push(inst, trade);
+  evict(inst, ts);
+}
+
+void RollingWindows::add(const std::vector<MboMsg>& batch) {
+  for (const auto& msg : batch) {
+    add(msg);
+  }
+}
+
+void RollingWindows::push(Instrument& inst, const Trade& trade) {
+  const uint64_t seq = inst.base + inst.trades.size();
+  inst.trades.push_back(trade);
+
+  for (Window& window : inst.windows) {
+    WindowStats& s = window.stats;
+    ++s.trades;
+    s.volume += trade.size;
+    s.buy_volume += trade.side == 'B' ? trade.size : 0;
+    s.sell_volume += trade.side == 'A' ? trade.size : 0;
+    s.notional += static_cast<int128_t>(trade.price) * trade.size;
+    if (trade.has_change) {
+      ++s.changes;
+      s.sum_change += trade.change;
+      s.sum_change_sq += static_cast<int128_t>(trade.change) * trade.change;
+    }
+
+    while (!window.min_seq.empty() && trade_at(inst, window.min_seq.back()).price >= trade.price) {
+      window.min_seq.pop_back();
+    }
+    window.min_seq.push_back(seq);
+    while (!window.max_seq.empty() && trade_at(inst, window.max_seq.back()).price <= trade.price) {
+      window.max_seq.pop_back();
+    }
+    window.max_seq.push_back(seq);
+  }
+}
+
+void RollingWindows::remove_trade(WindowStats& s, const Trade& trade) {
+  --s.trades;
+  s.volume -= trade.size;
+  s.buy_volume -= trade.side == 'B' ? trade.size : 0;
+  s.sell_volume -= trade.side == 'A' ? trade.size : 0;
+  s.notional -= static_cast<int128_t>(trade.price) * trade.size;
+  if (trade.has_change) {
+    --s.changes;
+    s.sum_change -= trade.change;
+    s.sum_change_sq -= static_cast<int128_t>(trade.change) * trade.change;
+  }
+}
+
+void RollingWindows::evict(Instrument& inst, uint64_t now) {
+  inst.evicted_to = std::max(inst.evicted_to, now);
+  const uint64_t end = inst.base + inst.trades.size();
+  uint64_t oldest_needed = end;
+
+  for (size_t w = 0; w < inst.windows.size(); ++w) {
+    Window& window = inst.windows[w];
+    WindowStats& s = window.stats;
+    const uint64_t length = windows_ns_[w];
+
+    while (window.head < end) {
+      const Trade& trade = trade_at(inst, window.head);
+      if (trade.ts > now || now - trade.ts < length) {
+        break;
+      }
+      remove_trade(s, trade);
+      if (window.min_seq.front() == window.head) {
+        window.min_seq.pop_front();
+      }
+      if (window.max_seq.front() == window.head) {
+        window.max_seq.pop_front();
+      }
+      ++window.head;
+    }
+
+    s.min_price = window.min_seq.empty() ? INT64_MAX : trade_at(inst, window.min_seq.front()).price;
+    s.max_price = window.max_seq.empty() ? INT64_MIN : trade_at(inst, window.max_seq.front()).price;
+    oldest_needed = std::min(oldest_needed, window.head);
+  }
+
+  // Trades every window has moved past
+  while (inst.base < oldest_needed) {
+    inst.trades.pop_front();
+    ++inst.base;
+  }
+}
+
+WindowStats RollingWindows::stats(uint32_t instrument_id, size_t window) {
+  return stats(instrument_id, window, now_);
+}
+
+WindowStats RollingWindows::stats(uint32_t instrument_id, size_t window, uint64_t now) {
+  if (window >= windows_ns_.size()) {
+    throw std::out_of_range("Rolling window index out of range");
+  }
+  const uint32_t* slot = index_.find(instrument_id);
+  if (slot == nullptr) {
+    WindowStats empty;
+    empty.window_ns = windows_ns_[window];
+    return empty;
+  }
+  Instrument& inst = instruments_[*slot];
+  // add() evicts to each trade's time, so this also covers last_ts
+  if (now < inst.evicted_to) {
+    throw std::invalid_argument("Rolling stats time precedes the instrument's last trade or query");
+  }
+  // Records fed later are never older than now_, so evicting up to it is
+  // final; anything past it is only a projection
+  evict(inst, std::min(now, now_));
+  if (now <= now_) {
+    return inst.windows[window].stats;
+  }
+  return stats_at(inst, window, now);
+}
+
+WindowStats RollingWindows::stats_at(const Instrument& inst, size_t window, uint64_t now) const {
+  const Window& state = inst.windows[window];
+  WindowStats s = state.stats;
+  const uint64_t end = inst.base + inst.trades.size();
+  uint64_t head = state.head;
+  for (; head < end; ++head) {
+    const Trade& trade = trade_at(inst, head);
+    if (now - trade.ts < windows_ns_[window]) {
+      break;
+    }
+    remove_trade(s, trade);
+  }
+  // The deques hold increasing sequence numbers; skip the expired ones
+  auto first_inside = [&](const std::deque<uint64_t>& seqs) {
+    return std::lower_bound(seqs.begin(), seqs.end(), head);
+  };
+  const auto min_it = first_inside(state.min_seq);
+  const auto max_it = first_inside(state.max_seq);
+  s.min_price = min_it == state.min_seq.end() ? INT64_MAX : trade_at(inst, *min_it).price;
+  s.max_price = max_it == state.max_seq.end() ? INT64_MIN : trade_at(inst, *max_it).price;
+  return s;
+}
+
+std::vector<uint32_t> RollingWindows::instruments() const {
+  std::vector<uint32_t> ids = ids_;
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+} // namespace databento
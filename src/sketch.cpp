@@ -0,0 +1,317 @@
+#include "databento/sketch.hpp"
+#include "databento/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace databento {
+
+// ============================================================================
+// KllSketch
+// ============================================================================
+
+KllSketch::KllSketch(uint32_t k, uint64_t seed)
+    : k_(k),
+      min_(std::numeric_limits<double>::quiet_NaN()),
+      max_(std::numeric_limits<double>::quiet_NaN()),
+      rng_(mix_hash(seed) | 1) {
+  if (k < 8) {
+    throw std::invalid_argument("KLL k must be at least 8");
+  }
+  add_level();
+}
+
+// Capacity shrinks by 2/3 per level below the top, so adding a level
+// changes every level's capacity
+void KllSketch::add_level() {
+  levels_.emplace_back();
+  capacities_.resize(levels_.size());
+  total_capacity_ = 0;
+  for (size_t h = 0; h < levels_.size(); ++h) {
+    const size_t depth = levels_.size() - 1 - h;
+    const double cap = std::ceil(k_ * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+    capacities_[h] = std::max<size_t>(2, static_cast<size_t>(cap));
+    total_capacity_ += capacities_[h];
+  }
+}
+
+void KllSketch::update(double value) {
+  if (std::isnan(value)) {
+    return;
+  }
+  if (n_ == 0) {
+    min_ = max_ = value;
+  } else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  ++n_;
+  levels_[0].push_back(value);
+  ++retained_;
+  if (levels_[0].size() >= capacities_[0]) {
+    compress();
+  }
+}
+
+void KllSketch::compress() {
+  while (retained_ > total_capacity_ || levels_[0].size() >= capacities_[0]) {
+    size_t h = 0;
+    while (h < levels_.size() && levels_[h].size() < capacities_[h]) {
+      ++h;
+    }
+    if (h == levels_.size()) {
+      return;
+    }
+    compact(h);
+  }
+}
+
+void KllSketch::compact(size_t level) {
+  if (level + 1 == levels_.size()) {
+    add_level();
+  }
+  auto& items = levels_[level];
+  auto& above = levels_[level + 1];
+  std::sort(items.begin(), items.end());
+
+  // xorshift64 coin for the offset
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 7;
+  rng_ ^= rng_ << 17;
+  const size_t offset = rng_ & 1;
+
+  // An odd item out stays behind at this level
+  const size_t paired = items.size() & ~size_t{1};
+  for (size_t i = offset; i < paired; i += 2) {
+    above.push_back(items[i]);
+  }
+  const bool odd = items.size() != paired;
+  const double leftover = odd ? items.back() : 0.0;
+  retained_ -= items.size();
+  items.clear();
+  if (odd) {
+    items.push_back(leftover);
+  }
+  retained_ += (odd ? 1 : 0) + paired / 2;
+}
+
+void KllSketch::merge(const KllSketch& other) {
+  if (other.n_ == 0) {
+    return;
+  }
+  if (n_ == 0) {
+    min_ = other.min_;
+    max_ = other.max_;
+  } else {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+  n_ += other.n_;
+  while (levels_.size() < other.levels_.size()) {
+    add_level();
+  }
+  for (size_t h = 0; h < other.levels_.size(); ++h) {
+    levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+    retained_ += other.levels_[h].size();
+  }
+  compress();
+}
+
+double KllSketch::quantile(double q) const {
+  if (n_ == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (q <= 0) {
+    return min_;
+  }
+  if (q >= 1) {
+    return max_;
+  }
+  std::vector<std::pair<double, uint64_t>> weighted;
+  weighted.reserve(retained_);
+  for (size_t h = 0; h < levels_.size(); ++h) {
+    for (double v : levels_[h]) {
+      weighted.emplace_back(v, uint64_t{1} << h);
+    }
+  }
+  std::sort(weighted.begin(), weighted.end());
+
+  const double target = q * static_cast<double>(n_);
+  uint64_t cumulative = 0;
+  for (const auto& [value, weight] : weighted) {
+    cumulative += weight;
+    if (static_cast<double>(cumulative) >= target) {
+      return value;
+    }
+  }
+  return max_;
+}
+
+double KllSketch::rank(double value) const {
+  if (n_ == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  uint64_t below = 0;
+  for (size_t h = 0; h < levels_.size(); ++h) {
+    for (double v : levels_[h]) {
+      below += v <= value ? (uint64_t{1} << h) : 0;
+    }
+  }
+  return static_cast<double>(below) / static_cast<double>(n_);
+}
+
+// ============================================================================
+// HyperLogLog
+// ============================================================================
+
+HyperLogLog::HyperLogLog(uint8_t precision) : precision_(precision) {
+  if (precision < 4 || precision > 18) {
+    throw std::invalid_argument("HyperLogLog precision must be in [4, 18]");
+  }
+  registers_.assign(size_t{1} << precision, 0);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+  if (other.precision_ != precision_) {
+    throw std::invalid_argument("Cannot merge HyperLogLogs of different precision");
+  }
+  for (size_t i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+double HyperLogLog::estimate() const {
+  const double m = static_cast<double>(registers_.size());
+  double sum = 0;
+  size_t zeros = 0;
+  for (uint8_t r : registers_) {
+    sum += std::ldexp(1.0, -static_cast<int>(r));
+    zeros += r == 0;
+  }
+  double alpha;
+  switch (registers_.size()) {
+    case 16: alpha = 0.673; break;
+    case 32: alpha = 0.697; break;
+    case 64: alpha = 0.709; break;
+    default: alpha = 0.7213 / (1.0 + 1.079 / m); break;
+  }
+  const double raw = alpha * m * m / sum;
+  // Linear counting is far more accurate while many registers are empty
+  if (raw <= 2.5 * m && zeros > 0) {
+    return m * std::log(m / static_cast<double>(zeros));
+  }
+  return raw;
+}
+
+// ============================================================================
+// Per-Instrument Sketches
+// ============================================================================
+
+InstrumentSketch::InstrumentSketch(const SketchOptions& options, uint32_t instrument_id)
+    : sizes(options.kll_k, options.seed ^ (uint64_t{instrument_id} << 1)),
+      price_changes(options.kll_k, options.seed ^ ((uint64_t{instrument_id} << 1) | 1)),
+      order_ids(options.hll_precision) {}
+
+InstrumentSketches::InstrumentSketches(const SketchOptions& options) : options_(options) {
+  for (char c : options.size_actions) {
+    is_size_action_[static_cast<uint8_t>(c)] = 1;
+  }
+  for (char c : options.trade_actions) {
+    is_trade_action_[static_cast<uint8_t>(c)] = 1;
+  }
+  // Throws now, rather than on the first record, if kll_k or
+  // hll_precision is out of range
+  const InstrumentSketch validate(options_, 0);
+  (void)validate;
+}
+
+InstrumentSketch& InstrumentSketches::sketch_for(uint32_t instrument_id) {
+  auto [slot, inserted] = index_.try_emplace(instrument_id, static_cast<uint32_t>(sketches_.size()));
+  if (inserted) {
+    sketches_.emplace_back(options_, instrument_id);
+    ids_.push_back(instrument_id);
+  }
+  return sketches_[*slot];
+}
+
+void InstrumentSketches::add(const MboMsg& msg) {
+  InstrumentSketch& sketch = sketch_for(msg.instrument_id);
+  const auto action = static_cast<uint8_t>(msg.action);
+  if (is_size_action_[action]) {
+    sketch.sizes.update(static_cast<double>(msg.size));
+  }
+  if (is_trade_action_[action]) {
+    if (sketch.has_trade) {
+      sketch.price_changes.update(static_cast<double>(msg.price - sketch.last_trade_price));
+    } else {
+      sketch.has_trade = true;
+      sketch.first_trade_price = msg.price;
+    }
+    sketch.last_trade_price = msg.price;
+  }
+  if (msg.order_id != 0) {
+    sketch.order_ids.add(msg.order_id);
+  }
+}
+
+void InstrumentSketches::add(const std::vector<MboMsg>& batch) {
+  for (const auto& msg : batch) {
+    add(msg);
+  }
+}
+
+void InstrumentSketches::merge(const InstrumentSketches& later) {
+  for (size_t i = 0; i < later.sketches_.size(); ++i) {
+    const InstrumentSketch& theirs = later.sketches_[i];
+    InstrumentSketch& ours = sketch_for(later.ids_[i]);
+    ours.sizes.merge(theirs.sizes);
+    ours.price_changes.merge(theirs.price_changes);
+    ours.order_ids.merge(theirs.order_ids);
+    if (theirs.has_trade) {
+      if (ours.has_trade) {
+        ours.price_changes.update(
+            static_cast<double>(theirs.first_trade_price - ours.last_trade_price));
+      } else {
+        ours.has_trade = true;
+        ours.first_trade_price = theirs.first_trade_price;
+      }
+      ours.last_trade_price = theirs.last_trade_price;
+    }
+  }
+}
+
+const InstrumentSketch* InstrumentSketches::find(uint32_t instrument_id) const {
+  const uint32_t* slot = index_.find(instrument_id);
+  return slot ? &sketches_[*slot] : nullptr;
+}
+
+std::vector<uint32_t> InstrumentSketches::instruments() const {
+  std::vector<uint32_t> ids = ids_;
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+InstrumentSketches sketch_by_instrument(const query::RecordRange& records,
+                                        const SketchOptions& options) {
+  const unsigned threads = static_cast<unsigned>(std::min<size_t>(
+      resolve_thread_count(options.threads), std::max<size_t>(1, records.count)));
+  std::vector<InstrumentSketches> partials(threads, InstrumentSketches(options));
+
+  parallel_for(threads, [&](unsigned t) {
+    const auto [begin, end] = chunk_range(records.count, threads, t);
+    const uint8_t* rec = records.data + begin * records.stride;
+    for (size_t i = begin; i < end; ++i, rec += records.stride) {
+      partials[t].add(parse_mbo(rec));
+    }
+  });
+
+  // In chunk order, so boundary price changes join correctly
+  for (unsigned t = 1; t < threads; ++t) {
+    partials[0].merge(partials[t]);
+  }
+  return std::move(partials[0]);
+}
+
+} // namespace databento
@@ -0,0 +1,418 @@
+#include "databento/sort.hpp"
+#include "databento/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace databento {
+
+namespace {
+
+constexpr size_t RECORD_SIZE = sizeof(MboMsg);
+constexpr size_t TS_OFFSET = 0;
+constexpr size_t INSTRUMENT_OFFSET = 8;
+constexpr size_t SEQUENCE_OFFSET = 40;
+constexpr size_t PARALLEL_THRESHOLD = 1 << 16;
+
+// Unique per process and per run, so concurrent sort_file calls sharing a
+// temp_dir never collide
+std::string run_file_path(const std::string& temp_dir) {
+  static std::atomic<uint64_t> next_run{0};
+  return temp_dir + "/dbn_sort_run_" + std::to_string(::getpid()) + "_" +
+         std::to_string(next_run.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+}
+
+// Composite key split into the part compared last (major) and first (minor)
+struct KeyParts {
+  uint64_t major;
+  uint64_t minor;
+};
+
+struct KeyLayout {
+  unsigned minor_bytes;
+  unsigned major_bytes;
+};
+
+KeyLayout layout_for(SortKey key) {
+  return key == SortKey::TimeSequence ? KeyLayout{4, 8} : KeyLayout{8, 4};
+}
+
+inline KeyParts record_key(const uint8_t* record, SortKey key) {
+  if (key == SortKey::TimeSequence) {
+    return {read_u64_le(record + TS_OFFSET), read_u32_le(record + SEQUENCE_OFFSET)};
+  }
+  return {read_u32_le(record + INSTRUMENT_OFFSET), read_u64_le(record + TS_OFFSET)};
+}
+
+inline bool key_less(const KeyParts& a, const KeyParts& b) {
+  return a.major != b.major ? a.major < b.major : a.minor < b.minor;
+}
+
+struct KeyedIndex {
+  uint64_t major;
+  uint64_t minor;
+  uint32_t index;
+};
+
+struct RawRecord {
+  uint8_t bytes[RECORD_SIZE];
+};
+
+struct Pass {
+  bool major;
+  unsigned shift;
+};
+
+using Histogram = std::array<size_t, 256>;
+
+// Stable parallel LSD radix sort. key_of(const T&) returns KeyParts.
+template<typename T, typename KeyFn>
+void radix_sort(T* data, T* scratch, size_t n, SortKey sort_key, unsigned threads,
+                KeyFn key_of) {
+  if (n < 2) {
+    return;
+  }
+  if (n < PARALLEL_THRESHOLD) {
+    threads = 1;
+  }
+
+  const KeyLayout layout = layout_for(sort_key);
+  std::vector<Pass> passes;
+  for (unsigned b = 0; b < layout.minor_bytes; ++b) {
+    passes.push_back(Pass{false, 8 * b});
+  }
+  for (unsigned b = 0; b < layout.major_bytes; ++b) {
+    passes.push_back(Pass{true, 8 * b});
+  }
+
+  auto digit = [&](const T& item, const Pass& pass) -> size_t {
+    const KeyParts k = key_of(item);
+    return ((pass.major ? k.major : k.minor) >> pass.shift) & 0xFF;
+  };
+
+  // One read over the data finds passes where every record shares a digit
+  std::vector<std::vector<Histogram>> global(threads, std::vector<Histogram>(passes.size()));
+  parallel_for(threads, [&](unsigned t) {
+    auto [begin, end] = chunk_range(n, threads, t);
+    auto& hists = global[t];
+    for (auto& h : hists) {
+      h.fill(0);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      const KeyParts k = key_of(data[i]);
+      for (size_t p = 0; p < passes.size(); ++p) {
+        const uint64_t word = passes[p].major ? k.major : k.minor;
+        ++hists[p][(word >> passes[p].shift) & 0xFF];
+      }
+    }
+  });
+
+  std::vector<Pass> active;
+  for (size_t p = 0; p < passes.size(); ++p) {
+    bool trivial = false;
+    for (size_t b = 0; b < 256 && !trivial; ++b) {
+      size_t total = 0;
+      for (unsigned t = 0; t < threads; ++t) {
+        total += global[t][p][b];
+      }
+      trivial = total == n;
+    }
+    if (!trivial) {
+      active.push_back(passes[p]);
+    }
+  }
+
+  T* src = data;
+  T* dst = scratch;
+  std::vector<Histogram> counts(threads);
+  std::vector<Histogram> offsets(threads);
+
+  for (const Pass& pass : active) {
+    parallel_for(threads, [&](unsigned t) {
+      auto [begin, end] = chunk_range(n, threads, t);
+      Histogram& h = counts[t];
+      h.fill(0);
+      for (size_t i = begin; i < end; ++i) {
+        ++h[digit(src[i], pass)];
+      }
+    });
+
+    // Bucket-major, thread-minor prefix sum keeps the scatter stable
+    size_t running = 0;
+    for (size_t b = 0; b < 256; ++b) {
+      for (unsigned t = 0; t < threads; ++t) {
+        offsets[t][b] = running;
+        running += counts[t][b];
+      }
+    }
+
+    parallel_for(threads, [&](unsigned t) {
+      auto [begin, end] = chunk_range(n, threads, t);
+      Histogram& off = offsets[t];
+      for (size_t i = begin; i < end; ++i) {
+        dst[off[digit(src[i], pass)]++] = src[i];
+      }
+    });
+    std::swap(src, dst);
+  }
+
+  if (src != data) {
+    parallel_for(threads, [&](unsigned t) {
+      auto [begin, end] = chunk_range(n, threads, t);
+      std::copy(src + begin, src + end, data + begin);
+    });
+  }
+}
+
+void sort_raw_records(RawRecord* records, size_t count, const SortOptions& options) {
+  std::unique_ptr<RawRecord[]> scratch(new RawRecord[count]);
+  const SortKey key = options.key;
+  radix_sort(records, scratch.get(), count, key, resolve_thread_count(options.threads),
+             [key](const RawRecord& r) { return record_key(r.bytes, key); });
+}
+
+// Buffered sequential writer for output files
+class RecordWriter {
+public:
+  explicit RecordWriter(const std::string& path, size_t buffer_size = 4 << 20)
+      : out_(path, std::ios::binary | std::ios::trunc), path_(path) {
+    if (!out_) {
+      throw std::runtime_error("Failed to create file: " + path);
+    }
+    buffer_.reserve(buffer_size);
+  }
+
+  void write(const uint8_t* data, size_t len) {
+    if (buffer_.size() + len > buffer_.capacity()) {
+      flush();
+    }
+    if (len > buffer_.capacity()) {
+      out_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(len));
+      return;
+    }
+    buffer_.insert(buffer_.end(), data, data + len);
+  }
+
+  void close() {
+    flush();
+    out_.close();
+    if (!out_) {
+      throw std::runtime_error("Failed to write file: " + path_);
+    }
+  }
+
+private:
+  std::ofstream out_;
+  std::string path_;
+  std::vector<uint8_t> buffer_;
+
+  void flush() {
+    out_.write(reinterpret_cast<const char*>(buffer_.data()),
+               static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+  }
+};
+
+// Sequential reader over one sorted run
+class RunReader {
+public:
+  RunReader(const std::string& path, size_t buffer_records)
+      : in_(path, std::ios::binary), buffer_(buffer_records * RECORD_SIZE) {
+    if (!in_) {
+      throw std::runtime_error("Failed to open sort run: " + path);
+    }
+    refill();
+  }
+
+  bool done() const { return pos_ >= len_; }
+  const uint8_t* current() const { return buffer_.data() + pos_; }
+
+  void advance() {
+    pos_ += RECORD_SIZE;
+    if (pos_ >= len_) {
+      refill();
+    }
+  }
+
+private:
+  std::ifstream in_;
+  std::vector<uint8_t> buffer_;
+  size_t pos_ = 0;
+  size_t len_ = 0;
+
+  void refill() {
+    in_.read(reinterpret_cast<char*>(buffer_.data()),
+             static_cast<std::streamsize>(buffer_.size()));
+    len_ = static_cast<size_t>(in_.gcount()) / RECORD_SIZE * RECORD_SIZE;
+    pos_ = 0;
+  }
+};
+
+// Removes spilled runs however sort_file exits
+struct TempFiles {
+  std::vector<std::string> paths;
+  ~TempFiles() {
+    for (const auto& p : paths) {
+      std::remove(p.c_str());
+    }
+  }
+};
+
+void sort_file_out_of_core(const std::string& input_path, const std::string& output_path,
+                           const SortOptions& options) {
+  std::ifstream in(input_path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("Failed to open file: " + input_path);
+  }
+  const size_t file_size = static_cast<size_t>(in.tellg());
+  in.seekg(0);
+
+  // Metadata layout matches DbnParser: fixed-size block before the records
+  const size_t metadata_size = DbnParser(input_path).metadata_offset();
+  std::vector<uint8_t> metadata(std::min(metadata_size, file_size));
+  in.read(reinterpret_cast<char*>(metadata.data()), static_cast<std::streamsize>(metadata.size()));
+  const size_t total = file_size > metadata_size ? (file_size - metadata_size) / RECORD_SIZE : 0;
+
+  // Phase 1: sorted runs of budget/2 (the other half is radix scratch)
+  const size_t run_records = std::max<size_t>(1, options.memory_budget / 2 / RECORD_SIZE);
+  std::unique_ptr<RawRecord[]> chunk(new RawRecord[std::min(run_records, std::max<size_t>(total, 1))]);
+  TempFiles runs;
+  for (size_t done = 0; done < total; done += run_records) {
+    const size_t count = std::min(run_records, total - done);
+    in.read(reinterpret_cast<char*>(chunk.get()), static_cast<std::streamsize>(count * RECORD_SIZE));
+    if (!in) {
+      throw std::runtime_error("Failed to read file: " + input_path);
+    }
+    sort_raw_records(chunk.get(), count, options);
+
+    runs.paths.push_back(run_file_path(options.temp_dir));
+    RecordWriter run(runs.paths.back());
+    run.write(reinterpret_cast<const uint8_t*>(chunk.get()), count * RECORD_SIZE);
+    run.close();
+  }
+  chunk.reset();
+
+  // Phase 2: k-way merge; ties go to the earlier run to stay stable
+  RecordWriter out(output_path);
+  out.write(metadata.data(), metadata.size());
+
+  const size_t per_run = std::max<size_t>(
+      1024, options.memory_budget / (runs.paths.size() + 1) / RECORD_SIZE);
+  std::vector<std::unique_ptr<RunReader>> readers;
+  for (const auto& path : runs.paths) {
+    readers.push_back(std::make_unique<RunReader>(path, per_run));
+  }
+
+  struct HeapItem {
+    KeyParts key;
+    size_t run;
+  };
+  auto greater = [](const HeapItem& a, const HeapItem& b) {
+    if (key_less(b.key, a.key)) return true;
+    if (key_less(a.key, b.key)) return false;
+    return a.run > b.run;
+  };
+  std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(greater)> heap(greater);
+  for (size_t r = 0; r < readers.size(); ++r) {
+    if (!readers[r]->done()) {
+      heap.push(HeapItem{record_key(readers[r]->current(), options.key), r});
+    }
+  }
+  while (!heap.empty()) {
+    const HeapItem top = heap.top();
+    heap.pop();
+    RunReader& reader = *readers[top.run];
+    out.write(reader.current(), RECORD_SIZE);
+    reader.advance();
+    if (!reader.done()) {
+      heap.push(HeapItem{record_key(reader.current(), options.key), top.run});
+    }
+  }
+  out.close();
+}
+
+} // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+std::vector<uint32_t> sort_record_indices(DbnParser& parser, const SortOptions& options) {
+  if (!parser.data()) {
+    parser.load_into_memory();
+  }
+  const size_t n = parser.num_records();
+  if (n > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Too many records for 32-bit sort indices; use sort_file");
+  }
+
+  const unsigned threads = resolve_thread_count(options.threads);
+  const uint8_t* base = n ? parser.get_record(0) : nullptr;
+  const size_t stride = parser.record_size();
+
+  std::vector<KeyedIndex> items(n);
+  parallel_for(n < PARALLEL_THRESHOLD ? 1 : threads, [&](unsigned t) {
+    auto [begin, end] = chunk_range(n, n < PARALLEL_THRESHOLD ? 1 : threads, t);
+    for (size_t i = begin; i < end; ++i) {
+      const KeyParts k = record_key(base + i * stride, options.key);
+      items[i] = KeyedIndex{k.major, k.minor, static_cast<uint32_t>(i)};
+    }
+  });
+
+  std::vector<KeyedIndex> scratch(n);
+  radix_sort(items.data(), scratch.data(), n, options.key, threads,
+             [](const KeyedIndex& item) { return KeyParts{item.major, item.minor}; });
+
+  std::vector<uint32_t> order(n);
+  for (size_t i = 0; i < n; ++i) {
+    order[i] = items[i].index;
+  }
+  return order;
+}
+
+void sort_records_in_place(uint8_t* records, size_t count, const SortOptions& options) {
+  static_assert(sizeof(RawRecord) == RECORD_SIZE, "RawRecord must match MboMsg");
+  sort_raw_records(reinterpret_cast<RawRecord*>(records), count, options);
+}
+
+void write_records_in_order(DbnParser& parser, const std::vector<uint32_t>& order,
+                            const std::string& output_path) {
+  if (!parser.data()) {
+    parser.load_into_memory();
+  }
+  RecordWriter out(output_path);
+  out.write(parser.data(), std::min(parser.size(), parser.metadata_offset()));
+  for (uint32_t index : order) {
+    out.write(parser.get_record(index), parser.record_size());
+  }
+  out.close();
+}
+
+void sort_file(const std::string& input_path, const std::string& output_path,
+               const SortOptions& options) {
+  std::ifstream probe(input_path, std::ios::binary | std::ios::ate);
+  if (!probe) {
+    throw std::runtime_error("Failed to open file: " + input_path);
+  }
+  const size_t file_size = static_cast<size_t>(probe.tellg());
+  probe.close();
+
+  // In memory: the file plus two 24-byte keyed indices per 48-byte record
+  if (file_size * 2 <= options.memory_budget) {
+    DbnParser parser(input_path);
+    parser.load_into_memory();
+    write_records_in_order(parser, sort_record_indices(parser, options), output_path);
+    return;
+  }
+  sort_file_out_of_core(input_path, output_path, options);
+}
+
+} // namespace databento
@@ -0,0 +1,245 @@
+#include "databento/trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace databento {
+
+namespace detail {
+std::atomic<bool> trace_enabled_flag{false};
+} // namespace detail
+
+namespace {
+
+// ============================================================================
+// Per-Thread Buffers
+// ============================================================================
+
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  uint64_t start_ns;
+  uint64_t end_ns;
+};
+
+struct ThreadBuffer {
+  uint32_t track;
+  std::string name;
+  std::unique_ptr<TraceEvent[]> events;
+  size_t capacity;
+  std::atomic<size_t> size{0};
+  std::atomic<uint64_t> dropped{0};
+  bool in_use = true;
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  std::vector<ThreadBuffer*> free_list;
+  size_t events_per_thread = TRACE_DEFAULT_EVENTS_PER_THREAD;
+  const uint64_t epoch_ns = trace_now_ns();
+};
+
+// Leaked so thread_local destructors running at exit can still use it
+Registry& registry() {
+  static Registry* r = new Registry();
+  return *r;
+}
+
+ThreadBuffer* acquire_buffer() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  if (!r.free_list.empty()) {
+    ThreadBuffer* buffer = r.free_list.back();
+    r.free_list.pop_back();
+    buffer->in_use = true;
+    return buffer;
+  }
+  auto buffer = std::make_unique<ThreadBuffer>();
+  buffer->track = static_cast<uint32_t>(r.buffers.size() + 1);
+  buffer->name = "thread " + std::to_string(buffer->track);
+  buffer->capacity = r.events_per_thread;
+  buffer->events = std::make_unique<TraceEvent[]>(buffer->capacity);
+  r.buffers.push_back(std::move(buffer));
+  return r.buffers.back().get();
+}
+
+// Returns the thread's buffer to the free list on thread exit
+struct LocalBuffer {
+  ThreadBuffer* buffer = nullptr;
+
+  ~LocalBuffer() {
+    if (buffer) {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      buffer->in_use = false;
+      r.free_list.push_back(buffer);
+    }
+  }
+
+  ThreadBuffer* get() {
+    if (!buffer) {
+      buffer = acquire_buffer();
+    }
+    return buffer;
+  }
+};
+
+thread_local LocalBuffer local_buffer;
+
+void append_json_string(std::string& out, const char* s) {
+  out += '"';
+  for (; *s; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+void append_us(std::string& out, uint64_t ns) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%llu.%03llu",
+                static_cast<unsigned long long>(ns / 1000),
+                static_cast<unsigned long long>(ns % 1000));
+  out += text;
+}
+
+} // namespace
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void detail::trace_record(const char* name, const char* category, uint64_t start_ns,
+                          uint64_t end_ns) {
+  ThreadBuffer* buffer = local_buffer.get();
+  const size_t n = buffer->size.load(std::memory_order_relaxed);
+  if (n == buffer->capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[n] = {name, category, start_ns, end_ns};
+  buffer->size.store(n + 1, std::memory_order_release);
+}
+
+void trace_enable(size_t events_per_thread) {
+  if (events_per_thread == 0) {
+    throw std::invalid_argument("Trace buffer capacity must be positive");
+  }
+  {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.events_per_thread = events_per_thread;
+  }
+  detail::trace_enabled_flag.store(true, std::memory_order_relaxed);
+}
+
+void trace_disable() {
+  detail::trace_enabled_flag.store(false, std::memory_order_relaxed);
+}
+
+void trace_clear() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& buffer : r.buffers) {
+    buffer->size.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+  }
+}
+
+void trace_set_thread_name(const std::string& name) {
+  ThreadBuffer* buffer = local_buffer.get();
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  buffer->name = name;
+}
+
+size_t trace_event_count() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  size_t total = 0;
+  for (const auto& buffer : r.buffers) {
+    total += buffer->size.load(std::memory_order_acquire);
+  }
+  return total;
+}
+
+uint64_t trace_dropped_events() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  uint64_t total = 0;
+  for (const auto& buffer : r.buffers) {
+    total += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// ============================================================================
+// Chrome Trace Export
+// ============================================================================
+
+std::string trace_chrome_json() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&] {
+    if (!first) {
+      out += ',';
+    }
+    first = false;
+    out += "\n";
+  };
+
+  for (const auto& buffer : r.buffers) {
+    const std::string tid = std::to_string(buffer->track);
+    separator();
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+    append_json_string(out, buffer->name.c_str());
+    out += "}}";
+
+    const size_t n = buffer->size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+      const TraceEvent& e = buffer->events[i];
+      const uint64_t start = e.start_ns > r.epoch_ns ? e.start_ns - r.epoch_ns : 0;
+      separator();
+      out += "{\"name\":";
+      append_json_string(out, e.name);
+      out += ",\"cat\":";
+      append_json_string(out, e.category);
+      out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+      append_us(out, start);
+      out += ",\"dur\":";
+      append_us(out, e.end_ns - e.start_ns);
+      out += '}';
+    }
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+void trace_write_chrome_json(const std::string& path) {
+  const std::string json = trace_chrome_json();
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Failed to create file: " + path);
+  }
+  file.write(json.data(), static_cast<std::streamsize>(json.size()));
+  if (!file) {
+    throw std::runtime_error("Failed to write file: " + path);
+  }
+}
+
+} // namespace databento
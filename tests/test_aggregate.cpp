@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <databento/aggregate.hpp>
+#include <databento/generator.hpp>
+#include "test_helpers.hpp"
+#include <map>
+
+using databento::AggregateOptions;
+using databento::InstrumentStats;
+using databento::MboMsg;
+using databento::int128_t;
+
+namespace {
+
+std::vector<MboMsg> sample_records() {
+  databento::GeneratorOptions options;
+  options.num_records = 200'000;
+  options.chunk_records = 32'768;
+  options.num_instruments = 12;
+  options.threads = 1;
+  return databento::generate_mbo_records(options);
+}
+
+} // namespace
+
+TEST(AggregateTest, MatchesNaiveLoop) {
+  const auto records = sample_records();
+  std::map<uint32_t, InstrumentStats> expected;
+  for (const auto& m : records) {
+    auto& s = expected[m.instrument_id];
+    s.instrument_id = m.instrument_id;
+    ++s.records;
+    ++s.action_counts[static_cast<size_t>(databento::action_slot(m.action))];
+    if (m.action == 'T') {
+      s.volume += m.size;
+      s.notional += static_cast<int128_t>(m.price) * m.size;
+      s.min_price = std::min(s.min_price, m.price);
+      s.max_price = std::max(s.max_price, m.price);
+    }
+  }
+
+  const auto result = databento::aggregate_by_instrument(records, {"T", 1});
+  ASSERT_EQ(result.size(), expected.size());
+  for (const auto& stats : result) {
+    EXPECT_EQ(stats, expected.at(stats.instrument_id)) << stats.instrument_id;
+    EXPECT_EQ(stats.count(databento::Action::Trade), stats.count(databento::Action::Fill));
+  }
+}
+
+TEST(AggregateTest, IdenticalForAnyThreadCount) {
+  const auto records = sample_records();
+  const auto serial = databento::aggregate_by_instrument(records, {"TF", 1});
+  for (unsigned threads : {2u, 3u, 7u, 16u}) {
+    EXPECT_EQ(databento::aggregate_by_instrument(records, {"TF", threads}), serial) << threads;
+  }
+}
+
+TEST(AggregateTest, NotionalIsExactBeyondInt64) {
+  // 4000 trades of 1e6 lots at 5000.000000001 overflow int64 notional
+  std::vector<MboMsg> records(4000, test_helpers::make_mbo(0));
+  for (auto& m : records) {
+    m.instrument_id = 7;
+    m.action = 'T';
+    m.price = 5'000'000'000'001LL;
+    m.size = 1'000'000;
+  }
+  records[0].price = 5'000'000'000'003LL;
+
+  const auto result = databento::aggregate_by_instrument(records, {"T", 4});
+  ASSERT_EQ(result.size(), 1u);
+  const auto& s = result[0];
+  const int128_t expected = static_cast<int128_t>(5'000'000'000'001LL) * 4'000'000'000LL +
+                            static_cast<int128_t>(2) * 1'000'000;
+  EXPECT_EQ(s.notional, expected);
+  EXPECT_GT(s.notional, static_cast<int128_t>(INT64_MAX));
+  EXPECT_EQ(databento::int128_to_string(s.notional), "20000000000004002000000");
+  EXPECT_EQ(s.vwap_fixed(), 5'000'000'000'001LL);  // +0.0005 ticks rounds away
+  EXPECT_EQ(s.min_price, 5'000'000'000'001LL);
+  EXPECT_EQ(s.max_price, 5'000'000'000'003LL);
+}
+
+TEST(AggregateTest, InstrumentsWithoutVolume) {
+  std::vector<MboMsg> records = {test_helpers::make_mbo(0), test_helpers::make_mbo(1)};
+  records[0].action = 'A';
+  records[1].action = 'C';
+  records[1].instrument_id = records[0].instrument_id;
+  const auto result = databento::aggregate_by_instrument(records);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0].records, 2u);
+  EXPECT_EQ(result[0].count(databento::Action::Add), 1u);
+  EXPECT_EQ(result[0].volume, 0u);
+  EXPECT_EQ(result[0].vwap_fixed(), 0);
+  EXPECT_EQ(databento::int128_to_string(-static_cast<int128_t>(42)), "-42");
+
+  EXPECT_TRUE(databento::aggregate_by_instrument(std::vector<MboMsg>{}).empty());
+}
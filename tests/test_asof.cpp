@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <databento/asof.hpp>
+#include <databento/generator.hpp>
+#include "test_helpers.hpp"
+#include <random>
+
+using databento::AsOfOptions;
+using databento::MboMsg;
+using databento::query::RecordRange;
+
+namespace {
+
+MboMsg make_msg(uint64_t ts, uint32_t instrument_id, int64_t price) {
+  MboMsg msg{};
+  msg.ts_event = ts;
+  msg.instrument_id = instrument_id;
+  msg.action = 'T';
+  msg.price = price;
+  return msg;
+}
+
+// Latest right record per instrument at or before (or strictly before) ts
+const MboMsg* naive_asof(const std::vector<MboMsg>& right, const MboMsg& left,
+                         const AsOfOptions& options) {
+  const MboMsg* best = nullptr;
+  for (const auto& r : right) {
+    const bool prior = options.allow_exact_matches ? r.ts_event <= left.ts_event
+                                                   : r.ts_event < left.ts_event;
+    if (prior && r.instrument_id == left.instrument_id) {
+      best = &r;
+    }
+  }
+  if (best && left.ts_event - best->ts_event > options.tolerance_ns) {
+    return nullptr;
+  }
+  return best;
+}
+
+std::vector<MboMsg> random_stream(uint64_t seed, int count) {
+  std::mt19937_64 rng(seed);
+  std::vector<MboMsg> records;
+  uint64_t ts = 1'000'000;
+  for (int i = 0; i < count; ++i) {
+    ts += rng() % 3 * 500;  // Frequent ties
+    records.push_back(make_msg(ts, 1 + static_cast<uint32_t>(rng() % 4),
+                               static_cast<int64_t>(rng() % 1000)));
+  }
+  return records;
+}
+
+} // namespace
+
+TEST(AsOfJoinTest, MatchesNaiveJoin) {
+  const auto trades = random_stream(1, 2'000);
+  const auto quotes = random_stream(2, 3'000);
+
+  for (const AsOfOptions options : {AsOfOptions{}, AsOfOptions{700, true}, AsOfOptions{UINT64_MAX, false}}) {
+    size_t index = 0;
+    uint64_t matched = 0;
+    const auto stats = databento::asof_join(
+        trades, quotes,
+        [&](const MboMsg& trade, const MboMsg* quote) {
+          const MboMsg* expected = naive_asof(quotes, trades[index], options);
+          ASSERT_EQ(trade.ts_event, trades[index].ts_event);
+          ASSERT_EQ(quote == nullptr, expected == nullptr) << index;
+          if (quote) {
+            EXPECT_EQ(quote->ts_event, expected->ts_event) << index;
+            EXPECT_EQ(quote->price, expected->price) << index;
+            ++matched;
+          }
+          ++index;
+        },
+        options);
+    EXPECT_EQ(index, trades.size());
+    EXPECT_EQ(stats.left_records, trades.size());
+    ASSERT_EQ(stats.matched.size(), 1u);
+    EXPECT_EQ(stats.matched[0], matched);
+    EXPECT_LE(stats.right_records, quotes.size());
+  }
+}
+
+TEST(AsOfJoinTest, SeveralRightStreams) {
+  const std::vector<MboMsg> trades = {make_msg(100, 1, 10), make_msg(200, 2, 20), make_msg(300, 1, 30)};
+  const std::vector<MboMsg> quotes = {make_msg(50, 1, 1), make_msg(250, 1, 2), make_msg(400, 1, 3)};
+  const std::vector<MboMsg> book = {make_msg(150, 2, 7)};
+
+  std::vector<std::pair<int64_t, int64_t>> seen;
+  const auto stats = databento::asof_join(
+      trades, {RecordRange(quotes), RecordRange(book)},
+      [&](const MboMsg&, std::span<const MboMsg* const> matches) {
+        ASSERT_EQ(matches.size(), 2u);
+        seen.emplace_back(matches[0] ? matches[0]->price : -1, matches[1] ? matches[1]->price : -1);
+      });
+  const std::vector<std::pair<int64_t, int64_t>> expected = {{1, -1}, {-1, 7}, {2, -1}};
+  EXPECT_EQ(seen, expected);
+  EXPECT_EQ(stats.matched, (std::vector<uint64_t>{2, 1}));
+  EXPECT_EQ(stats.right_records, 3u);  // The quote at 400 is never read
+}
+
+TEST(AsOfJoinTest, JoinsParserSources) {
+  databento::GeneratorOptions options;
+  options.num_records = 50'000;
+  options.num_instruments = 8;
+  options.threads = 1;
+  const auto records = databento::generate_mbo_records(options);
+  std::vector<MboMsg> trades;
+  std::vector<MboMsg> book;
+  for (const auto& m : records) {
+    (m.action == 'T' ? trades : book).push_back(m);
+  }
+  test_helpers::TempDbnFile trade_file(trades);
+  test_helpers::TempDbnFile book_file(book);
+  databento::DbnParser trade_parser(trade_file.path());
+  databento::DbnParser book_parser(book_file.path());
+
+  // Every generated trade follows some book event for its instrument
+  uint64_t stale = 0;
+  const auto stats = databento::asof_join(trade_parser, book_parser,
+                                          [&](const MboMsg& trade, const MboMsg* prior) {
+                                            ASSERT_NE(prior, nullptr);
+                                            EXPECT_EQ(prior->instrument_id, trade.instrument_id);
+                                            stale += prior->ts_event > trade.ts_event;
+                                          });
+  EXPECT_EQ(stale, 0u);
+  EXPECT_EQ(stats.left_records, trades.size());
+  EXPECT_EQ(stats.matched[0], trades.size());
+}
+
+TEST(AsOfJoinTest, RejectsUnsortedInput) {
+  const std::vector<MboMsg> sorted = {make_msg(100, 1, 0), make_msg(200, 1, 0)};
+  const std::vector<MboMsg> unsorted = {make_msg(200, 1, 0), make_msg(100, 1, 0)};
+  auto ignore = [](const MboMsg&, const MboMsg*) {};
+  EXPECT_THROW(databento::asof_join(unsorted, sorted, ignore), std::invalid_argument);
+  EXPECT_THROW(databento::asof_join(sorted, unsorted, ignore), std::invalid_argument);
+  EXPECT_THROW(databento::asof_join(sorted, std::vector<RecordRange>{},
+                                    [](const MboMsg&, std::span<const MboMsg* const>) {}),
+               std::invalid_argument);
+}
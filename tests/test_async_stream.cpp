@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <databento/async_stream.hpp>
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using databento::AsyncGenerator;
+using databento::MboMsg;
+using databento::StreamScheduler;
+using databento::Task;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<MboMsg> sequence_range(int first, int count) {
+  std::vector<MboMsg> records;
+  for (int i = first; i < first + count; ++i) {
+    records.push_back(test_helpers::make_mbo(i));
+  }
+  return records;
+}
+
+} // namespace
+
+TEST(AsyncStreamTest, InMemoryBatches) {
+  const auto records = test_helpers::make_mbo_records(10'000);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+
+  std::vector<size_t> batch_sizes;
+  std::vector<uint32_t> sequences;
+  auto consume = [&]() -> Task {
+    auto batches = databento::mbo_batches(parser, 4096);
+    while (auto* batch = co_await batches.next()) {
+      batch_sizes.push_back(batch->size());
+      for (const MboMsg& msg : *batch) {
+        sequences.push_back(msg.sequence);
+      }
+    }
+  };
+
+  StreamScheduler scheduler;
+  scheduler.spawn(consume());
+  scheduler.run();
+
+  EXPECT_EQ(batch_sizes, (std::vector<size_t>{4096, 4096, 1808}));
+  ASSERT_EQ(sequences.size(), records.size());
+  for (size_t i = 0; i < sequences.size(); ++i) {
+    ASSERT_EQ(sequences[i], i);
+  }
+}
+
+TEST(AsyncStreamTest, InterleavesGrowingFilesOnOneThread) {
+  test_helpers::TempDbnFile file_a;
+  test_helpers::TempDbnFile file_b;
+  databento::DbnParser parser_a(file_a.path());
+  databento::DbnParser parser_b(file_b.path());
+  StreamScheduler scheduler;
+
+  // Appends alternate between the files; each consumer must see its file's
+  // records while the other stream (and the writer) are still running
+  std::vector<std::string> events;
+  auto writer = [&]() -> Task {
+    for (int round = 0; round < 5; ++round) {
+      test_helpers::append_records(file_a.path(), sequence_range(round * 100, 100));
+      co_await scheduler.sleep(2ms);
+      test_helpers::append_records(file_b.path(), sequence_range(round * 100, 100));
+      co_await scheduler.sleep(2ms);
+    }
+    events.push_back("writer done");
+  };
+
+  // Consumers stop once they have every record the writer appends; the
+  // idle timeout only keeps a broken stream from hanging the test
+  constexpr size_t kTotal = 500;
+  databento::FollowOptions options;
+  options.poll_interval = 500us;
+  options.idle_timeout = 10s;
+  std::vector<uint32_t> seen_a;
+  std::vector<uint32_t> seen_b;
+  auto consume = [&](databento::DbnParser& parser, std::vector<uint32_t>& seen,
+                     std::string name) -> Task {
+    auto batches = databento::follow_mbo_batches(parser, scheduler, options, 64);
+    while (seen.size() < kTotal) {
+      auto* batch = co_await batches.next();
+      if (!batch) {
+        break;
+      }
+      events.push_back(name);
+      for (const MboMsg& msg : *batch) {
+        seen.push_back(msg.sequence);
+      }
+    }
+  };
+
+  scheduler.spawn(writer());
+  scheduler.spawn(consume(parser_a, seen_a, "a"));
+  scheduler.spawn(consume(parser_b, seen_b, "b"));
+  scheduler.run();
+
+  ASSERT_EQ(seen_a.size(), kTotal);
+  ASSERT_EQ(seen_b.size(), kTotal);
+  for (uint32_t i = 0; i < kTotal; ++i) {
+    ASSERT_EQ(seen_a[i], i);
+    ASSERT_EQ(seen_b[i], i);
+  }
+
+  // Both streams made progress before the writer finished
+  const auto writer_done = std::find(events.begin(), events.end(), "writer done");
+  ASSERT_NE(writer_done, events.end());
+  EXPECT_NE(std::find(events.begin(), writer_done, "a"), writer_done);
+  EXPECT_NE(std::find(events.begin(), writer_done, "b"), writer_done);
+}
+
+TEST(AsyncStreamTest, ReadableAndTimeouts) {
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  StreamScheduler scheduler;
+
+  std::vector<std::string> events;
+  auto reader = [&]() -> Task {
+    const bool first = co_await scheduler.readable(fds[0], 1ms);
+    events.push_back(first ? "readable" : "timeout");
+    const bool second = co_await scheduler.readable(fds[0], 5s);
+    events.push_back(second ? "readable" : "timeout");
+  };
+  auto writer = [&]() -> Task {
+    co_await scheduler.sleep(5ms);
+    events.push_back("write");
+    const char byte = 'x';
+    EXPECT_EQ(::write(fds[1], &byte, 1), 1);
+  };
+
+  scheduler.spawn(reader());
+  scheduler.spawn(writer());
+  scheduler.run();
+  EXPECT_EQ(events, (std::vector<std::string>{"timeout", "write", "readable"}));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(AsyncStreamTest, ExceptionsPropagate) {
+  auto failing = []() -> AsyncGenerator<int> {
+    co_yield 1;
+    throw std::runtime_error("source failed");
+  };
+
+  std::vector<int> values;
+  auto consume = [&]() -> Task {
+    auto gen = failing();
+    while (int* value = co_await gen.next()) {
+      values.push_back(*value);
+    }
+  };
+
+  StreamScheduler scheduler;
+  scheduler.spawn(consume());
+  EXPECT_THROW(scheduler.run(), std::runtime_error);
+  EXPECT_EQ(values, std::vector<int>{1});
+
+  databento::DbnParser parser("/tmp/unused.dbn");
+  auto zero_batch = [&]() -> Task {
+    auto batches = databento::mbo_batches(parser, 0);
+    co_await batches.next();
+  };
+  StreamScheduler second;
+  second.spawn(zero_batch());
+  EXPECT_THROW(second.run(), std::invalid_argument);
+}
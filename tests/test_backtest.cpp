@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <databento/backtest.hpp>
+#include <databento/flat_hash_map.hpp>
+#include <databento/order_book.hpp>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <random>
+#include <unordered_map>
+
+using databento::MboMsg;
+
+namespace {
+
+constexpr uint32_t kInstrument = 42;
+constexpr int64_t kPx = 100'000'000'000LL;      // 100.00
+constexpr int64_t kTick = 250'000'000LL;        // 0.25
+
+MboMsg event(uint64_t ts, char action, char side, int64_t price,
+             uint32_t size, uint64_t order_id) {
+  MboMsg msg{};
+  msg.ts_event = ts;
+  msg.instrument_id = kInstrument;
+  msg.action = action;
+  msg.side = side;
+  msg.price = price;
+  msg.size = size;
+  msg.order_id = order_id;
+  return msg;
+}
+
+} // namespace
+
+// ============================================================================
+// FlatHashMap Tests
+// ============================================================================
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderChurn) {
+  databento::FlatHashMap<uint64_t, uint64_t> flat;
+  std::unordered_map<uint64_t, uint64_t> reference;
+  std::mt19937_64 rng(7);
+
+  for (int i = 0; i < 200000; ++i) {
+    const uint64_t key = rng() % 5000;
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(flat.erase(key), reference.erase(key) == 1);
+    } else {
+      flat[key] += i;
+      reference[key] += i;
+    }
+  }
+
+  ASSERT_EQ(flat.size(), reference.size());
+  for (const auto& [key, value] : reference) {
+    const uint64_t* found = flat.find(key);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(*found, value);
+  }
+  size_t visited = 0;
+  flat.for_each([&](uint64_t, uint64_t) { ++visited; });
+  EXPECT_EQ(visited, reference.size());
+}
+
+// ============================================================================
+// OrderBook Tests
+// ============================================================================
+
+TEST(OrderBookTest, AddCancelModifyFillClear) {
+  databento::OrderBook book;
+  book.apply(event(1, 'A', 'B', kPx, 10, 1));
+  book.apply(event(2, 'A', 'B', kPx, 5, 2));
+  book.apply(event(3, 'A', 'A', kPx + kTick, 7, 3));
+
+  EXPECT_EQ(book.order_count(), 3);
+  EXPECT_EQ(book.level(kInstrument, 'B', kPx).size, 15);
+  EXPECT_EQ(book.level(kInstrument, 'B', kPx).order_count, 2);
+
+  book.apply(event(4, 'C', 'B', kPx, 4, 1));     // Partial cancel
+  EXPECT_EQ(book.find(1)->size, 6);
+  EXPECT_EQ(book.level(kInstrument, 'B', kPx).size, 11);
+
+  const uint64_t priority = book.find(2)->priority;
+  book.apply(event(5, 'M', 'B', kPx, 3, 2));     // Size down keeps priority
+  EXPECT_EQ(book.find(2)->priority, priority);
+  book.apply(event(6, 'M', 'B', kPx - kTick, 3, 2));  // Price change re-queues
+  EXPECT_GT(book.find(2)->priority, priority);
+  EXPECT_EQ(book.level(kInstrument, 'B', kPx).size, 6);
+  EXPECT_EQ(book.level(kInstrument, 'B', kPx - kTick).size, 3);
+
+  book.apply(event(7, 'F', 'A', kPx + kTick, 7, 3));  // Fully filled
+  EXPECT_EQ(book.find(3), nullptr);
+  EXPECT_EQ(book.level(kInstrument, 'A', kPx + kTick).order_count, 0);
+
+  book.apply(event(8, 'R', 'N', 0, 0, 0));
+  EXPECT_EQ(book.order_count(), 0);
+  EXPECT_EQ(book.level_count(), 0);
+}
+
+// ============================================================================
+// MatchingSimulator Tests
+// ============================================================================
+
+TEST(MatchingSimulatorTest, QueuePositionDrainsThenFills) {
+  databento::MatchingSimulator sim;
+  sim.on_mbo(event(100, 'A', 'B', kPx, 10, 1));
+  sim.on_mbo(event(110, 'A', 'B', kPx, 20, 2));
+
+  const uint64_t id = sim.submit(kInstrument, databento::Side::Bid, kPx, 5, 110);
+  sim.on_mbo(event(120, 'A', 'B', kPx, 50, 3));   // Joins behind us
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Active);
+  EXPECT_EQ(sim.order(id).queue_ahead, 30);
+
+  sim.on_mbo(event(130, 'C', 'B', kPx, 20, 2));   // Ahead of us
+  sim.on_mbo(event(131, 'C', 'B', kPx, 50, 3));   // Behind us
+  EXPECT_EQ(sim.order(id).queue_ahead, 10);
+
+  // Sell aggressor for 12: drains 10 ahead, fills 2 of ours
+  sim.on_mbo(event(140, 'T', 'A', kPx, 12, 0));
+  sim.on_mbo(event(140, 'F', 'B', kPx, 10, 1));
+  ASSERT_EQ(sim.fills().size(), 1);
+  EXPECT_EQ(sim.fills()[0].size, 2);
+  EXPECT_EQ(sim.fills()[0].remaining, 3);
+  EXPECT_EQ(sim.order(id).queue_ahead, 0);
+
+  sim.on_mbo(event(150, 'T', 'A', kPx, 3, 0));
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Filled);
+  EXPECT_EQ(sim.active_orders(), 0);
+}
+
+TEST(MatchingSimulatorTest, EntryLatencyLetsOthersQueueFirst) {
+  databento::MatchingOptions options;
+  options.entry_latency_ns = 50;
+  databento::MatchingSimulator sim(options);
+
+  const uint64_t id = sim.submit(kInstrument, databento::Side::Ask, kPx, 4, 0);
+  sim.on_mbo(event(10, 'A', 'A', kPx, 8, 1));    // Arrives before activation
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Pending);
+
+  sim.on_mbo(event(60, 'A', 'A', kPx, 8, 2));
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Active);
+  EXPECT_EQ(sim.order(id).active_ts, 50);
+  EXPECT_EQ(sim.order(id).queue_ahead, 8);
+}
+
+TEST(MatchingSimulatorTest, TradeThroughFillsAtLimit) {
+  databento::MatchingSimulator sim;
+  sim.on_mbo(event(1, 'A', 'B', kPx, 100, 1));
+  const uint64_t id = sim.submit(kInstrument, databento::Side::Bid, kPx, 7, 1);
+  sim.advance_to(1);
+
+  sim.on_mbo(event(5, 'T', 'A', kPx - kTick, 1, 0));
+  ASSERT_EQ(sim.fills().size(), 1);
+  EXPECT_EQ(sim.fills()[0].price, kPx);
+  EXPECT_EQ(sim.fills()[0].size, 7);
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Filled);
+}
+
+TEST(MatchingSimulatorTest, CancelLatencyAndCallback) {
+  databento::MatchingOptions options;
+  options.cancel_latency_ns = 100;
+  databento::MatchingSimulator sim(options);
+
+  std::vector<databento::SimFill> seen;
+  sim.set_fill_callback([&](const databento::SimFill& f) { seen.push_back(f); });
+
+  const uint64_t id = sim.submit(kInstrument, databento::Side::Bid, kPx, 5, 0);
+  sim.advance_to(0);
+  sim.cancel(id, 10);
+
+  // Trade lands before the cancel takes effect
+  sim.on_mbo(event(50, 'T', 'A', kPx, 2, 0));
+  sim.on_mbo(event(200, 'T', 'A', kPx, 2, 0));
+
+  ASSERT_EQ(seen.size(), 1);
+  EXPECT_EQ(seen[0].size, 2);
+  EXPECT_EQ(sim.order(id).status, databento::SimOrderStatus::Cancelled);
+  EXPECT_EQ(sim.order(id).remaining, 3);
+}
+
+TEST(MatchingSimulatorTest, ClearResetsQueueOnlyForItsInstrument) {
+  databento::MatchingSimulator sim;
+  MboMsg other = event(100, 'A', 'A', kPx, 7, 9);
+  other.instrument_id = kInstrument + 1;
+  sim.on_mbo(other);
+  sim.on_mbo(event(100, 'A', 'B', kPx, 10, 1));
+
+  const uint64_t ours = sim.submit(kInstrument, databento::Side::Bid, kPx, 5, 100);
+  const uint64_t theirs = sim.submit(kInstrument + 1, databento::Side::Ask, kPx, 5, 100);
+  sim.on_mbo(event(110, 'A', 'B', kPx - kTick, 1, 2));   // Activates both
+  EXPECT_EQ(sim.order(ours).queue_ahead, 10);
+  EXPECT_EQ(sim.order(theirs).queue_ahead, 7);
+
+  sim.on_mbo(event(120, 'R', 'N', 0, 0, 0));
+  EXPECT_EQ(sim.order(ours).queue_ahead, 0);
+  EXPECT_EQ(sim.order(theirs).queue_ahead, 7);
+}
+
+TEST(MatchingSimulatorTest, ConsumesParserStream) {
+  std::vector<MboMsg> records;
+  records.push_back(event(0, 'A', 'A', kPx, 10, 1));
+  records.push_back(event(2, 'T', 'B', kPx, 15, 0));
+  records.push_back(event(2, 'F', 'A', kPx, 10, 1));
+  test_helpers::TempDbnFile file(records);
+
+  databento::MatchingSimulator sim;
+  sim.submit(kInstrument, databento::Side::Ask, kPx, 10, 1);
+
+  databento::DbnParser parser(file.path());
+  parser.parse_mbo([&](const MboMsg& msg) { sim.on_mbo(msg); });
+
+  ASSERT_EQ(sim.fills().size(), 1);
+  EXPECT_EQ(sim.fills()[0].size, 5);
+  EXPECT_EQ(sim.book().order_count(), 0);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <databento/buffer_pool.hpp>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <cstring>
+
+using databento::BufferPool;
+using databento::BufferPoolOptions;
+using databento::HugePages;
+using databento::PooledBuffer;
+
+TEST(PooledBufferTest, GrowsKeepingContents) {
+  PooledBuffer buffer;
+  EXPECT_EQ(buffer.data(), nullptr);
+  buffer.resize(1000);
+  std::memset(buffer.data(), 0xAB, buffer.size());
+  const size_t first_capacity = buffer.capacity();
+  EXPECT_GE(first_capacity, 1000u);
+
+  buffer.resize(first_capacity * 3 + 1);  // Past geometric growth
+  EXPECT_GE(buffer.capacity(), first_capacity * 3 + 1);
+  for (size_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(buffer.data()[i], 0xAB);
+  }
+  buffer.data()[buffer.size() - 1] = 1;
+
+  PooledBuffer moved = std::move(buffer);
+  EXPECT_EQ(buffer.data(), nullptr);
+  EXPECT_EQ(moved.data()[0], 0xAB);
+}
+
+TEST(BufferPoolTest, ReusesReturnedBuffers) {
+  BufferPool pool;
+  const uint8_t* first_data = nullptr;
+  {
+    PooledBuffer a = pool.acquire(1 << 20);
+    first_data = a.data();
+    std::memset(a.data(), 1, a.size());
+  }
+  EXPECT_EQ(pool.stats().cached_bytes, size_t{1} << 20);
+
+  {
+    PooledBuffer b = pool.acquire(1 << 19);  // Smaller: same mapping
+    EXPECT_EQ(b.data(), first_data);
+    EXPECT_EQ(b.size(), size_t{1} << 19);
+    EXPECT_EQ(pool.stats().cached_bytes, 0u);
+  }
+  {
+    PooledBuffer c = pool.acquire(3 << 20);  // Larger: the cached one grows
+    std::memset(c.data(), 2, c.size());
+  }
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.acquires, 3u);
+  EXPECT_EQ(stats.reuses, 2u);
+  EXPECT_EQ(stats.new_mappings, 1u);
+  EXPECT_GE(stats.cached_bytes, size_t{3} << 20);
+
+  pool.trim();
+  EXPECT_EQ(pool.stats().cached_bytes, 0u);
+}
+
+TEST(BufferPoolTest, CapAndHugePageFallback) {
+  BufferPoolOptions options;
+  options.max_cached_bytes = 1 << 20;
+  options.huge_pages = HugePages::Explicit2MB;  // Falls back when none are reserved
+  BufferPool pool(options);
+  {
+    PooledBuffer big = pool.acquire(4 << 20);
+    std::memset(big.data(), 3, big.size());
+    EXPECT_EQ(big.capacity() % (2 << 20), 0u);
+  }
+  EXPECT_EQ(pool.stats().cached_bytes, 0u);  // Over the cap: unmapped
+}
+
+TEST(BufferPoolTest, ParsersBorrowAndRetarget) {
+  const auto first = test_helpers::make_mbo_records(5'000);
+  auto second = test_helpers::make_mbo_records(3'000);
+  for (auto& m : second) {
+    m.sequence += 1'000'000;
+  }
+  test_helpers::TempDbnFile file_a(first);
+  test_helpers::TempDbnFile file_b(second);
+
+  BufferPool pool;
+  {
+    databento::DbnParser parser(file_a.path());
+    parser.set_buffer_pool(&pool);
+    parser.load_into_memory();
+    ASSERT_EQ(parser.num_records(), first.size());
+    const uint8_t* buffer = parser.data();
+
+    // Re-targeting keeps the mapping
+    parser.reset(file_b.path());
+    EXPECT_EQ(parser.data(), nullptr);
+    std::vector<uint32_t> sequences;
+    parser.parse_mbo([&](const databento::MboMsg& m) { sequences.push_back(m.sequence); });
+    ASSERT_EQ(sequences.size(), second.size());
+    EXPECT_EQ(sequences.front(), 1'000'000u);
+    EXPECT_EQ(parser.data(), buffer);
+  }
+  EXPECT_EQ(pool.stats().new_mappings, 1u);
+  EXPECT_GT(pool.stats().cached_bytes, 0u);
+
+  // A second parser picks up the returned buffer
+  databento::DbnParser again(file_a.path());
+  again.set_buffer_pool(&pool);
+  again.load_into_memory();
+  EXPECT_EQ(pool.stats().reuses, 1u);
+  EXPECT_EQ(std::memcmp(again.get_record(0), first.data(), sizeof(databento::MboMsg)), 0);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <databento/checkpoint.hpp>
+#include "test_helpers.hpp"
+#include <cstdio>
+#include <map>
+#include <string>
+
+using databento::MboMsg;
+
+namespace {
+
+// 100 records: adds across two instruments, with every third order later
+// cancelled and every fifth partially filled
+std::vector<MboMsg> book_records() {
+  std::vector<MboMsg> records;
+  for (int i = 0; i < 100; ++i) {
+    MboMsg msg = test_helpers::make_mbo(i);
+    msg.ts_event = 1'000'000ULL * (i + 1);
+    msg.instrument_id = 7 + (i % 2);
+    if (i >= 10 && i % 3 == 0) {
+      msg = test_helpers::make_mbo(i - 10);
+      msg.instrument_id = 7 + ((i - 10) % 2);
+      msg.action = 'C';
+    } else if (i >= 10 && i % 5 == 0) {
+      msg = test_helpers::make_mbo(i - 9);
+      msg.instrument_id = 7 + ((i - 9) % 2);
+      msg.action = 'F';
+      msg.size = 10;
+    }
+    msg.ts_event = 1'000'000ULL * (i + 1);
+    records.push_back(msg);
+  }
+  return records;
+}
+
+std::map<uint64_t, std::tuple<uint32_t, char, int64_t, uint32_t, uint64_t>>
+book_contents(const databento::OrderBook& book) {
+  std::map<uint64_t, std::tuple<uint32_t, char, int64_t, uint32_t, uint64_t>> out;
+  book.for_each_order([&](const databento::RestingOrder& o) {
+    out[o.order_id] = {o.instrument_id, o.side, o.price, o.size, o.priority};
+  });
+  return out;
+}
+
+class CheckpointTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ckpt_path_ = databento::default_checkpoint_path(file_.path());
+  }
+  void TearDown() override {
+    std::remove(ckpt_path_.c_str());
+  }
+
+  test_helpers::TempDbnFile file_{book_records()};
+  std::string ckpt_path_;
+};
+
+} // namespace
+
+TEST_F(CheckpointTest, WritesPeriodicAndFinalCheckpoints) {
+  databento::DbnParser parser(file_.path());
+  databento::OrderBook book;
+  databento::CheckpointRegistry registry;
+
+  databento::CheckpointOptions options;
+  options.interval_records = 30;
+  const size_t written = databento::build_checkpoints(
+      parser, ckpt_path_, book, registry, nullptr, options);
+
+  EXPECT_EQ(written, 4);  // 30, 60, 90, final 100
+  databento::CheckpointFile ckpt(ckpt_path_);
+  ASSERT_EQ(ckpt.checkpoints().size(), 4);
+  EXPECT_EQ(ckpt.checkpoints()[0].record_index, 30);
+  EXPECT_EQ(ckpt.checkpoints()[0].ts_event, 30'000'000ULL);
+  EXPECT_EQ(ckpt.checkpoints()[3].record_index, 100);
+  EXPECT_EQ(ckpt.checkpoints()[3].order_count, book.order_count());
+
+  EXPECT_EQ(ckpt.find_before_ts(29'999'999ULL), nullptr);
+  EXPECT_EQ(ckpt.find_before_ts(65'000'000ULL)->record_index, 60);
+  EXPECT_EQ(ckpt.find_before_record(99)->record_index, 90);
+}
+
+TEST_F(CheckpointTest, ResumeMatchesFullScan) {
+  // Reference: full scan up to and including record 74
+  databento::OrderBook reference;
+  uint64_t reference_count = 0;
+  {
+    databento::DbnParser parser(file_.path());
+    parser.parse_mbo([&](const MboMsg& msg) {
+      if (msg.ts_event <= 75'000'000ULL) {
+        reference.apply(msg);
+        ++reference_count;
+      }
+    });
+  }
+
+  uint64_t user_count = 0;
+  databento::CheckpointRegistry registry;
+  registry.register_state(
+      "user_count",
+      [&] { return std::to_string(user_count); },
+      [&](std::string_view blob) { user_count = std::stoull(std::string(blob)); });
+
+  {
+    databento::DbnParser parser(file_.path());
+    databento::OrderBook book;
+    databento::CheckpointOptions options;
+    options.interval_records = 25;
+    databento::build_checkpoints(parser, ckpt_path_, book, registry,
+                                 [&](const MboMsg&) { ++user_count; }, options);
+  }
+
+  user_count = 12345;  // Must be overwritten by the restore
+  databento::DbnParser parser(file_.path());
+  databento::OrderBook book;
+  const size_t start = databento::restore_checkpoint(
+      parser, ckpt_path_, 75'000'000ULL, book, registry);
+  EXPECT_EQ(start, 75);
+  EXPECT_EQ(parser.data(), nullptr);   // Restored without loading the file
+  EXPECT_EQ(user_count, 75);
+  EXPECT_EQ(book_contents(book), book_contents(reference));
+  EXPECT_EQ(user_count, reference_count);
+
+  // Continue to the end and compare against a full scan
+  databento::OrderBook full;
+  databento::DbnParser full_parser(file_.path());
+  full_parser.parse_mbo([&](const MboMsg& msg) { full.apply(msg); });
+
+  size_t replayed = 0;
+  databento::resume_mbo(parser, ckpt_path_, 75'000'000ULL, book, registry,
+                        [&](const MboMsg&) { ++replayed; });
+  EXPECT_EQ(replayed, 25);
+  EXPECT_EQ(book_contents(book), book_contents(full));
+}
+
+TEST_F(CheckpointTest, NoApplicableCheckpointResetsBook) {
+  {
+    databento::DbnParser parser(file_.path());
+    databento::OrderBook book;
+    databento::CheckpointOptions options;
+    options.interval_records = 25;
+    databento::build_checkpoints(parser, ckpt_path_, book, {}, nullptr, options);
+  }
+
+  // A book left over from an earlier run
+  databento::OrderBook book;
+  databento::DbnParser parser(file_.path());
+  parser.parse_mbo([&](const MboMsg& msg) { book.apply(msg); });
+  ASSERT_GT(book.next_priority(), 0);
+
+  EXPECT_EQ(databento::restore_checkpoint(parser, ckpt_path_, 0, book, {}), 0);
+  EXPECT_TRUE(book_contents(book).empty());
+  EXPECT_EQ(book.next_priority(), 0);
+
+  // Replaying from the start reproduces a fresh scan, priorities included
+  databento::OrderBook full;
+  parser.parse_mbo([&](const MboMsg& msg) { full.apply(msg); });
+  parser.parse_mbo_from(0, [&](const MboMsg& msg) { book.apply(msg); });
+  EXPECT_EQ(book_contents(book), book_contents(full));
+}
+
+TEST_F(CheckpointTest, RejectsMismatchedDataFile) {
+  {
+    databento::DbnParser parser(file_.path());
+    databento::OrderBook book;
+    databento::build_checkpoints(parser, ckpt_path_, book, {}, nullptr);
+  }
+
+  test_helpers::TempDbnFile shorter(test_helpers::make_mbo_records(5));
+  databento::DbnParser parser(shorter.path());
+  databento::OrderBook book;
+  EXPECT_THROW(databento::restore_checkpoint(parser, ckpt_path_, 0, book, {}),
+               std::runtime_error);
+}
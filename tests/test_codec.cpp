@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <databento/codec.hpp>
+#include "test_helpers.hpp"
+#include <cstring>
+#include <random>
+
+using databento::MboMsg;
+
+namespace {
+
+bool same_bytes(const std::vector<MboMsg>& a, const std::vector<MboMsg>& b) {
+  return a.size() == b.size() &&
+         std::memcmp(a.data(), b.data(), a.size() * sizeof(MboMsg)) == 0;
+}
+
+// Every byte random, so all field widths up to 64 bits occur
+std::vector<MboMsg> random_records(size_t n, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<MboMsg> records(n);
+  auto* bytes = reinterpret_cast<uint8_t*>(records.data());
+  for (size_t i = 0; i < n * sizeof(MboMsg); ++i) {
+    bytes[i] = static_cast<uint8_t>(rng());
+  }
+  return records;
+}
+
+} // namespace
+
+class CodecSizeTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(CodecSizeTest, RoundTripsRegularRecords) {
+  const auto records = test_helpers::make_mbo_records(static_cast<int>(GetParam()));
+  const auto packed = databento::compress_mbo(records.data(), records.size());
+  EXPECT_EQ(databento::compressed_mbo_count(packed.data(), packed.size()), records.size());
+  EXPECT_TRUE(same_bytes(databento::decompress_mbo(packed.data(), packed.size()), records));
+}
+
+TEST_P(CodecSizeTest, RoundTripsRandomBytes) {
+  const auto records = random_records(GetParam(), GetParam());
+  const auto packed = databento::compress_mbo(records.data(), records.size());
+  EXPECT_TRUE(same_bytes(databento::decompress_mbo(packed.data(), packed.size()), records));
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, CodecSizeTest,
+                         ::testing::Values(0, 1, 7, 255, 256, 257, 5000));
+
+TEST(CodecTest, ExtremeAndNonMonotoneValues) {
+  std::vector<MboMsg> records = test_helpers::make_mbo_records(600);
+  for (size_t i = 0; i < records.size(); ++i) {
+    // Alternate between the ends of the range so deltas wrap
+    records[i].price = (i % 2) ? INT64_MIN : INT64_MAX;
+    records[i].ts_event = (i % 3 == 0) ? UINT64_MAX : i;
+    records[i].order_id = UINT64_MAX - i * 1000;
+    records[i].reserved[1] = static_cast<uint8_t>(i);
+  }
+  const auto packed = databento::compress_mbo(records.data(), records.size());
+  EXPECT_TRUE(same_bytes(databento::decompress_mbo(packed.data(), packed.size()), records));
+}
+
+TEST(CodecTest, CompressesCorrelatedFields) {
+  const auto records = test_helpers::make_mbo_records(100000);
+  const auto packed = databento::compress_mbo(records.data(), records.size());
+  // Every field is constant, a small range or a constant stride
+  EXPECT_LT(packed.size() * 10, records.size() * sizeof(MboMsg));
+}
+
+TEST(CodecTest, RejectsMalformedInput) {
+  const auto records = test_helpers::make_mbo_records(1000);
+  auto packed = databento::compress_mbo(records.data(), records.size());
+  std::vector<MboMsg> out(records.size());
+
+  EXPECT_THROW(databento::decompress_mbo(packed.data(), 10, out.data()), std::runtime_error);
+  EXPECT_THROW(databento::decompress_mbo(packed.data(), packed.size() / 2, out.data()),
+               std::runtime_error);
+
+  auto bad_magic = packed;
+  bad_magic[0] = 'X';
+  EXPECT_THROW(databento::decompress_mbo(bad_magic.data(), bad_magic.size(), out.data()),
+               std::runtime_error);
+
+  auto bad_width = packed;
+  bad_width[25] = 0x7F;  // First field's width byte: 127
+  EXPECT_THROW(databento::decompress_mbo(bad_width.data(), bad_width.size(), out.data()),
+               std::runtime_error);
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <databento/columnar.hpp>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <cstdio>
+#include <random>
+
+using databento::Column;
+using databento::ColumnarCache;
+using databento::MboMsg;
+using databento::column_bit;
+
+namespace {
+
+// Time-ordered records with varied instruments, sides, prices and a few
+// very large values so every encoding and width is exercised
+std::vector<MboMsg> varied_records(size_t n) {
+  std::mt19937_64 rng(42);
+  std::vector<MboMsg> records(n);
+  uint64_t ts = 1'700'000'000'000'000'000ULL;
+  for (size_t i = 0; i < n; ++i) {
+    MboMsg& msg = records[i];
+    msg = test_helpers::make_mbo(static_cast<int>(i));
+    ts += rng() % 5000;
+    msg.ts_event = ts;
+    msg.instrument_id = static_cast<uint32_t>(100 + (i / 1000) % 8 * 10 + rng() % 3);
+    msg.action = "ACMTF"[rng() % 5];
+    msg.side = (rng() & 1) ? 'B' : 'A';
+    msg.price = 4'000'000'000'000LL + static_cast<int64_t>(rng() % 2000) * 250'000'000LL -
+                static_cast<int64_t>(i % 7 == 0) * 8'000'000'000'000LL;
+    msg.size = static_cast<uint32_t>(rng() % (i % 100 == 0 ? 1'000'000 : 500));
+    msg.flags = static_cast<uint8_t>(rng() % 2 ? databento::F_LAST : 0);
+    msg.depth = static_cast<uint8_t>(rng() % 10);
+    msg.channel_id = static_cast<uint32_t>(i % 3);
+    msg.order_id = rng();
+    msg.sequence = static_cast<uint32_t>(i * 3);
+    msg.ts_in_delta = static_cast<uint8_t>(rng());
+  }
+  return records;
+}
+
+} // namespace
+
+TEST(ColumnarTest, RoundTripsAllColumns) {
+  const auto records = varied_records(10000);
+  test_helpers::TempDbnFile file(records);
+  const std::string cache_path = file.path() + ".col";
+
+  databento::ColumnarOptions options;
+  options.block_rows = 4096;
+  ColumnarCache::build(file.path(), cache_path, options);
+  ColumnarCache cache(cache_path);
+  EXPECT_EQ(cache.num_rows(), records.size());
+  EXPECT_EQ(cache.num_blocks(), 3u);
+  EXPECT_LT(cache.file_size(), records.size() * sizeof(MboMsg));
+
+  size_t next = 0;
+  const auto stats = cache.scan({}, databento::ALL_COLUMNS, [&](const databento::ColumnBatch& b) {
+    ASSERT_EQ(b.first_row, next);
+    EXPECT_EQ(b.row_index, nullptr);  // Nothing filtered out
+    for (size_t i = 0; i < b.rows; ++i) {
+      const MboMsg& r = records[next + i];
+      ASSERT_EQ(b.ts_event[i], r.ts_event);
+      ASSERT_EQ(b.instrument_id[i], r.instrument_id);
+      ASSERT_EQ(b.action[i], r.action);
+      ASSERT_EQ(b.side[i], r.side);
+      ASSERT_EQ(b.flags[i], r.flags);
+      ASSERT_EQ(b.depth[i], r.depth);
+      ASSERT_EQ(b.price[i], r.price);
+      ASSERT_EQ(b.size[i], r.size);
+      ASSERT_EQ(b.channel_id[i], r.channel_id);
+      ASSERT_EQ(b.order_id[i], r.order_id);
+      ASSERT_EQ(b.sequence[i], r.sequence);
+      ASSERT_EQ(b.ts_in_delta[i], r.ts_in_delta);
+    }
+    next += b.rows;
+  });
+  EXPECT_EQ(next, records.size());
+  EXPECT_EQ(stats.rows_matched, records.size());
+  EXPECT_EQ(stats.blocks_skipped, 0u);
+  std::remove(cache_path.c_str());
+}
+
+TEST(ColumnarTest, PredicatesAndProjectionMatchBruteForce) {
+  const auto records = varied_records(20000);
+  test_helpers::TempDbnFile file(records);
+  const std::string cache_path = file.path() + ".col";
+
+  databento::ColumnarOptions options;
+  options.block_rows = 1000;
+  ColumnarCache::build(file.path(), cache_path, options);
+  ColumnarCache cache(cache_path);
+
+  databento::ScanPredicate pred;
+  pred.ts_min = records[3000].ts_event;
+  pred.ts_max = records[15000].ts_event;
+  pred.instrument_ids = {120, 121, 150};
+  pred.price_min = 4'100'000'000'000LL;
+  pred.side = 'B';
+
+  std::vector<std::pair<uint64_t, int64_t>> expected;
+  std::vector<uint64_t> expected_rows;
+  for (size_t row = 0; row < records.size(); ++row) {
+    const MboMsg& r = records[row];
+    const bool inst = r.instrument_id == 120 || r.instrument_id == 121 || r.instrument_id == 150;
+    if (r.ts_event >= pred.ts_min && r.ts_event <= pred.ts_max && inst &&
+        r.price >= pred.price_min && r.side == 'B') {
+      expected.emplace_back(r.order_id, r.price);
+      expected_rows.push_back(row);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  std::vector<std::pair<uint64_t, int64_t>> actual;
+  std::vector<uint64_t> actual_rows;
+  const auto stats = cache.scan(
+      pred, column_bit(Column::OrderId) | column_bit(Column::Price),
+      [&](const databento::ColumnBatch& b) {
+        EXPECT_EQ(b.ts_event, nullptr);  // Predicate-only column not projected
+        for (size_t i = 0; i < b.rows; ++i) {
+          actual.emplace_back(b.order_id[i], b.price[i]);
+          actual_rows.push_back(b.first_row + (b.row_index ? b.row_index[i] : i));
+        }
+      });
+  EXPECT_EQ(actual, expected);
+  EXPECT_EQ(actual_rows, expected_rows);
+  EXPECT_EQ(stats.rows_matched, expected.size());
+  EXPECT_GT(stats.blocks_skipped, 0u);
+  std::remove(cache_path.c_str());
+}
+
+TEST(ColumnarTest, ZoneMapsSkipBlocks) {
+  const auto records = varied_records(8000);
+  test_helpers::TempDbnFile file(records);
+  const std::string cache_path = file.path() + ".col";
+
+  databento::ColumnarOptions options;
+  options.block_rows = 1000;
+  ColumnarCache::build(file.path(), cache_path, options);
+  ColumnarCache cache(cache_path);
+
+  const auto zone = cache.zone_map(2);
+  EXPECT_EQ(zone.ts_min, records[2000].ts_event);
+  EXPECT_EQ(zone.ts_max, records[2999].ts_event);
+
+  // A time range inside block 2 touches only that block
+  databento::ScanPredicate pred;
+  pred.ts_min = records[2100].ts_event;
+  pred.ts_max = records[2200].ts_event;
+  size_t rows = 0;
+  const auto stats = cache.scan(pred, column_bit(Column::TsEvent),
+                                [&](const databento::ColumnBatch& b) { rows += b.rows; });
+  EXPECT_EQ(stats.blocks_total, 8u);
+  EXPECT_EQ(stats.blocks_skipped, 7u);
+  EXPECT_EQ(stats.rows_scanned, 1000u);
+  EXPECT_GE(rows, 101u);
+
+  // Instruments absent from every block dictionary skip everything
+  databento::ScanPredicate missing;
+  missing.instrument_ids = {999};
+  const auto none = cache.scan(missing, column_bit(Column::Price),
+                               [](const databento::ColumnBatch&) { FAIL(); });
+  EXPECT_EQ(none.blocks_skipped, 8u);
+  std::remove(cache_path.c_str());
+}
+
+TEST(ColumnarTest, OpenOrBuildRebuildsStaleCache) {
+  test_helpers::TempDbnFile file(test_helpers::make_mbo_records(100));
+  const std::string cache_path = file.path() + ".col";
+  std::remove(cache_path.c_str());
+
+  {
+    auto cache = ColumnarCache::open_or_build(file.path());
+    EXPECT_EQ(cache.num_rows(), 100u);
+    EXPECT_TRUE(cache.is_current_for(file.path()));
+  }
+
+  test_helpers::append_records(file.path(), test_helpers::make_mbo_records(50));
+  {
+    ColumnarCache stale(cache_path);
+    EXPECT_FALSE(stale.is_current_for(file.path()));
+  }
+
+  auto cache = ColumnarCache::open_or_build(file.path());
+  EXPECT_EQ(cache.num_rows(), 150u);
+  EXPECT_TRUE(cache.is_current_for(file.path()));
+  std::remove(cache_path.c_str());
+}
+
+TEST(ColumnarTest, RejectsInvalidCacheFile) {
+  test_helpers::TempDbnFile not_a_cache;
+  EXPECT_THROW(ColumnarCache cache(not_a_cache.path()), std::runtime_error);
+  EXPECT_THROW(ColumnarCache cache("/tmp/does_not_exist.col"), std::runtime_error);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <databento/export.hpp>
+#include "test_helpers.hpp"
+#include <cinttypes>
+#include <climits>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using databento::ExportOptions;
+using databento::MboMsg;
+using databento::TextFormat;
+using databento::query::RecordRange;
+
+namespace {
+
+std::string encode(const std::vector<MboMsg>& records, const ExportOptions& options) {
+  std::string out(records.size() * databento::MAX_TEXT_RECORD_BYTES, '\0');
+  out.resize(databento::encode_mbo_text(RecordRange(records), options, out.data()));
+  return out;
+}
+
+std::string read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+// Slow reference formatting with gmtime/snprintf
+std::string reference_csv(const MboMsg& m) {
+  const time_t seconds = static_cast<time_t>(m.ts_event / 1'000'000'000);
+  std::tm tm{};
+  gmtime_r(&seconds, &tm);
+  char ts[64];
+  std::snprintf(ts, sizeof(ts), "%04d-%02d-%02dT%02d:%02d:%02d.%09" PRIu64 "Z", tm.tm_year + 1900,
+                tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                m.ts_event % 1'000'000'000);
+  const uint64_t magnitude = m.price < 0 ? 0 - static_cast<uint64_t>(m.price) : m.price;
+  char line[256];
+  std::snprintf(line, sizeof(line),
+                "%s,%u,%c,%c,%u,%u,%s%" PRIu64 ".%09" PRIu64 ",%u,%u,%" PRIu64 ",%u,%u\n", ts,
+                m.instrument_id, m.action, m.side, m.flags, m.depth, m.price < 0 ? "-" : "",
+                magnitude / 1'000'000'000, magnitude % 1'000'000'000, m.size, m.channel_id,
+                m.order_id, m.sequence, m.ts_in_delta);
+  return line;
+}
+
+} // namespace
+
+TEST(ExportTest, CsvMatchesReferenceFormatting) {
+  auto records = test_helpers::make_mbo_records(200);
+  // Calendar edges: leap day, year end, epoch, far future
+  const uint64_t timestamps[] = {1'709'251'199'999'999'999ULL, 1'735'689'599'000'000'001ULL, 0,
+                                 4'102'444'800'123'456'789ULL};
+  for (size_t i = 0; i < std::size(timestamps); ++i) {
+    records[i].ts_event = timestamps[i];
+  }
+  records[4].price = -1'500'000'000;
+  records[5].price = 7;
+  records[6].price = INT64_MIN;
+  records[7].order_id = UINT64_MAX;
+  records[8].flags = 255;
+
+  std::string expected;
+  for (const auto& r : records) {
+    expected += reference_csv(r);
+  }
+  EXPECT_EQ(encode(records, {}), expected);
+  EXPECT_EQ(databento::text_header({}),
+            "ts_event,instrument_id,action,side,flags,depth,price,size,channel_id,order_id,"
+            "sequence,ts_in_delta\n");
+}
+
+TEST(ExportTest, SpecialValues) {
+  MboMsg m = test_helpers::make_mbo(3);
+  m.ts_event = 1'704'067'200'123'456'789ULL;
+  m.price = INT64_MAX;  // Undefined
+  m.action = ',';
+  m.side = '\0';
+
+  ExportOptions csv;
+  EXPECT_EQ(encode({m}, csv),
+            "2024-01-01T00:00:00.123456789Z,1237,\",\",,0,0,,130,1,10003,3,0\n");
+
+  csv.iso_timestamps = false;
+  csv.decimal_prices = false;
+  m.price = -42;
+  m.action = '"';
+  EXPECT_EQ(encode({m}, csv), "1704067200123456789,1237,\"\"\"\",,0,0,-42,130,1,10003,3,0\n");
+
+  ExportOptions json;
+  json.format = TextFormat::JsonLines;
+  m.price = 5'000'250'000'000LL;
+  m.side = '\x01';
+  EXPECT_EQ(encode({m}, json),
+            "{\"ts_event\":\"2024-01-01T00:00:00.123456789Z\",\"instrument_id\":1237,"
+            "\"action\":\"\\\"\",\"side\":\"\\u0001\",\"flags\":0,\"depth\":0,"
+            "\"price\":\"5000.250000000\",\"size\":130,\"channel_id\":1,\"order_id\":10003,"
+            "\"sequence\":3,\"ts_in_delta\":0}\n");
+  EXPECT_EQ(databento::text_header(json), "");
+
+  m.price = INT64_MAX;
+  json.iso_timestamps = false;
+  const std::string line = encode({m}, json);
+  EXPECT_NE(line.find("\"ts_event\":1704067200123456789,"), std::string::npos);
+  EXPECT_NE(line.find("\"price\":null,"), std::string::npos);
+}
+
+TEST(ExportTest, ParallelExportIsOrdered) {
+  const auto records = test_helpers::make_mbo_records(10'007);
+  const std::string path = "/tmp/test_export.csv";
+
+  for (const auto format : {TextFormat::Csv, TextFormat::JsonLines}) {
+    ExportOptions options;
+    options.format = format;
+    options.chunk_records = 1'000;
+    options.threads = 3;
+    const std::string expected = databento::text_header(options) + encode(records, options);
+
+    const auto stats = databento::export_mbo_text(RecordRange(records), path, options);
+    EXPECT_EQ(stats.records, records.size());
+    EXPECT_EQ(stats.threads, 3u);
+    EXPECT_EQ(stats.bytes_written, expected.size());
+    EXPECT_EQ(read_file(path), expected);
+
+    options.threads = 1;
+    databento::export_mbo_text(RecordRange(records), path, options);
+    EXPECT_EQ(read_file(path), expected);
+  }
+
+  // From a parser, and an empty input still gets its header
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+  databento::export_mbo_text(parser, path);
+  EXPECT_EQ(read_file(path), databento::text_header({}) + encode(records, {}));
+
+  databento::export_mbo_text(RecordRange(records.data(), 0), path);
+  EXPECT_EQ(read_file(path), databento::text_header({}));
+  std::remove(path.c_str());
+
+  EXPECT_THROW(databento::export_mbo_text(RecordRange(records), "/nonexistent/dir/out.csv"),
+               std::runtime_error);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <databento/extract.hpp>
+#include <databento/generator.hpp>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using databento::CopyMethod;
+using databento::MboMsg;
+
+namespace {
+
+std::vector<MboMsg> sample_records() {
+  databento::GeneratorOptions options;
+  options.num_records = 20'000;
+  options.threads = 1;
+  return databento::generate_mbo_records(options);
+}
+
+std::vector<char> read_bytes(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST(ExtractTest, SliceMatchesFilteredRecords) {
+  const auto records = sample_records();
+  test_helpers::TempDbnFile file(records);
+  const std::string out_path = "/tmp/test_extract_out.dbn";
+
+  const uint64_t start = records[5'000].ts_event;
+  const uint64_t end = records[12'345].ts_event;
+  std::vector<MboMsg> expected;
+  for (const auto& m : records) {
+    if (m.ts_event >= start && m.ts_event < end) {
+      expected.push_back(m);
+    }
+  }
+
+  for (bool kernel_copy : {true, false}) {
+    databento::ExtractOptions options;
+    options.kernel_copy = kernel_copy;
+    const auto result = databento::extract_time_range(file.path(), out_path, start, end, options);
+    EXPECT_EQ(result.num_records, expected.size());
+    EXPECT_EQ(result.bytes_copied, expected.size() * sizeof(MboMsg));
+    EXPECT_NE(result.method, CopyMethod::None);
+    if (!kernel_copy) {
+      EXPECT_EQ(result.method, CopyMethod::ReadWrite);
+    }
+
+    databento::DbnParser parser(out_path);
+    parser.load_into_memory();
+    ASSERT_EQ(parser.num_records(), expected.size()) << databento::copy_method_name(result.method);
+    EXPECT_EQ(std::memcmp(parser.data() + parser.metadata_offset(), expected.data(),
+                          expected.size() * sizeof(MboMsg)),
+              0);
+    // Metadata block carried over unchanged
+    const auto in_bytes = read_bytes(file.path());
+    const auto out_bytes = read_bytes(out_path);
+    EXPECT_TRUE(std::equal(in_bytes.begin(), in_bytes.begin() + 200, out_bytes.begin()));
+  }
+  std::remove(out_path.c_str());
+}
+
+TEST(ExtractTest, FindTimeRangeBounds) {
+  const auto records = sample_records();
+  test_helpers::TempDbnFile file(records);
+
+  const auto all = databento::find_time_range(file.path(), 0, UINT64_MAX);
+  EXPECT_EQ(all.first, 0u);
+  EXPECT_EQ(all.last, records.size());
+
+  const uint64_t ts = records[777].ts_event;
+  const auto span = databento::find_time_range(file.path(), ts, ts + 1);
+  EXPECT_EQ(records[span.first].ts_event, ts);
+  EXPECT_TRUE(span.first == 0 || records[span.first - 1].ts_event < ts);
+  EXPECT_TRUE(span.last == records.size() || records[span.last].ts_event > ts);
+
+  const auto after = databento::find_time_range(file.path(), records.back().ts_event + 1, UINT64_MAX);
+  EXPECT_EQ(after.first, after.last);
+  EXPECT_THROW(databento::find_time_range(file.path(), 10, 5), std::invalid_argument);
+}
+
+TEST(ExtractTest, EmptySliceAndMissingInput) {
+  const auto records = sample_records();
+  test_helpers::TempDbnFile file(records);
+  const std::string out_path = "/tmp/test_extract_empty_out.dbn";
+
+  const auto result = databento::extract_time_range(file.path(), out_path, 0, 1);
+  EXPECT_EQ(result.num_records, 0u);
+  EXPECT_EQ(result.method, CopyMethod::None);
+  EXPECT_EQ(read_bytes(out_path).size(), 200u);
+  std::remove(out_path.c_str());
+
+  EXPECT_THROW(databento::extract_time_range("/tmp/does_not_exist.dbn", out_path, 0, 1),
+               std::runtime_error);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using test_helpers::TempDbnFile;
+
+// ============================================================================
+// poll_mbo Tests
+// ============================================================================
+
+TEST(FollowTest, PollDeliversOnlyNewRecords) {
+  auto records = test_helpers::make_mbo_records(20);
+  TempDbnFile file(std::vector<databento::MboMsg>(records.begin(), records.begin() + 5));
+
+  databento::DbnParser parser(file.path());
+  std::vector<uint32_t> seen;
+  auto callback = [&](const databento::MboMsg& msg) { seen.push_back(msg.sequence); };
+
+  EXPECT_EQ(parser.poll_mbo(callback), 5);
+  EXPECT_EQ(parser.poll_mbo(callback), 0);
+
+  test_helpers::append_records(
+      file.path(), std::vector<databento::MboMsg>(records.begin() + 5, records.end()));
+
+  EXPECT_EQ(parser.poll_mbo(callback), 15);
+  ASSERT_EQ(seen.size(), 20);
+  for (uint32_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(seen[i], i);
+  }
+  EXPECT_EQ(parser.num_records(), 20);
+  EXPECT_EQ(parser.next_record(), 20);
+}
+
+TEST(FollowTest, PartialRecordHeldBack) {
+  TempDbnFile file(test_helpers::make_mbo_records(2));
+  databento::DbnParser parser(file.path());
+
+  size_t count = 0;
+  auto callback = [&](const databento::MboMsg&) { ++count; };
+  parser.poll_mbo(callback);
+  EXPECT_EQ(count, 2);
+
+  // Write the first half of a record, then the rest
+  databento::MboMsg msg = test_helpers::make_mbo(2);
+  const char* bytes = reinterpret_cast<const char*>(&msg);
+  {
+    std::ofstream out(file.path(), std::ios::binary | std::ios::app);
+    out.write(bytes, 20);
+  }
+  EXPECT_EQ(parser.poll_mbo(callback), 0);
+
+  {
+    std::ofstream out(file.path(), std::ios::binary | std::ios::app);
+    out.write(bytes + 20, sizeof(msg) - 20);
+  }
+  EXPECT_EQ(parser.poll_mbo(callback), 1);
+  EXPECT_EQ(databento::parse_mbo(parser.get_record(2)).sequence, 2);
+}
+
+TEST(FollowTest, TruncationThrows) {
+  TempDbnFile file(test_helpers::make_mbo_records(4));
+  databento::DbnParser parser(file.path());
+  parser.poll_mbo([](const databento::MboMsg&) {});
+
+  { std::ofstream out(file.path(), std::ios::binary | std::ios::trunc); }
+  EXPECT_THROW(parser.poll_mbo([](const databento::MboMsg&) {}), std::runtime_error);
+}
+
+// ============================================================================
+// follow_mbo Tests
+// ============================================================================
+
+class FollowModeTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(FollowModeTest, FollowsAppendsUntilStopped) {
+  auto records = test_helpers::make_mbo_records(30);
+  TempDbnFile file(std::vector<databento::MboMsg>(records.begin(), records.begin() + 10));
+
+  databento::DbnParser parser(file.path());
+  databento::FollowOptions options;
+  options.use_inotify = GetParam();
+  options.idle_timeout = std::chrono::milliseconds(5000); // Safety net
+
+  std::atomic<size_t> count{0};
+  std::thread follower([&] {
+    parser.follow_mbo([&](const databento::MboMsg& msg) {
+      EXPECT_EQ(msg.sequence, count.load());
+      if (++count == records.size()) {
+        parser.stop_following();
+      }
+    }, options);
+  });
+
+  for (size_t i = 10; i < records.size(); i += 5) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    test_helpers::append_records(
+        file.path(),
+        std::vector<databento::MboMsg>(records.begin() + i, records.begin() + i + 5));
+  }
+
+  follower.join();
+  EXPECT_EQ(count.load(), records.size());
+}
+
+INSTANTIATE_TEST_SUITE_P(InotifyAndPolling, FollowModeTest, ::testing::Values(true, false));
+
+TEST(FollowTest, StartAtEndAndIdleTimeout) {
+  TempDbnFile file(test_helpers::make_mbo_records(8));
+  databento::DbnParser parser(file.path());
+
+  databento::FollowOptions options;
+  options.start_at_end = true;
+  options.idle_timeout = std::chrono::milliseconds(20);
+
+  size_t count = 0;
+  parser.follow_mbo([&](const databento::MboMsg&) { ++count; }, options);
+
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(parser.next_record(), 8);
+}
+
+TEST(FollowTest, CallbackExceptionClearsStopRequest) {
+  TempDbnFile file(test_helpers::make_mbo_records(4));
+  databento::DbnParser parser(file.path());
+
+  auto failing = [&](const databento::MboMsg&) {
+    parser.stop_following();
+    throw std::runtime_error("callback failed");
+  };
+  EXPECT_THROW(parser.follow_mbo(failing), std::runtime_error);
+
+  // The abandoned stop request must not end the next follow early
+  databento::FollowOptions options;
+  options.idle_timeout = std::chrono::milliseconds(20);
+  size_t count = 0;
+  parser.follow_mbo([&](const databento::MboMsg&) { ++count; }, options);
+  EXPECT_EQ(count, 3u);
+}
+
+TEST(FollowTest, PollBatchOnEmptyFile) {
+  TempDbnFile file;
+  { std::ofstream out(file.path(), std::ios::binary | std::ios::trunc); }
+  databento::DbnParser parser(file.path());
+
+  EXPECT_EQ(parser.poll_mbo_batch(16).size(), 0u);
+  EXPECT_EQ(parser.next_record(), 0u);
+}
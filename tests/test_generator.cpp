@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <databento/generator.hpp>
+#include <databento/order_book.hpp>
+#include <databento/parser.hpp>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+using databento::GeneratorOptions;
+using databento::MboMsg;
+
+namespace {
+
+GeneratorOptions small_options() {
+  GeneratorOptions options;
+  options.num_records = 50'000;
+  options.chunk_records = 8192;
+  options.num_instruments = 16;
+  options.threads = 1;
+  return options;
+}
+
+bool same_bytes(const std::vector<MboMsg>& a, const std::vector<MboMsg>& b) {
+  return a.size() == b.size() &&
+         std::memcmp(a.data(), b.data(), a.size() * sizeof(MboMsg)) == 0;
+}
+
+} // namespace
+
+TEST(GeneratorTest, DeterministicAcrossThreadCounts) {
+  auto options = small_options();
+  const auto serial = databento::generate_mbo_records(options);
+  options.threads = 4;
+  const auto parallel = databento::generate_mbo_records(options);
+  EXPECT_TRUE(same_bytes(serial, parallel));
+
+  options.seed = 43;
+  EXPECT_FALSE(same_bytes(serial, databento::generate_mbo_records(options)));
+}
+
+TEST(GeneratorTest, FileMatchesInMemory) {
+  auto options = small_options();
+  options.threads = 3;
+  const std::string path = "/tmp/test_generator.dbn";
+  databento::write_synthetic_dbn(path, options);
+
+  databento::DbnParser parser(path);
+  parser.load_into_memory();
+  ASSERT_EQ(parser.num_records(), options.num_records);
+  std::vector<MboMsg> from_file(parser.num_records());
+  std::memcpy(from_file.data(), parser.get_record(0), from_file.size() * sizeof(MboMsg));
+  EXPECT_TRUE(same_bytes(from_file, databento::generate_mbo_records(options)));
+  std::remove(path.c_str());
+}
+
+TEST(GeneratorTest, OrderLifecyclesAreConsistent) {
+  const auto options = small_options();
+  const auto records = databento::generate_mbo_records(options);
+
+  // Every cancel, modify and fill refers to a live order with matching
+  // side, and every trade is immediately followed by its fill
+  std::unordered_map<uint64_t, MboMsg> live;
+  uint64_t prev_ts = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const MboMsg& m = records[i];
+    ASSERT_GE(m.ts_event, prev_ts) << i;
+    prev_ts = m.ts_event;
+    ASSERT_EQ(m.sequence, i);
+    ASSERT_GT(m.size, 0u);
+    ASSERT_EQ(m.price % options.tick_size, 0);
+
+    switch (m.action) {
+      case 'A':
+        ASSERT_TRUE(live.emplace(m.order_id, m).second) << "duplicate add " << i;
+        break;
+      case 'C':
+      case 'M': {
+        auto it = live.find(m.order_id);
+        ASSERT_NE(it, live.end()) << i;
+        ASSERT_EQ(it->second.side, m.side);
+        if (m.action == 'C') {
+          ASSERT_EQ(it->second.size, m.size);
+          live.erase(it);
+        } else {
+          it->second = m;
+        }
+        break;
+      }
+      case 'T': {
+        ASSERT_LT(i + 1, records.size());
+        const MboMsg& fill = records[i + 1];
+        ASSERT_EQ(fill.action, 'F');
+        ASSERT_EQ(fill.ts_event, m.ts_event);
+        ASSERT_NE(fill.side, m.side);
+        ASSERT_EQ(m.flags & databento::F_LAST, 0);
+        break;
+      }
+      case 'F': {
+        auto it = live.find(m.order_id);
+        ASSERT_NE(it, live.end()) << i;
+        ASSERT_LE(m.size, it->second.size);
+        it->second.size -= m.size;
+        if (it->second.size == 0) {
+          live.erase(it);
+        }
+        break;
+      }
+      default:
+        FAIL() << "unexpected action " << m.action;
+    }
+  }
+
+  // The book accepts the stream and holds exactly the live orders
+  databento::OrderBook book;
+  for (const auto& m : records) {
+    book.apply(m);
+  }
+  EXPECT_EQ(book.order_count(), live.size());
+}
+
+TEST(GeneratorTest, InstrumentSkewAndActionMix) {
+  auto options = small_options();
+  options.num_records = 200'000;
+  options.instrument_skew = 1.2;
+  options.action_mix = {0.5, 0.3, 0.1, 0.1};
+  const auto records = databento::generate_mbo_records(options);
+
+  std::map<uint32_t, size_t> per_instrument;
+  std::map<char, size_t> per_action;
+  for (const auto& m : records) {
+    ++per_instrument[m.instrument_id];
+    ++per_action[m.action];
+  }
+  const size_t top = per_instrument[options.first_instrument_id];
+  const size_t last = per_instrument[options.first_instrument_id + options.num_instruments - 1];
+  EXPECT_GT(top, 10 * last);
+
+  // Trades count twice (T + F); adds are topped up when a book is empty
+  const double events = static_cast<double>(records.size() - per_action['F']);
+  EXPECT_NEAR(per_action['A'] / events, 0.5, 0.03);
+  EXPECT_NEAR(per_action['M'] / events, 0.1, 0.02);
+  EXPECT_NEAR(per_action['T'] / events, 0.1, 0.02);
+  EXPECT_EQ(per_action['T'], per_action['F']);
+}
+
+TEST(GeneratorTest, RejectsInvalidOptions) {
+  auto options = small_options();
+  options.num_instruments = 0;
+  EXPECT_THROW(databento::generate_mbo_records(options), std::invalid_argument);
+  options = small_options();
+  options.action_mix = {0, 0, 0, 0};
+  EXPECT_THROW(databento::generate_mbo_records(options), std::invalid_argument);
+}
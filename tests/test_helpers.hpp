@@ -0,0 +1,88 @@
+#pragma once
+
+#include <databento/dbn.hpp>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// ============================================================================
+// Shared helpers for building small DBN files in tests
+// ============================================================================
+
+namespace test_helpers {
+
+constexpr size_t kMetadataSize = 200;
+
+// Same record layout as TestDbnFile in test_parser.cpp
+inline databento::MboMsg make_mbo(int i) {
+  databento::MboMsg msg{};
+  msg.ts_event = 1000000000ULL + i * 1000;
+  msg.instrument_id = 1234 + (i % 10);
+  msg.action = 'A';
+  msg.side = (i % 2 == 0) ? 'B' : 'A';
+  msg.price = 5000'000'000'000LL + (i % 10) * 1'000'000'000LL;
+  msg.size = 100 + (i % 10) * 10;
+  msg.channel_id = 1;
+  msg.order_id = 10000ULL + i;
+  msg.sequence = i;
+  return msg;
+}
+
+inline std::vector<databento::MboMsg> make_mbo_records(int count) {
+  std::vector<databento::MboMsg> records;
+  records.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    records.push_back(make_mbo(i));
+  }
+  return records;
+}
+
+inline void write_metadata(std::ofstream& file) {
+  std::vector<uint8_t> metadata(kMetadataSize, 0);
+  metadata[0] = 1; // version
+  file.write(reinterpret_cast<const char*>(metadata.data()), kMetadataSize);
+}
+
+inline void append_records(const std::string& path,
+                           const std::vector<databento::MboMsg>& records) {
+  std::ofstream file(path, std::ios::binary | std::ios::app);
+  file.write(reinterpret_cast<const char*>(records.data()),
+             records.size() * sizeof(databento::MboMsg));
+}
+
+// Fresh path under /tmp, unique across processes (ctest -j) and calls
+inline std::string unique_temp_path(const std::string& suffix = ".dbn") {
+  static std::atomic<uint64_t> counter{0};
+  return "/tmp/databento_test_" + std::to_string(::getpid()) + "_" +
+         std::to_string(counter.fetch_add(1)) + suffix;
+}
+
+// Temporary DBN file at a unique path, removed on destruction
+class TempDbnFile {
+public:
+  explicit TempDbnFile(const std::vector<databento::MboMsg>& records = {})
+      : path_(unique_temp_path()) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    write_metadata(file);
+    file.write(reinterpret_cast<const char*>(records.data()),
+               records.size() * sizeof(databento::MboMsg));
+  }
+
+  ~TempDbnFile() {
+    std::remove(path_.c_str());
+  }
+
+  TempDbnFile(const TempDbnFile&) = delete;
+  TempDbnFile& operator=(const TempDbnFile&) = delete;
+
+  const std::string& path() const { return path_; }
+
+private:
+  std::string path_;
+};
+
+} // namespace test_helpers
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <databento/latency.hpp>
+#include <databento/parser.hpp>
+#include "test_helpers.hpp"
+#include <limits>
+#include <thread>
+#include <vector>
+
+using databento::LatencyHistogram;
+
+TEST(LatencyHistogramTest, BucketsCoverRangeWithBoundedError) {
+  EXPECT_EQ(LatencyHistogram::bucket_index(0), 0u);
+  EXPECT_EQ(LatencyHistogram::bucket_index(63), 63u);
+  EXPECT_EQ(LatencyHistogram::bucket_index(64), 64u);
+  EXPECT_EQ(LatencyHistogram::bucket_index(std::numeric_limits<uint64_t>::max()),
+            LatencyHistogram::NUM_BUCKETS - 1);
+  EXPECT_EQ(LatencyHistogram::bucket_upper_bound(LatencyHistogram::NUM_BUCKETS - 1),
+            std::numeric_limits<uint64_t>::max());
+
+  for (uint64_t v : {1ull, 100ull, 12345ull, 1ull << 40, (1ull << 40) + 12345}) {
+    const size_t index = LatencyHistogram::bucket_index(v);
+    const uint64_t upper = LatencyHistogram::bucket_upper_bound(index);
+    EXPECT_GE(upper, v);
+    EXPECT_LE(static_cast<double>(upper - v), 0.032 * static_cast<double>(v));
+    EXPECT_EQ(LatencyHistogram::bucket_index(upper), index);
+    EXPECT_EQ(LatencyHistogram::bucket_index(upper + 1), index + 1);
+  }
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram h;
+  EXPECT_EQ(h.percentile(0.5), 0u);
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    h.record(v);
+  }
+  EXPECT_EQ(h.count(), 10000u);
+  EXPECT_EQ(h.min(), 1u);
+  EXPECT_EQ(h.max(), 10000u);
+  EXPECT_DOUBLE_EQ(h.mean(), 5000.5);
+  EXPECT_NEAR(static_cast<double>(h.percentile(0.5)), 5000, 5000 * 0.032);
+  EXPECT_NEAR(static_cast<double>(h.percentile(0.99)), 9900, 9900 * 0.032);
+  EXPECT_EQ(h.percentile(1.0), 10000u);
+
+  // One slow outlier shows up at the tail but not the median
+  h.reset();
+  for (int i = 0; i < 999; ++i) {
+    h.record(20);
+  }
+  h.record(1'000'000);
+  EXPECT_EQ(h.percentile(0.5), 20u);
+  EXPECT_EQ(h.percentile(0.999), 20u);
+  EXPECT_EQ(h.percentile(1.0), 1'000'000u);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordAndMerge) {
+  LatencyHistogram shared;
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&shared, t] {
+      for (uint64_t v = 0; v < 50000; ++v) {
+        shared.record(t * 1000 + v % 1000);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(shared.count(), 200000u);
+  EXPECT_EQ(shared.min(), 0u);
+  EXPECT_EQ(shared.max(), 3999u);
+
+  LatencyHistogram other;
+  other.record(1u << 20);
+  shared.merge(other);
+  EXPECT_EQ(shared.count(), 200001u);
+  EXPECT_EQ(shared.max(), 1u << 20);
+}
+
+TEST(LatencyProbeTest, SamplingStrideRoundsToPowerOfTwo) {
+  EXPECT_EQ(databento::LatencyProbe(0).sample_every(), 1u);
+  EXPECT_EQ(databento::LatencyProbe(100).sample_every(), 128u);
+  databento::LatencyProbe probe(4);
+  EXPECT_TRUE(probe.should_sample(0));
+  EXPECT_FALSE(probe.should_sample(3));
+  EXPECT_TRUE(probe.should_sample(8));
+}
+
+TEST(LatencyProbeTest, ParserAndBatchProcessorRecordWhenEnabled) {
+  test_helpers::TempDbnFile file(test_helpers::make_mbo_records(10000));
+  databento::DbnParser parser(file.path());
+
+  databento::LatencyProbe probe(16);
+  parser.set_latency_probe(&probe);
+  parser.parse_mbo([](const databento::MboMsg&) {});
+
+  databento::LatencyProbe batch_probe;
+  databento::BatchProcessor processor(1000);
+  processor.set_latency_probe(&batch_probe);
+  processor.process_batches<databento::MboMsg>(
+      parser, [](const std::vector<databento::MboMsg>&) {});
+
+  if (databento::LATENCY_PROBES_ENABLED) {
+    EXPECT_EQ(probe.histogram().count(), 10000u / 16);
+    EXPECT_EQ(batch_probe.histogram().count(), 10u);
+    const auto summary = probe.summary();
+    EXPECT_LE(summary.p50_ns, summary.p99_ns);
+    EXPECT_LE(summary.p99_ns, summary.max_ns);
+  } else {
+    EXPECT_EQ(probe.histogram().count(), 0u);
+    EXPECT_EQ(batch_probe.histogram().count(), 0u);
+  }
+
+  // poll_mbo samples on the absolute record index
+  probe.reset();
+  parser.poll_mbo([](const databento::MboMsg&) {});
+  EXPECT_EQ(probe.histogram().count(), databento::LATENCY_PROBES_ENABLED ? 10000u / 16 : 0u);
+}
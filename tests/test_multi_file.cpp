@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <databento/multi_file.hpp>
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using databento::MboMsg;
+using databento::MultiFileOptions;
+using databento::MultiFileScan;
+
+namespace {
+
+// Four "day files" of different sizes in their own directory, plus a
+// stray non-DBN file
+class DayFiles {
+public:
+  DayFiles() {
+    std::filesystem::create_directories(dir_);
+    for (int day = 0; day < 4; ++day) {
+      auto records = test_helpers::make_mbo_records(1'000 * (day + 1));
+      for (auto& m : records) {
+        m.sequence += static_cast<uint32_t>(day) * 100'000;
+      }
+      write_file("day_" + std::to_string(day) + ".dbn", records);
+    }
+    write_file("notes.txt", {});
+  }
+  ~DayFiles() {
+    std::filesystem::remove_all(dir_);
+  }
+
+  const std::string& dir() const { return dir_; }
+
+private:
+  std::string dir_ = test_helpers::unique_temp_path("_days");
+
+  void write_file(const std::string& name, const std::vector<MboMsg>& records) {
+    const std::string path = dir_ + "/" + name;
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      test_helpers::write_metadata(file);
+    }
+    test_helpers::append_records(path, records);
+  }
+};
+
+} // namespace
+
+TEST(MultiFileScanTest, ListsDirectorySorted) {
+  DayFiles days;
+  const auto paths = MultiFileScan::list_directory(days.dir());
+  ASSERT_EQ(paths.size(), 4u);
+  for (size_t i = 0; i < paths.size(); ++i) {
+    EXPECT_EQ(paths[i], days.dir() + "/day_" + std::to_string(i) + ".dbn");
+  }
+  EXPECT_THROW(MultiFileScan::list_directory("/tmp/no_such_dir_for_test"), std::runtime_error);
+}
+
+TEST(MultiFileScanTest, DeliversEveryRecordInFileOrder) {
+  DayFiles days;
+  const auto paths = MultiFileScan::list_directory(days.dir());
+
+  // Unlimited, none, and a budget that fits only the current file
+  MultiFileOptions tight;
+  tight.memory_budget = 1;
+  MultiFileOptions wide;
+  wide.prefetch_files = 3;
+  MultiFileOptions none;
+  none.prefetch_files = 0;
+  none.drop_behind = false;
+
+  for (const auto& options : {MultiFileOptions{}, wide, tight, none}) {
+    std::vector<uint32_t> sequences;
+    MultiFileScan scan(paths, options);
+    const auto stats = scan.parse_mbo([&](const MboMsg& m) { sequences.push_back(m.sequence); });
+
+    ASSERT_EQ(sequences.size(), 10'000u);
+    EXPECT_TRUE(std::is_sorted(sequences.begin(), sequences.end()));
+    EXPECT_EQ(stats.files, 4u);
+    EXPECT_EQ(stats.records, 10'000u);
+    EXPECT_EQ(stats.bytes, 4 * 200 + 10'000 * sizeof(MboMsg));
+    if (options.prefetch_files == 0 || options.memory_budget == 1) {
+      EXPECT_EQ(stats.prefetched, 0u);
+    } else {
+      EXPECT_EQ(stats.prefetched, 3u);
+    }
+  }
+}
+
+TEST(MultiFileScanTest, PropagatesErrors) {
+  DayFiles days;
+  auto paths = MultiFileScan::list_directory(days.dir());
+  paths.insert(paths.begin() + 2, days.dir() + "/missing.dbn");
+
+  size_t files_seen = 0;
+  MultiFileScan scan(paths);
+  EXPECT_THROW(scan.for_each_file([&](databento::DbnParser&, size_t) { ++files_seen; }),
+               std::runtime_error);
+  EXPECT_EQ(files_seen, 2u);
+
+  MultiFileScan good(MultiFileScan::list_directory(days.dir()));
+  EXPECT_THROW(good.for_each_file([](databento::DbnParser&, size_t index) {
+                 if (index == 1) {
+                   throw std::logic_error("stop");
+                 }
+               }),
+               std::logic_error);
+}
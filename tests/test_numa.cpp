@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <databento/numa.hpp>
+#include "test_helpers.hpp"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using databento::MboMsg;
+using databento::NumaDbnFile;
+using databento::NumaOptions;
+
+namespace {
+
+// A sysfs-like node directory: two nodes sharing CPU 0 (which every test
+// process may use), a memory-only node, and an unrelated entry
+class FakeSysfs {
+public:
+  FakeSysfs() {
+    write("node0/cpulist", "0\n");
+    write("node1/cpulist", "0\n");
+    write("node2/cpulist", "\n");
+    write("possible", "0-2\n");
+  }
+  ~FakeSysfs() { std::filesystem::remove_all(root_); }
+
+  const std::string& root() const { return root_; }
+
+private:
+  std::string root_ = test_helpers::unique_temp_path("_sysfs");
+
+  void write(const std::string& name, const std::string& content) {
+    const auto path = std::filesystem::path(root_) / name;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream(path) << content;
+  }
+};
+
+} // namespace
+
+TEST(NumaTest, ParsesCpuLists) {
+  EXPECT_EQ(databento::parse_cpu_list("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(databento::parse_cpu_list(""), std::vector<int>{});
+  EXPECT_EQ(databento::parse_cpu_list("5"), std::vector<int>{5});
+  EXPECT_THROW(databento::parse_cpu_list("3-1"), std::invalid_argument);
+  EXPECT_THROW(databento::parse_cpu_list("a-b"), std::invalid_argument);
+}
+
+TEST(NumaTest, TopologyFromSysfsAndFallback) {
+  FakeSysfs sysfs;
+  const auto nodes = databento::numa_topology(sysfs.root());
+  ASSERT_EQ(nodes.size(), 2u);  // node2 has no CPUs
+  EXPECT_EQ(nodes[0].id, 0);
+  EXPECT_EQ(nodes[1].id, 1);
+  EXPECT_EQ(nodes[1].cpus, std::vector<int>{0});
+
+  const auto fallback = databento::numa_topology("/tmp/no_such_sysfs_for_test");
+  ASSERT_EQ(fallback.size(), 1u);
+  EXPECT_FALSE(fallback[0].cpus.empty());
+}
+
+TEST(NumaTest, LoadAndScanCoverEveryRecordOnce) {
+  FakeSysfs sysfs;
+  const auto records = test_helpers::make_mbo_records(10'001);
+  test_helpers::TempDbnFile file(records);
+
+  NumaOptions options;
+  options.threads_per_node = 3;
+  options.sysfs_root = sysfs.root();
+  NumaDbnFile numa(file.path(), options);
+  ASSERT_EQ(numa.num_threads(), 6u);
+  ASSERT_EQ(numa.num_records(), records.size());
+
+  std::vector<std::vector<uint32_t>> per_thread(numa.num_threads());
+  std::vector<int> thread_nodes(numa.num_threads(), -1);
+  numa.scan([&](unsigned t, int node, const databento::query::RecordRange& range) {
+    thread_nodes[t] = node;
+    for (size_t i = 0; i < range.count; ++i) {
+      per_thread[t].push_back(databento::parse_mbo(range.data + i * range.stride).sequence);
+    }
+  });
+
+  std::vector<uint32_t> all;
+  for (const auto& chunk : per_thread) {
+    all.insert(all.end(), chunk.begin(), chunk.end());
+  }
+  ASSERT_EQ(all.size(), records.size());
+  for (size_t i = 0; i < all.size(); ++i) {
+    ASSERT_EQ(all[i], records[i].sequence);
+  }
+  EXPECT_EQ(thread_nodes, (std::vector<int>{0, 0, 0, 1, 1, 1}));
+
+  uint64_t counted = 0;
+  for (const auto& s : numa.node_stats()) {
+    EXPECT_EQ(s.threads, 3u);
+    EXPECT_EQ(s.bytes, s.records * sizeof(MboMsg));
+    counted += s.records;
+  }
+  EXPECT_EQ(counted, records.size());
+
+  // Printing leaves std::cout's format as it was
+  const auto flags = std::cout.flags();
+  const auto precision = std::cout.precision();
+  testing::internal::CaptureStdout();
+  numa.print_stats();
+  testing::internal::GetCapturedStdout();
+  EXPECT_EQ(std::cout.flags(), flags);
+  EXPECT_EQ(std::cout.precision(), precision);
+
+  // The flat view matches the file
+  const auto flat = numa.records();
+  EXPECT_EQ(std::memcmp(flat.data, records.data(), records.size() * sizeof(MboMsg)), 0);
+}
+
+TEST(NumaTest, SingleNodeAndErrors) {
+  const auto records = test_helpers::make_mbo_records(100);
+  test_helpers::TempDbnFile file(records);
+  NumaOptions options;
+  options.sysfs_root = "/tmp/no_such_sysfs_for_test";
+  NumaDbnFile numa(file.path(), options);
+  EXPECT_EQ(numa.nodes().size(), 1u);
+
+  std::atomic<uint64_t> seen{0};
+  numa.scan([&](unsigned, int node, const databento::query::RecordRange& range) {
+    EXPECT_EQ(node, 0);
+    seen += range.count;
+  });
+  EXPECT_EQ(seen.load(), 100u);
+
+  EXPECT_THROW(NumaDbnFile("/tmp/does_not_exist.dbn", options), std::runtime_error);
+  EXPECT_THROW(numa.scan([](unsigned t, int, const databento::query::RecordRange&) {
+                 if (t == 0) {
+                   throw std::logic_error("stop");
+                 }
+               }),
+               std::logic_error);
+}
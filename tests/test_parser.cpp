@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <databento/parser.hpp>
 #include <databento/dbn.hpp>
+#include "test_helpers.hpp"
 #include <vector>
 #include <fstream>
 #include <cstdio>
@@ -11,7 +12,7 @@
 
 class TestDbnFile {
 public:
-  TestDbnFile() : path_("/tmp/test_databento_cpp.dbn") {
+  TestDbnFile() : path_(test_helpers::unique_temp_path()) {
     create_test_file();
   }
 
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <databento/parser.hpp>
+#include <databento/perf_counters.hpp>
+#include "test_helpers.hpp"
+#include <cmath>
+#include <vector>
+
+using databento::PerfEvent;
+
+TEST(PerfCountersTest, SampleReflectsAvailability) {
+  databento::PerfCounters counters;
+  counters.start();
+  std::vector<uint8_t> touched(size_t{16} << 20, 1);  // Fault in fresh pages
+  volatile uint8_t sink = touched[touched.size() / 2];
+  (void)sink;
+  const auto sample = counters.stop();
+
+  EXPECT_EQ(sample.available_mask & ~counters.available_mask(), 0u);
+  for (size_t e = 0; e < databento::NUM_PERF_EVENTS; ++e) {
+    const auto event = static_cast<PerfEvent>(e);
+    if (!sample.has(event)) {
+      EXPECT_EQ(sample.get(event), 0u);
+      EXPECT_TRUE(std::isnan(sample.per_record(event, 100)));
+    }
+  }
+  if (sample.has(PerfEvent::PageFaults)) {
+    EXPECT_GT(sample.get(PerfEvent::PageFaults), 100u);
+  }
+  if (sample.has(PerfEvent::Instructions)) {
+    EXPECT_GT(sample.get(PerfEvent::Instructions), 1'000'000u);
+  }
+}
+
+TEST(PerfCountersTest, PerRecordMetrics) {
+  databento::PerfSample sample;
+  sample.values[static_cast<size_t>(PerfEvent::Cycles)] = 1000;
+  sample.available_mask = 1u << static_cast<uint32_t>(PerfEvent::Cycles);
+
+  const auto phase = databento::PhaseCounters::from(sample, 10);
+  EXPECT_DOUBLE_EQ(phase.cycles_per_record, 100.0);
+  EXPECT_TRUE(std::isnan(phase.llc_misses_per_record));
+  EXPECT_TRUE(std::isnan(databento::PhaseCounters::from(sample, 0).cycles_per_record));
+}
+
+TEST(PerfCountersTest, ParseStatsSplitsPhases) {
+  test_helpers::TempDbnFile file(test_helpers::make_mbo_records(200000));
+  uint64_t count = 0;
+  auto stats = databento::parse_file_mbo(file.path(), [&](const databento::MboMsg&) { ++count; },
+                                         true);
+
+  EXPECT_EQ(count, 200000u);
+  EXPECT_TRUE(stats.counters_requested);
+  EXPECT_GT(stats.load_seconds, 0);
+  EXPECT_GT(stats.parse_seconds, 0);
+  EXPECT_DOUBLE_EQ(stats.elapsed_seconds, stats.load_seconds + stats.parse_seconds);
+  EXPECT_NEAR(stats.throughput_gbps,
+              200000.0 * 48 / (stats.elapsed_seconds * 1024 * 1024 * 1024), 1e-9);
+
+  // Loading 9 MB into a fresh buffer faults in pages; parsing does not
+  if (stats.load_counters.sample.has(PerfEvent::PageFaults)) {
+    EXPECT_TRUE(stats.counters_available);
+    EXPECT_GT(stats.load_counters.page_faults_per_record, 0.0);
+    EXPECT_LT(stats.parse_counters.page_faults_per_record,
+              stats.load_counters.page_faults_per_record);
+  }
+
+  auto plain = databento::parse_file_mbo(file.path(), [](const databento::MboMsg&) {});
+  EXPECT_FALSE(plain.counters_requested);
+  EXPECT_FALSE(plain.counters_available);
+  EXPECT_TRUE(std::isnan(plain.parse_counters.cycles_per_record));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <databento/projection.hpp>
+#include "test_helpers.hpp"
+#include <cstring>
+#include <vector>
+
+using databento::MboMsg;
+using databento::scan;
+using databento::scan_columns;
+using databento::query::RecordRange;
+
+TEST(ProjectionTest, ScanLoadsListedFields) {
+  const auto records = test_helpers::make_mbo_records(5'000);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+
+  size_t i = 0;
+  scan<&MboMsg::ts_event, &MboMsg::instrument_id, &MboMsg::price>(
+      parser, [&](uint64_t ts, uint32_t instrument, int64_t price) {
+        ASSERT_EQ(ts, records[i].ts_event);
+        ASSERT_EQ(instrument, records[i].instrument_id);
+        ASSERT_EQ(price, records[i].price);
+        ++i;
+      });
+  EXPECT_EQ(i, records.size());
+
+  // Every field type, in any order
+  i = 0;
+  scan<&MboMsg::ts_in_delta, &MboMsg::sequence, &MboMsg::order_id, &MboMsg::channel_id,
+       &MboMsg::size, &MboMsg::depth, &MboMsg::flags, &MboMsg::side, &MboMsg::action>(
+      RecordRange(records),
+      [&](uint8_t delta, uint32_t sequence, uint64_t order_id, uint32_t channel, uint32_t size,
+          uint8_t depth, uint8_t flags, char side, char action) {
+        const MboMsg& r = records[i++];
+        ASSERT_EQ(delta, r.ts_in_delta);
+        ASSERT_EQ(sequence, r.sequence);
+        ASSERT_EQ(order_id, r.order_id);
+        ASSERT_EQ(channel, r.channel_id);
+        ASSERT_EQ(size, r.size);
+        ASSERT_EQ(depth, r.depth);
+        ASSERT_EQ(flags, r.flags);
+        ASSERT_EQ(side, r.side);
+        ASSERT_EQ(action, r.action);
+      });
+  EXPECT_EQ(i, records.size());
+}
+
+TEST(ProjectionTest, StridedRecords) {
+  const auto records = test_helpers::make_mbo_records(300);
+  constexpr size_t stride = 56;
+  std::vector<uint8_t> buffer(records.size() * stride, 0xEE);
+  for (size_t i = 0; i < records.size(); ++i) {
+    std::memcpy(buffer.data() + i * stride, &records[i], sizeof(MboMsg));
+  }
+  const RecordRange range(buffer.data(), records.size(), stride);
+
+  std::vector<uint32_t> sequences;
+  scan<&MboMsg::sequence>(range, [&](uint32_t s) { sequences.push_back(s); });
+  ASSERT_EQ(sequences.size(), records.size());
+  EXPECT_EQ(sequences[299], 299u);
+
+  uint64_t total = 0;
+  scan_columns<&MboMsg::size>(range, [&](std::span<const uint32_t> size) {
+    for (uint32_t s : size) {
+      total += s;
+    }
+  });
+  uint64_t expected = 0;
+  for (const auto& r : records) {
+    expected += r.size;
+  }
+  EXPECT_EQ(total, expected);
+}
+
+TEST(ProjectionTest, ColumnBlocks) {
+  const auto records = test_helpers::make_mbo_records(2'500);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+
+  std::vector<size_t> block_sizes;
+  int64_t notional = 0;  // < 2.5e18 for these records
+  uint64_t first_ts = 0;
+  scan_columns<&MboMsg::price, &MboMsg::size, &MboMsg::ts_event>(
+      parser, [&](std::span<const int64_t> price, std::span<const uint32_t> size,
+                  std::span<const uint64_t> ts) {
+        ASSERT_EQ(price.size(), size.size());
+        ASSERT_EQ(price.size(), ts.size());
+        if (block_sizes.empty()) {
+          first_ts = ts[0];
+        }
+        block_sizes.push_back(price.size());
+        for (size_t i = 0; i < price.size(); ++i) {
+          notional += price[i] * size[i];
+        }
+      });
+
+  EXPECT_EQ(block_sizes, (std::vector<size_t>{1024, 1024, 452}));
+  EXPECT_EQ(first_ts, records[0].ts_event);
+  int64_t expected = 0;
+  for (const auto& r : records) {
+    expected += r.price * r.size;
+  }
+  EXPECT_EQ(notional, expected);
+
+  size_t calls = 0;
+  scan_columns<&MboMsg::price>(RecordRange(records.data(), 0), [&](auto) { ++calls; });
+  EXPECT_EQ(calls, 0u);
+}
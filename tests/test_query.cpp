@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <databento/generator.hpp>
+#include <databento/query.hpp>
+#include "test_helpers.hpp"
+#include <cmath>
+#include <map>
+
+using databento::Action;
+using databento::MboMsg;
+using namespace databento::query;
+
+namespace {
+
+const std::vector<MboMsg>& records() {
+  static const std::vector<MboMsg> data = [] {
+    databento::GeneratorOptions options;
+    options.num_records = 100'000;
+    options.chunk_records = 16'384;
+    options.num_instruments = 8;
+    options.threads = 1;
+    return databento::generate_mbo_records(options);
+  }();
+  return data;
+}
+
+constexpr uint32_t INSTRUMENT = 1001;
+
+} // namespace
+
+TEST(QueryTest, FieldTraitsMatchLayout) {
+  using databento::FieldTraits;
+  static_assert(std::is_same_v<FieldTraits<&MboMsg::price>::value_type, int64_t>);
+  EXPECT_EQ(FieldTraits<&MboMsg::size>::offset, offsetof(MboMsg, size));
+  EXPECT_STREQ(FieldTraits<&MboMsg::order_id>::name, "order_id");
+
+  MboMsg m = test_helpers::make_mbo(7);
+  m.side = 'B';
+  const auto* raw = reinterpret_cast<const uint8_t*>(&m);
+  EXPECT_EQ(FieldTraits<&MboMsg::ts_event>::load(raw), m.ts_event);
+  EXPECT_EQ(FieldTraits<&MboMsg::price>::load(raw), m.price);
+  EXPECT_EQ(FieldTraits<&MboMsg::side>::load(raw), 'B');
+}
+
+TEST(QueryTest, FilteredAggregatesMatchHandLoops) {
+  const auto& data = records();
+  uint64_t matches = 0;
+  uint64_t volume = 0;
+  int64_t min_price = INT64_MAX;
+  int64_t max_price = INT64_MIN;
+  double price_sum = 0;
+  for (const auto& m : data) {
+    if (m.instrument_id == INSTRUMENT && m.action == 'A') {
+      ++matches;
+      volume += m.size;
+      min_price = std::min(min_price, m.price);
+      max_price = std::max(max_price, m.price);
+      price_sum += static_cast<double>(m.price);
+    }
+  }
+  ASSERT_GT(matches, 0u);
+
+  const auto adds = where(instrument_id == INSTRUMENT && action == Action::Add);
+  EXPECT_EQ(adds.count().run(data), matches);
+  EXPECT_EQ(adds.sum(size).run(data), volume);
+  EXPECT_EQ(adds.min(price).run(data), min_price);
+  EXPECT_EQ(adds.max(price).run(data), max_price);
+  EXPECT_DOUBLE_EQ(adds.mean(price).run(data), price_sum / static_cast<double>(matches));
+
+  const auto [n, total, low, high] =
+      adds.aggregate(count(), sum(size), min(price), max(price)).run(data, 3);
+  EXPECT_EQ(n, matches);
+  EXPECT_EQ(total, volume);
+  EXPECT_EQ(low, min_price);
+  EXPECT_EQ(high, max_price);
+
+  // Every record: all() and an always-true predicate agree
+  EXPECT_EQ(all().count().run(data), data.size());
+  EXPECT_EQ(where(!(action == Action::Add) || action == Action::Add).count().run(data),
+            data.size());
+}
+
+TEST(QueryTest, GroupByDenseAndHashedKeys) {
+  const auto& data = records();
+  std::map<char, uint64_t> by_side;
+  std::map<uint32_t, int64_t> notional;
+  for (const auto& m : data) {
+    if (m.action == 'T' || m.action == 'F') {
+      by_side[m.side] += m.size;
+    }
+    if (m.size > 10) {
+      notional[m.instrument_id] += m.price * m.size;
+    }
+  }
+
+  const auto trades = where(action == Action::Trade || action == Action::Fill);
+  EXPECT_EQ(trades.group_by(side).sum(size).run(data), by_side);
+
+  const auto result = where(size > 10).group_by(instrument_id).sum(price * size).run(data);
+  EXPECT_EQ(result, notional);
+
+  const auto fused = where(size > 10).group_by(instrument_id).aggregate(sum(price * size), count())
+                         .run(data, 2);
+  ASSERT_EQ(fused.size(), notional.size());
+  for (const auto& [id, row] : fused) {
+    EXPECT_EQ(std::get<0>(row), notional.at(id));
+  }
+
+  const auto counts = all().group_by(action).count().run(data);
+  uint64_t total = 0;
+  for (const auto& [a, n] : counts) {
+    total += n;
+  }
+  EXPECT_EQ(total, data.size());
+  EXPECT_EQ(counts.count('R'), 0u);  // No clears generated, so no empty group
+}
+
+TEST(QueryTest, SelectProjectsInRecordOrder) {
+  const auto& data = records();
+  const auto rows = where(instrument_id == INSTRUMENT && side == 'B')
+                        .select(ts_event, price, size)
+                        .run(data, 4);
+  size_t r = 0;
+  for (const auto& m : data) {
+    if (m.instrument_id == INSTRUMENT && m.side == 'B') {
+      ASSERT_LT(r, rows.size());
+      EXPECT_EQ(rows[r], std::make_tuple(m.ts_event, m.price, m.size));
+      ++r;
+    }
+  }
+  EXPECT_EQ(r, rows.size());
+}
+
+TEST(QueryTest, ParallelMatchesSerial) {
+  const auto& data = records();
+  const auto plan = where(price >= 100'000'000'000 && depth < 5).group_by(instrument_id).max(size);
+  const auto serial = plan.run(data);
+  for (unsigned threads : {2u, 3u, 8u}) {
+    EXPECT_EQ(plan.run(data, threads), serial) << threads;
+  }
+  EXPECT_EQ(all().sum(size).run(data, 4), all().sum(size).run(data, 1));
+}
+
+TEST(QueryTest, MixedSignComparisonsAndEmptyInput) {
+  std::vector<MboMsg> data = {test_helpers::make_mbo(1)};
+  data[0].price = -5;
+  EXPECT_EQ(where(size > -1).count().run(data), 1u);   // Not 0xffffffff
+  EXPECT_EQ(where(price < 0u).count().run(data), 1u);
+  EXPECT_EQ(where(price + 10 == 5).count().run(data), 1u);
+
+  const std::vector<MboMsg> empty;
+  EXPECT_EQ(all().count().run(empty, 4), 0u);
+  EXPECT_FALSE(all().min(price).run(empty).has_value());
+  EXPECT_TRUE(std::isnan(all().mean(price).run(empty)));
+  EXPECT_TRUE(all().group_by(side).count().run(empty).empty());
+}
+
+TEST(QueryTest, RunsOverParser) {
+  test_helpers::TempDbnFile file(test_helpers::make_mbo_records(1000));
+  databento::DbnParser parser(file.path());
+  EXPECT_EQ(all().count().run(parser), 1000u);
+  EXPECT_EQ(all().sum(size).run(parser), all().sum(size).run(test_helpers::make_mbo_records(1000)));
+}
+
+TEST(QueryTest, RecordRangeRejectsShortStride) {
+  const auto records = test_helpers::make_mbo_records(4);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(records.data());
+  EXPECT_THROW(RecordRange(bytes, 4, sizeof(MboMsg) - 1), std::invalid_argument);
+  EXPECT_THROW(RecordRange(bytes, 0, 0), std::invalid_argument);
+  EXPECT_EQ(RecordRange(bytes, 2, 2 * sizeof(MboMsg)).stride, 2 * sizeof(MboMsg));
+}
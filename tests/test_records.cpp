@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <databento/parser.hpp>
+#include <databento/records.hpp>
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#ifdef DATABENTO_HAVE_TBB
+#include <execution>
+#endif
+
+using databento::MboMsg;
+using databento::RecordView;
+
+TEST(RecordViewTest, ParserRecordsAreZeroCopy) {
+  const auto records = test_helpers::make_mbo_records(1'000);
+  test_helpers::TempDbnFile file(records);
+
+  databento::DbnParser parser(file.path());
+  auto view = parser.records<MboMsg>();  // Loads on first use
+  ASSERT_EQ(view.size(), records.size());
+  EXPECT_TRUE(view.contiguous());
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(&view[0]), parser.get_record(0));
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(&view.back()), parser.get_record(999));
+  EXPECT_EQ(view.span().data(), &view.front());
+
+  size_t i = 0;
+  for (const MboMsg& msg : view) {
+    ASSERT_EQ(std::memcmp(&msg, &records[i], sizeof(MboMsg)), 0);
+    ++i;
+  }
+  EXPECT_EQ(i, records.size());
+}
+
+TEST(RecordViewTest, RangesSearchOnTimestamps) {
+  const auto records = test_helpers::make_mbo_records(10'000);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+  const auto view = parser.records<MboMsg>();
+
+  // ts_event = 1e9 + i * 1000
+  const auto it = std::ranges::lower_bound(view, 1'000'000'000ULL + 4'321'500, {},
+                                           &MboMsg::ts_event);
+  EXPECT_EQ(it - view.begin(), 4'322);
+  EXPECT_EQ(it->sequence, 4'322u);
+
+  const auto end = std::ranges::upper_bound(view, 1'000'000'000ULL + 5'000'000, {},
+                                            &MboMsg::ts_event);
+  EXPECT_EQ(end - it, 5'001 - 4'322);
+
+  const auto split = std::ranges::partition_point(
+      view, [](const MboMsg& m) { return m.sequence < 777; });
+  EXPECT_EQ(split - view.begin(), 777);
+  EXPECT_EQ(std::ranges::distance(view.begin(), view.end()), 10'000);
+}
+
+TEST(RecordViewTest, StridedRecords) {
+  // Records padded to 64 bytes: still random access, but not contiguous
+  const auto records = test_helpers::make_mbo_records(100);
+  constexpr size_t stride = 64;
+  std::vector<uint8_t> buffer(records.size() * stride, 0xFF);
+  for (size_t i = 0; i < records.size(); ++i) {
+    std::memcpy(buffer.data() + i * stride, &records[i], sizeof(MboMsg));
+  }
+
+  const RecordView<MboMsg> view(buffer.data(), records.size(), stride);
+  EXPECT_FALSE(view.contiguous());
+  EXPECT_THROW(view.span(), std::logic_error);
+  EXPECT_EQ(view[57].sequence, 57u);
+  EXPECT_EQ((view.end() - 1)->sequence, 99u);
+  EXPECT_EQ(view.begin()[42].order_id, records[42].order_id);
+
+  auto it = view.begin() + 10;
+  it -= 3;
+  EXPECT_EQ(it->sequence, 7u);
+  EXPECT_TRUE(view.begin() < it);
+
+  EXPECT_THROW(RecordView<MboMsg>(buffer.data(), 1, sizeof(MboMsg) - 1), std::invalid_argument);
+}
+
+TEST(RecordViewTest, ParallelForEach) {
+  const auto records = test_helpers::make_mbo_records(50'000);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+  const auto view = parser.records<MboMsg>();
+
+  std::atomic<uint64_t> volume{0};
+  auto add = [&](const MboMsg& m) { volume.fetch_add(m.size, std::memory_order_relaxed); };
+#ifdef DATABENTO_HAVE_TBB
+  std::for_each(std::execution::par_unseq, view.begin(), view.end(), add);
+#else
+  std::for_each(view.begin(), view.end(), add);
+#endif
+
+  const uint64_t expected = std::accumulate(
+      records.begin(), records.end(), uint64_t{0},
+      [](uint64_t sum, const MboMsg& m) { return sum + m.size; });
+  EXPECT_EQ(volume.load(), expected);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <databento/replay.hpp>
+#include <databento/spsc_queue.hpp>
+#include "test_helpers.hpp"
+#include <thread>
+#include <vector>
+
+using test_helpers::TempDbnFile;
+
+namespace {
+
+// 21 records spaced 1ms apart -> 20ms of data
+std::vector<databento::MboMsg> spaced_records() {
+  auto records = test_helpers::make_mbo_records(21);
+  for (size_t i = 0; i < records.size(); ++i) {
+    records[i].ts_event = 1'000'000'000ULL + i * 1'000'000ULL;
+  }
+  return records;
+}
+
+} // namespace
+
+// ============================================================================
+// PacingHistogram Tests
+// ============================================================================
+
+TEST(PacingHistogramTest, BucketsAndPercentiles) {
+  databento::PacingHistogram hist;
+  hist.record(0);
+  hist.record(3);     // bucket 2: [2, 4)
+  hist.record(-3);    // early
+  hist.record(1000);  // bucket 10: [512, 1024)
+
+  EXPECT_EQ(hist.count(), 4);
+  EXPECT_EQ(hist.early_count(), 1);
+  EXPECT_EQ(hist.max_abs_ns(), 1000);
+  EXPECT_EQ(hist.buckets()[0], 1);
+  EXPECT_EQ(hist.buckets()[2], 2);
+  EXPECT_EQ(hist.buckets()[10], 1);
+  EXPECT_EQ(hist.percentile(50), 3);
+  EXPECT_EQ(hist.percentile(100), 1023);
+}
+
+// ============================================================================
+// SpscQueue Tests
+// ============================================================================
+
+TEST(SpscQueueTest, CrossThreadOrdering) {
+  databento::SpscQueue<uint64_t> queue(8);
+  EXPECT_EQ(queue.capacity(), 8);
+
+  constexpr uint64_t N = 100000;
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < N; ++i) {
+      while (!queue.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected = 0;
+  uint64_t value;
+  while (expected < N) {
+    if (queue.try_pop(value)) {
+      ASSERT_EQ(value, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_FALSE(queue.try_pop(value));
+}
+
+// ============================================================================
+// ReplayEngine Tests
+// ============================================================================
+
+TEST(ReplayEngineTest, AsFastAsPossible) {
+  TempDbnFile file(spaced_records());
+  databento::DbnParser parser(file.path());
+
+  databento::ReplayOptions options;
+  options.speed = 0.0;
+  databento::ReplayEngine engine(options);
+
+  std::vector<uint32_t> seen;
+  auto stats = engine.replay_mbo(parser, [&](const databento::MboMsg& msg) {
+    seen.push_back(msg.sequence);
+  });
+
+  ASSERT_EQ(seen.size(), 21);
+  for (uint32_t i = 0; i < seen.size(); ++i) {
+    EXPECT_EQ(seen[i], i);
+  }
+  EXPECT_EQ(stats.total_records, 21);
+  EXPECT_EQ(stats.pacing_error.count(), 0);
+  EXPECT_NEAR(stats.data_span_seconds, 0.020, 1e-9);
+}
+
+TEST(ReplayEngineTest, RealTimePreservesGaps) {
+  TempDbnFile file(spaced_records());
+  databento::DbnParser parser(file.path());
+  databento::ReplayEngine engine;
+
+  std::vector<int64_t> arrivals;
+  auto stats = engine.replay_mbo(parser, [&](const databento::MboMsg&) {
+    arrivals.push_back(std::chrono::steady_clock::now().time_since_epoch().count());
+  });
+
+  ASSERT_EQ(arrivals.size(), 21);
+  EXPECT_EQ(stats.pacing_error.count(), 21);
+  EXPECT_EQ(stats.pacing_error.early_count(), 0);  // Never ahead of schedule
+  EXPECT_GE(stats.elapsed_seconds, 0.020);
+  // Deadlines are absolute, so the last record lands >= 20ms after the first
+  EXPECT_GE(arrivals.back() - arrivals.front(), 19'000'000);
+}
+
+TEST(ReplayEngineTest, AcceleratedThreadedDelivery) {
+  TempDbnFile file(spaced_records());
+  databento::DbnParser parser(file.path());
+
+  databento::ReplayOptions options;
+  options.speed = 10.0;
+  options.threaded = true;
+  options.queue_capacity = 4;
+  databento::ReplayEngine engine(options);
+
+  const auto caller = std::this_thread::get_id();
+  std::vector<uint32_t> seen;
+  auto stats = engine.replay_mbo(parser, [&](const databento::MboMsg& msg) {
+    EXPECT_NE(std::this_thread::get_id(), caller);
+    seen.push_back(msg.sequence);
+  });
+
+  ASSERT_EQ(seen.size(), 21);
+  EXPECT_EQ(seen.back(), 20);
+  EXPECT_GE(stats.elapsed_seconds, 0.002);
+}
+
+TEST(ReplayEngineTest, StopFromCallback) {
+  TempDbnFile file(spaced_records());
+  databento::DbnParser parser(file.path());
+
+  databento::ReplayOptions options;
+  options.speed = 0.0;
+  databento::ReplayEngine engine(options);
+
+  auto stats = engine.replay_mbo(parser, [&](const databento::MboMsg& msg) {
+    if (msg.sequence == 4) {
+      engine.stop();
+    }
+  });
+  EXPECT_EQ(stats.total_records, 5);
+}
+
+TEST(ReplayEngineTest, ConsumerExceptionPropagates) {
+  TempDbnFile file(spaced_records());
+  databento::DbnParser parser(file.path());
+
+  databento::ReplayOptions options;
+  options.speed = 0.0;
+  options.threaded = true;
+  databento::ReplayEngine engine(options);
+
+  EXPECT_THROW(engine.replay_mbo(parser, [](const databento::MboMsg& msg) {
+    if (msg.sequence == 3) {
+      throw std::runtime_error("consumer failed");
+    }
+  }), std::runtime_error);
+}
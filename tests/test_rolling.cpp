@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <databento/rolling.hpp>
+#include <algorithm>
+#include <random>
+
+using databento::MboMsg;
+using databento::RollingOptions;
+using databento::RollingWindows;
+using databento::WindowStats;
+using databento::int128_t;
+
+namespace {
+
+MboMsg make_trade(uint64_t ts, uint32_t instrument_id, int64_t price, uint32_t size, char side) {
+  MboMsg msg{};
+  msg.ts_event = ts;
+  msg.instrument_id = instrument_id;
+  msg.action = 'T';
+  msg.side = side;
+  msg.price = price;
+  msg.size = size;
+  return msg;
+}
+
+// Recompute one window from scratch over (now - length, now]
+WindowStats naive_window(const std::vector<MboMsg>& records, uint32_t instrument_id,
+                         uint64_t length, uint64_t now) {
+  WindowStats s;
+  s.window_ns = length;
+  bool has_prev = false;
+  int64_t prev = 0;
+  for (const auto& m : records) {
+    if (m.instrument_id != instrument_id || m.action != 'T') {
+      continue;
+    }
+    const bool inside = m.ts_event <= now && now - m.ts_event < length;
+    if (inside) {
+      ++s.trades;
+      s.volume += m.size;
+      s.buy_volume += m.side == 'B' ? m.size : 0;
+      s.sell_volume += m.side == 'A' ? m.size : 0;
+      s.notional += static_cast<int128_t>(m.price) * m.size;
+      s.min_price = std::min(s.min_price, m.price);
+      s.max_price = std::max(s.max_price, m.price);
+      if (has_prev) {
+        const int64_t change = m.price - prev;
+        ++s.changes;
+        s.sum_change += change;
+        s.sum_change_sq += static_cast<int128_t>(change) * change;
+      }
+    }
+    has_prev = true;
+    prev = m.price;
+  }
+  return s;
+}
+
+} // namespace
+
+TEST(RollingWindowsTest, MatchesNaiveRecompute) {
+  RollingOptions options;
+  options.windows_ns = {100'000'000, 1'000'000'000, 10'000'000'000};
+  RollingWindows rolling(options);
+
+  std::mt19937_64 rng(11);
+  std::vector<MboMsg> records;
+  uint64_t ts = 1'700'000'000'000'000'000ULL;
+  int64_t price = 4'500'000'000'000LL;
+  for (int i = 0; i < 20'000; ++i) {
+    ts += rng() % 20'000'000;  // Up to 20ms apart, often equal
+    price += static_cast<int64_t>(rng() % 5) * 250'000'000LL - 500'000'000LL;
+    MboMsg msg = make_trade(ts, 1 + static_cast<uint32_t>(rng() % 3), price,
+                            1 + static_cast<uint32_t>(rng() % 50), rng() % 2 ? 'B' : 'A');
+    if (rng() % 4 == 0) {
+      msg.action = 'A';  // Non-trades move the clock only
+    }
+    records.push_back(msg);
+    rolling.add(msg);
+
+    if (i % 97 == 0) {
+      for (uint32_t id = 1; id <= 3; ++id) {
+        for (size_t w = 0; w < rolling.num_windows(); ++w) {
+          ASSERT_EQ(rolling.stats(id, w), naive_window(records, id, options.windows_ns[w], ts))
+              << "record " << i << " instrument " << id << " window " << w;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(rolling.instruments(), (std::vector<uint32_t>{1, 2, 3}));
+
+  // Far in the future every window is empty
+  const WindowStats later = rolling.stats(2, 2, ts + 20'000'000'000ULL);
+  EXPECT_EQ(later.trades, 0u);
+  EXPECT_EQ(later.notional, 0);
+  EXPECT_EQ(later.min_price, INT64_MAX);
+  EXPECT_EQ(later.vwap_fixed(), 0);
+}
+
+TEST(RollingWindowsTest, DerivedStatistics) {
+  RollingOptions options;
+  options.windows_ns = {1'000};
+  RollingWindows rolling(options);
+  rolling.add(make_trade(100, 7, 10'000'000'000LL, 10, 'B'));
+  rolling.add(make_trade(200, 7, 11'000'000'000LL, 30, 'B'));
+  rolling.add(make_trade(300, 7, 10'000'000'000LL, 20, 'A'));
+  rolling.add(make_trade(400, 7, 13'000'000'000LL, 40, 'B'));
+
+  const WindowStats s = rolling.stats(7, 0);
+  EXPECT_EQ(s.trades, 4u);
+  EXPECT_EQ(s.volume, 100u);
+  EXPECT_DOUBLE_EQ(s.imbalance(), 0.6);  // (80 - 20) / 100
+  EXPECT_EQ(s.vwap_fixed(), 11'500'000'000LL);
+  EXPECT_EQ(s.min_price, 10'000'000'000LL);
+  EXPECT_EQ(s.max_price, 13'000'000'000LL);
+  // Changes +1, -1, +3: mean 1, sample variance (0 + 4 + 4) / 2 = 4
+  EXPECT_EQ(s.changes, 3u);
+  EXPECT_NEAR(s.volatility(), 2.0, 1e-12);
+
+  // At t=1150 the first trade (t=100) has left the window
+  const WindowStats t = rolling.stats(7, 0, 1'150);
+  EXPECT_EQ(t.trades, 3u);
+  EXPECT_EQ(t.min_price, 10'000'000'000LL);
+  EXPECT_EQ(t.changes, 3u);  // The change into t=200 ends inside the window
+
+  // Out-of-order timestamps are clamped to the instrument's last one
+  rolling.add(make_trade(50, 7, 9'000'000'000LL, 1, 'A'));
+  EXPECT_EQ(rolling.stats(7, 0, 1'150).min_price, 9'000'000'000LL);
+
+  // Queries past now() evict nothing: at now() = 500 the t=100 trade counts
+  rolling.add(make_trade(500, 7, 12'000'000'000LL, 5, 'B'));
+  EXPECT_EQ(rolling.stats(7, 0).trades, 6u);
+  EXPECT_EQ(rolling.stats(7, 0, 1'150).trades, 5u);
+  EXPECT_THROW(rolling.stats(7, 0, 499), std::invalid_argument);
+}
+
+TEST(RollingWindowsTest, QueriesCannotGoBackInTime) {
+  RollingOptions options;
+  options.windows_ns = {1'000};
+  RollingWindows rolling(options);
+  rolling.add(make_trade(100, 1, 10'000'000'000LL, 10, 'B'));
+  MboMsg other = make_trade(5'000, 2, 10'000'000'000LL, 1, 'B');
+  other.action = 'A';
+  rolling.add(other);
+  ASSERT_EQ(rolling.now(), 5'000u);
+
+  // Repeating an earlier query gives the same answer
+  EXPECT_EQ(rolling.stats(1, 0, 500).trades, 1u);
+  EXPECT_EQ(rolling.stats(1, 0, 500).trades, 1u);
+
+  // Once a query has evicted to now(), earlier times are rejected rather
+  // than answered from the evicted state
+  EXPECT_EQ(rolling.stats(1, 0).trades, 0u);
+  EXPECT_THROW(rolling.stats(1, 0, 500), std::invalid_argument);
+  EXPECT_EQ(rolling.stats(1, 0, 5'000).trades, 0u);
+
+  // Projections past now() evict nothing, so times back to now() still work
+  EXPECT_EQ(rolling.stats(1, 0, 9'000).trades, 0u);
+  EXPECT_EQ(rolling.stats(1, 0, 5'000).trades, 0u);
+}
+
+TEST(RollingWindowsTest, RejectsBadInput) {
+  RollingOptions none;
+  none.windows_ns.clear();
+  EXPECT_THROW(RollingWindows{none}, std::invalid_argument);
+  RollingOptions zero;
+  zero.windows_ns = {0};
+  EXPECT_THROW(RollingWindows{zero}, std::invalid_argument);
+
+  RollingWindows rolling;
+  EXPECT_EQ(rolling.num_windows(), 4u);
+  EXPECT_THROW(rolling.stats(1, 4), std::out_of_range);
+  const WindowStats unknown = rolling.stats(99, 1);
+  EXPECT_EQ(unknown.window_ns, 1'000'000'000u);
+  EXPECT_EQ(unknown.trades, 0u);
+  EXPECT_EQ(unknown.volatility(), 0.0);
+  EXPECT_EQ(unknown.imbalance(), 0.0);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <databento/generator.hpp>
+#include <databento/sketch.hpp>
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <unordered_set>
+
+using databento::HyperLogLog;
+using databento::KllSketch;
+using databento::MboMsg;
+
+namespace {
+
+// Rank error of a quantile answer against the exact sorted data
+double rank_error(const std::vector<double>& sorted, double q, double answer) {
+  const auto below = std::upper_bound(sorted.begin(), sorted.end(), answer) - sorted.begin();
+  return std::abs(static_cast<double>(below) / static_cast<double>(sorted.size()) - q);
+}
+
+std::vector<MboMsg> sample_records() {
+  databento::GeneratorOptions options;
+  options.num_records = 300'000;
+  options.chunk_records = 65'536;
+  options.num_instruments = 6;
+  options.threads = 1;
+  return databento::generate_mbo_records(options);
+}
+
+} // namespace
+
+TEST(KllSketchTest, QuantilesWithinRankError) {
+  std::mt19937_64 rng(7);
+  std::lognormal_distribution<double> dist(3.0, 1.0);
+  KllSketch sketch;
+  std::vector<double> values(1'000'000);
+  for (auto& v : values) {
+    v = dist(rng);
+    sketch.update(v);
+  }
+  std::sort(values.begin(), values.end());
+
+  EXPECT_EQ(sketch.count(), values.size());
+  EXPECT_LT(sketch.retained(), 1000u);  // Bounded, about 3k
+  EXPECT_EQ(sketch.quantile(0), values.front());
+  EXPECT_EQ(sketch.quantile(1), values.back());
+  for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+    EXPECT_LT(rank_error(values, q, sketch.quantile(q)), 0.015) << q;
+  }
+  EXPECT_NEAR(sketch.rank(values[values.size() / 2]), 0.5, 0.015);
+}
+
+TEST(KllSketchTest, MergedChunksMatchDistribution) {
+  std::vector<double> values;
+  std::vector<KllSketch> parts(8, KllSketch(200, 3));
+  for (int i = 0; i < 400'000; ++i) {
+    const double v = static_cast<double>(static_cast<uint64_t>(i) * 7919 % 100'003);
+    values.push_back(v);
+    parts[static_cast<size_t>(i) % parts.size()].update(v);
+  }
+  KllSketch merged(200, 3);
+  for (const auto& part : parts) {
+    merged.merge(part);
+  }
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(merged.count(), values.size());
+  EXPECT_LT(merged.retained(), 1000u);
+  for (double q : {0.05, 0.5, 0.95}) {
+    EXPECT_LT(rank_error(values, q, merged.quantile(q)), 0.015) << q;
+  }
+
+  KllSketch empty;
+  EXPECT_TRUE(std::isnan(empty.quantile(0.5)));
+  EXPECT_THROW(KllSketch(4), std::invalid_argument);
+}
+
+TEST(HyperLogLogTest, EstimatesAndMerges) {
+  HyperLogLog small;
+  for (uint64_t id = 1; id <= 100; ++id) {
+    small.add(id);
+    small.add(id);  // Duplicates do not count
+  }
+  EXPECT_NEAR(small.estimate(), 100, 2);
+
+  HyperLogLog a;
+  HyperLogLog b;
+  for (uint64_t id = 0; id < 200'000; ++id) {
+    (id < 120'000 ? a : b).add(id * 1'000'003);
+  }
+  EXPECT_NEAR(a.estimate(), 120'000, 120'000 * 0.05);
+  a.merge(b);
+  EXPECT_NEAR(a.estimate(), 200'000, 200'000 * 0.05);
+
+  EXPECT_THROW(a.merge(HyperLogLog(10)), std::invalid_argument);
+  EXPECT_THROW(HyperLogLog(3), std::invalid_argument);
+}
+
+TEST(InstrumentSketchesTest, PerInstrumentDistributions) {
+  const auto records = sample_records();
+  std::map<uint32_t, std::unordered_set<uint64_t>> orders;
+  std::map<uint32_t, uint64_t> adds;
+  std::map<uint32_t, uint64_t> trades;
+  for (const auto& m : records) {
+    orders[m.instrument_id].insert(m.order_id);
+    adds[m.instrument_id] += m.action == 'A';
+    trades[m.instrument_id] += m.action == 'T';
+  }
+
+  databento::SketchOptions options;
+  options.threads = 4;
+  const auto sketches = databento::sketch_by_instrument(records, options);
+  ASSERT_EQ(sketches.instruments().size(), orders.size());
+  for (uint32_t id : sketches.instruments()) {
+    const auto* s = sketches.find(id);
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->sizes.count(), adds[id]);
+    // Changes joined across chunk boundaries: exactly trades - 1
+    EXPECT_EQ(s->price_changes.count(), trades[id] - 1) << id;
+    const double distinct = static_cast<double>(orders[id].size());
+    EXPECT_NEAR(s->order_ids.estimate(), distinct, distinct * 0.05) << id;
+    EXPECT_GE(s->sizes.quantile(0.5), 1.0);
+  }
+  EXPECT_EQ(sketches.find(42), nullptr);
+}
+
+TEST(InstrumentSketchesTest, CallbackFeedMatchesSerialScan) {
+  test_helpers::TempDbnFile file(sample_records());
+  databento::DbnParser parser(file.path());
+  databento::InstrumentSketches fed;
+  parser.parse_mbo([&](const MboMsg& m) { fed.add(m); });
+
+  databento::SketchOptions options;
+  options.threads = 1;
+  const auto scanned = databento::sketch_by_instrument(parser, options);
+  ASSERT_EQ(fed.instruments(), scanned.instruments());
+  for (uint32_t id : fed.instruments()) {
+    for (double q : {0.1, 0.5, 0.9}) {
+      EXPECT_EQ(fed.find(id)->sizes.quantile(q), scanned.find(id)->sizes.quantile(q));
+      EXPECT_EQ(fed.find(id)->price_changes.quantile(q),
+                scanned.find(id)->price_changes.quantile(q));
+    }
+    EXPECT_EQ(fed.find(id)->order_ids.estimate(), scanned.find(id)->order_ids.estimate());
+  }
+}
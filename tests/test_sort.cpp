@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <databento/sort.hpp>
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+using databento::MboMsg;
+
+namespace {
+
+// Shuffled multi-channel records with duplicate timestamps so stability
+// and the secondary key both matter
+std::vector<MboMsg> unsorted_records(size_t n) {
+  std::mt19937_64 rng(1234);
+  std::vector<MboMsg> records(n);
+  for (size_t i = 0; i < n; ++i) {
+    MboMsg& msg = records[i];
+    msg = test_helpers::make_mbo(static_cast<int>(i));
+    msg.ts_event = 1'700'000'000'000'000'000ULL + (rng() % (n / 4 + 1)) * 1000;
+    msg.sequence = static_cast<uint32_t>(rng() % 1000);
+    msg.instrument_id = static_cast<uint32_t>(rng() % 50);
+    msg.order_id = i;  // Original position, to check stability
+  }
+  return records;
+}
+
+std::vector<MboMsg> reference_sort(std::vector<MboMsg> records, databento::SortKey key) {
+  std::stable_sort(records.begin(), records.end(), [key](const MboMsg& a, const MboMsg& b) {
+    if (key == databento::SortKey::TimeSequence) {
+      return a.ts_event != b.ts_event ? a.ts_event < b.ts_event : a.sequence < b.sequence;
+    }
+    return a.instrument_id != b.instrument_id ? a.instrument_id < b.instrument_id
+                                              : a.ts_event < b.ts_event;
+  });
+  return records;
+}
+
+std::vector<uint64_t> order_ids(const std::vector<MboMsg>& records) {
+  std::vector<uint64_t> ids;
+  for (const auto& r : records) {
+    ids.push_back(r.order_id);
+  }
+  return ids;
+}
+
+std::vector<uint64_t> file_order_ids(const std::string& path) {
+  databento::DbnParser parser(path);
+  std::vector<uint64_t> ids;
+  parser.parse_mbo([&](const MboMsg& msg) { ids.push_back(msg.order_id); });
+  return ids;
+}
+
+} // namespace
+
+class SortKeyTest : public ::testing::TestWithParam<databento::SortKey> {};
+
+TEST_P(SortKeyTest, IndicesMatchStableSort) {
+  const auto records = unsorted_records(100000);
+  test_helpers::TempDbnFile file(records);
+  databento::DbnParser parser(file.path());
+
+  databento::SortOptions options;
+  options.key = GetParam();
+  options.threads = 4;
+  const auto order = databento::sort_record_indices(parser, options);
+
+  const auto expected = reference_sort(records, GetParam());
+  ASSERT_EQ(order.size(), expected.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    ASSERT_EQ(order[i], expected[i].order_id) << "position " << i;
+  }
+}
+
+TEST_P(SortKeyTest, InPlaceMatchesStableSort) {
+  auto records = unsorted_records(70000);
+  const auto expected = reference_sort(records, GetParam());
+
+  databento::SortOptions options;
+  options.key = GetParam();
+  options.threads = 3;
+  databento::sort_records_in_place(reinterpret_cast<uint8_t*>(records.data()),
+                                   records.size(), options);
+  EXPECT_EQ(order_ids(records), order_ids(expected));
+}
+
+TEST_P(SortKeyTest, OutOfCoreMatchesInMemory) {
+  const auto records = unsorted_records(5000);
+  test_helpers::TempDbnFile input(records);
+  const std::string in_memory = test_helpers::unique_temp_path();
+  const std::string spilled = test_helpers::unique_temp_path();
+
+  databento::SortOptions options;
+  options.key = GetParam();
+  databento::sort_file(input.path(), in_memory, options);
+
+  options.memory_budget = 48 * 1000;  // Forces 10 runs of 500 records
+  databento::sort_file(input.path(), spilled, options);
+
+  const auto expected = order_ids(reference_sort(records, GetParam()));
+  EXPECT_EQ(file_order_ids(in_memory), expected);
+  EXPECT_EQ(file_order_ids(spilled), expected);
+
+  databento::DbnParser parser(spilled);
+  parser.load_into_memory();
+  EXPECT_EQ(parser.num_records(), records.size());
+  EXPECT_EQ(parser.data()[0], 1);  // Metadata block preserved
+
+  std::remove(in_memory.c_str());
+  std::remove(spilled.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Keys, SortKeyTest,
+                         ::testing::Values(databento::SortKey::TimeSequence,
+                                           databento::SortKey::InstrumentTime));
+
+TEST(SortTest, EmptyAndSingleRecord) {
+  test_helpers::TempDbnFile empty;
+  databento::DbnParser parser(empty.path());
+  EXPECT_TRUE(databento::sort_record_indices(parser).empty());
+
+  MboMsg one = test_helpers::make_mbo(0);
+  databento::sort_records_in_place(reinterpret_cast<uint8_t*>(&one), 1);
+  EXPECT_EQ(one.sequence, 0);
+}
+
+TEST(SortTest, ConcurrentSpillsShareTempDir) {
+  const auto records = unsorted_records(3000);
+  test_helpers::TempDbnFile input(records);
+  const std::string outputs[2] = {test_helpers::unique_temp_path(),
+                                  test_helpers::unique_temp_path()};
+
+  databento::SortOptions options;
+  options.memory_budget = 48 * 500;  // 12 runs each, all in /tmp
+  std::thread other([&] { databento::sort_file(input.path(), outputs[0], options); });
+  databento::sort_file(input.path(), outputs[1], options);
+  other.join();
+
+  const auto expected = order_ids(reference_sort(records, options.key));
+  for (const auto& path : outputs) {
+    EXPECT_EQ(file_order_ids(path), expected);
+    std::remove(path.c_str());
+  }
+}
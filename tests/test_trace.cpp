@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <databento/parser.hpp>
+#include <databento/trace.hpp>
+#include "test_helpers.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+size_t count_occurrences(const std::string& text, const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+// Tracing state is process-wide; each test starts clean and disabled
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    databento::trace_disable();
+    databento::trace_clear();
+  }
+  void TearDown() override {
+    databento::trace_disable();
+    databento::trace_clear();
+  }
+};
+
+} // namespace
+
+TEST_F(TraceTest, DisabledRecordsNothing) {
+  { databento::TraceSpan span("idle"); }
+  EXPECT_EQ(databento::trace_event_count(), 0u);
+  EXPECT_EQ(count_occurrences(databento::trace_chrome_json(), "\"ph\":\"X\""), 0u);
+}
+
+TEST_F(TraceTest, SpansFromSeveralThreads) {
+  databento::trace_enable();
+  databento::trace_set_thread_name("main \"driver\"");
+  { databento::TraceSpan span("outer", "test"); }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 3; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 100; ++i) {
+        databento::TraceSpan span("worker_step", "test");
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(databento::trace_event_count(), 301u);
+  const std::string json = databento::trace_chrome_json();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"worker_step\""), 300u);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\""), 1u);
+  EXPECT_NE(json.find("\"args\":{\"name\":\"main \\\"driver\\\"\"}"), std::string::npos);
+}
+
+TEST_F(TraceTest, ExitedThreadBuffersAreReused) {
+  databento::trace_enable();
+  auto run_worker = [] {
+    std::thread([] { databento::TraceSpan span("short_lived"); }).join();
+  };
+  run_worker();
+  const std::string before = databento::trace_chrome_json();
+  for (int i = 0; i < 20; ++i) {
+    run_worker();
+  }
+  const std::string after = databento::trace_chrome_json();
+  EXPECT_EQ(count_occurrences(after, "\"ph\":\"M\""), count_occurrences(before, "\"ph\":\"M\""));
+  EXPECT_EQ(count_occurrences(after, "\"name\":\"short_lived\""), 21u);
+}
+
+TEST_F(TraceTest, OverflowIsCountedNotFatal) {
+  databento::trace_enable(4);
+  std::thread([] {
+    for (int i = 0; i < 10; ++i) {
+      databento::TraceSpan span("burst");
+    }
+  }).join();
+  EXPECT_GE(databento::trace_dropped_events(), 6u);
+  EXPECT_THROW(databento::trace_enable(0), std::invalid_argument);
+}
+
+TEST_F(TraceTest, PipelineStagesExportToFile) {
+  test_helpers::TempDbnFile file(test_helpers::make_mbo_records(5000));
+  databento::trace_enable();
+
+  databento::DbnParser parser(file.path());
+  parser.parse_mbo([](const databento::MboMsg&) {});
+  databento::BatchProcessor processor(1000);
+  processor.process_batches<databento::MboMsg>(
+      parser, [](const std::vector<databento::MboMsg>&) {});
+
+  const std::string path = "/tmp/test_trace.json";
+  databento::trace_write_chrome_json(path);
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  const std::string json = contents.str();
+  std::remove(path.c_str());
+
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"load\",\"cat\":\"loader\""), 1u);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"parse_mbo\",\"cat\":\"parser\""), 1u);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"decode_batch\",\"cat\":\"batch\""), 5u);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"batch_callback\",\"cat\":\"user\""), 5u);
+  EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+}